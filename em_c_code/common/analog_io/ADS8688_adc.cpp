@@ -108,7 +108,7 @@ bool init_ADS8688_adc(const analog_in_spi_t analog_in_spi_settings) {
         send_ADS8688_command(0xA000);
 
         //enable the cla task
-        enable_cla_task(4, reinterpret_cast<uint16_t>(&cla_task4_read_ADS8688_adc_voltages), CLA_TRIG_TINT0);
+        enable_cla_task(4, &cla_task4_read_ADS8688_adc_voltages, CLA_TRIG_TINT0);
 
 
         //enable the post task for checking on the fatal error
@@ -202,7 +202,7 @@ void printf_analog_in_values(void) {
     float32 *const temp_voltages = create_array_of<float32>(cla_analog_in_count, "analog_voltages");
     if (temp_voltages != NULL) {
         get_analog_in_voltages_converted(temp_voltages);
-        delay_printf_json_objects(1, json_float32_array("analog_input_values", cla_analog_in_count, temp_voltages, true, 3));
+        delay_printf_json_class_objects(print_class_telemetry, print_coalesce_analog_in_values, 1, json_float32_array("analog_input_values", cla_analog_in_count, temp_voltages, true, 3));
 
         delete_array(temp_voltages);
     }
@@ -152,7 +152,7 @@ bool init_internal_adc(const analog_in_ti_t analog_in_settings) {
 #pragma diag_default 1463
 
     //enable the cla task
-    enable_cla_task(3, reinterpret_cast<uint16_t>(&cla_task3_process_analog_io), CLA_TRIG_ADCBINT1);
+    enable_cla_task(3, &cla_task3_process_analog_io, CLA_TRIG_ADCBINT1);
 
     cla_internal_adc_enabled = true;
     internal_adc_initialized = true;
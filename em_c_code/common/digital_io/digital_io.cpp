@@ -27,6 +27,10 @@ static uint16_t *input_states;
 static volatile uint32_t *digital_in_pin_mask;
 static volatile uint32_t **digital_in_pin_data_reg;
 static volatile uint16_t *digital_in_pin_shift;
+static volatile uint16_t digital_in_port_count = 0;
+static volatile uint32_t **digital_in_port_data_reg;   //each port is only read once per snapshot
+static uint32_t *digital_in_port_values;
+static volatile uint16_t *digital_in_port_index;
 
 //digital out variables
 static volatile uint16_t digital_out_count = 0;
@@ -49,6 +53,11 @@ bool init_digital_io(const digital_io_settings_t digital_io_settings) {
 
 
     //set up in
+    //the snapshot packs one bit per input into a uint32
+    if (digital_io_settings.digital_in_count > max_digital_in_count) {
+        delay_printf_json_error("too many digital inputs");
+        return false;
+    }
     digital_in_count = digital_io_settings.digital_in_count;
 
     //use heap array, since size is unknown
@@ -63,11 +72,31 @@ bool init_digital_io(const digital_io_settings_t digital_io_settings) {
     digital_in_pin_shift = create_array_of<uint16_t>(digital_in_count, "digital_in_pin_shift");
     if (digital_in_pin_shift == NULL) {return false;}
 
+    //there can't be more ports than inputs
+    digital_in_port_data_reg = create_array_of<volatile uint32_t *>(digital_in_count, "digital_in_port_data_reg");
+    if (digital_in_port_data_reg == NULL) {return false;}
+    digital_in_port_values = create_array_of<uint32_t>(digital_in_count, "digital_in_port_values");
+    if (digital_in_port_values == NULL) {return false;}
+    digital_in_port_index = create_array_of<uint16_t>(digital_in_count, "digital_in_port_index");
+    if (digital_in_port_index == NULL) {return false;}
+
+    digital_in_port_count = 0;
     for (uint16_t i=0; i<digital_in_count; i++) {
         digital_in_gpio[i] = digital_io_settings.digital_in_gpio[i];
         digital_in_pin_mask[i] = calculate_pin_mask(digital_in_gpio[i]);
         digital_in_pin_data_reg[i] = calculate_pin_data_reg(digital_in_gpio[i]);
         digital_in_pin_shift[i] = (static_cast<uint16_t>(digital_in_gpio[i]) % 32);
+
+        //find the port (or add it)
+        uint16_t port_i = 0;
+        while ((port_i < digital_in_port_count) && (digital_in_port_data_reg[port_i] != digital_in_pin_data_reg[i])) {
+            port_i++;
+        }
+        if (port_i == digital_in_port_count) {
+            digital_in_port_data_reg[port_i] = digital_in_pin_data_reg[i];
+            digital_in_port_count++;
+        }
+        digital_in_port_index[i] = port_i;
     }
 
     //set up out
@@ -124,6 +153,24 @@ uint16_t get_digital_in(uint16_t input_number) {
     }
 }
 
+//reads each port once, then packs the inputs (bit 0 is input 0)
+__attribute__((ramfunc))
+uint32_t get_digital_in_snapshot() {
+    if (!digital_io_initialized) {return 0;}
+
+    for (uint16_t port_i=0; port_i<digital_in_port_count; port_i++) {
+        digital_in_port_values[port_i] = digital_in_port_data_reg[port_i][GPYDAT];
+    }
+
+    uint32_t snapshot = 0;
+    for (uint16_t i=0; i<digital_in_count; i++) {
+        const uint32_t bit = (digital_in_port_values[digital_in_port_index[i]] >> digital_in_pin_shift[i]) & 0x1;
+        snapshot |= (bit << i);
+    }
+
+    return snapshot;
+}
+
 uint16_t get_digital_in_count() {
     return digital_in_count;
 }
@@ -135,9 +182,9 @@ __attribute__((ramfunc))
 void get_digital_in_states(uint16_t *const temp_input_states) {
     if (!digital_io_initialized) {return;}
 
+    const uint32_t snapshot = get_digital_in_snapshot();
     for (uint16_t i=0; i<digital_in_count; i++) {
-        const uint16_t value = gpio_read_pin(digital_in_pin_data_reg[i], digital_in_pin_shift[i]);
-        temp_input_states[i] = static_cast<uint16_t>(value > 0);
+        temp_input_states[i] = static_cast<uint16_t>((snapshot >> i) & 0x1);
     }
 }
 
@@ -146,7 +193,7 @@ void printf_digital_in_values() {
     if (!digital_io_initialized) {return;}
 
     get_digital_in_states(input_states);
-    delay_printf_json_objects(1, json_uint16_array("digital_input_states", digital_in_count, input_states, true));
+    delay_printf_json_class_objects(print_class_telemetry, print_coalesce_digital_in_values, 1, json_uint16_array("digital_input_states", digital_in_count, input_states, true));
 }
 
 __attribute__((ramfunc))
@@ -154,7 +201,7 @@ void printf_digital_out_values() {
     if (!digital_io_initialized) {return;}
 
     get_digital_out_states(output_states);
-    delay_printf_json_objects(1, json_uint16_array("digital_output_states", digital_out_count, output_states, true));
+    delay_printf_json_class_objects(print_class_telemetry, print_coalesce_digital_out_values, 1, json_uint16_array("digital_output_states", digital_out_count, output_states, true));
 }
 
 __attribute__((ramfunc))
@@ -20,6 +20,9 @@ typedef struct digital_io_settings_t {
     const uint16_t *digital_out_gpio;
 } digital_io_settings_t;
 
+//the snapshot is a uint32 (one bit per input)
+static const uint16_t max_digital_in_count = 32;
+
 
 //init
 bool init_digital_io(const digital_io_settings_t digital_io_settings);
@@ -27,6 +30,7 @@ bool init_digital_io(const digital_io_settings_t digital_io_settings);
 //used by experimental_inputs_outputs (index 0)
 void set_digital_out(uint16_t output_number, uint16_t value);
 uint16_t get_digital_in(uint16_t input_number); //kept uint16 for io controller compatibility
+uint32_t get_digital_in_snapshot();                 //all inputs at once (bit 0 is input 0)
 
 //for status messages
 void printf_digital_in_values();
@@ -8,7 +8,7 @@
 #include "dsp_output.h"
 #include "printf_json_delayed.h"
 #include "tic_toc.h"
-#include "ring_buffer.h"
+#include "fixed_ring_buffer.h"
 #include "extract_json.h"
 #include "math.h"
 #include "misc.h"
@@ -27,8 +27,8 @@ serial_command_t command_set_queue = {"set_event_code_queue_notification", true,
 
 
 //internal variables
-static const uint16_t dsp_high_code_queue_length = 20;      //only need a few slots for high priority
-static const uint16_t dsp_low_code_queue_length =  500;     //keep more slots for low priority
+static const uint16_t dsp_high_code_queue_length = 32;      //only need a few slots for high priority (power of two)
+static const uint16_t dsp_low_code_queue_length =  512;     //keep more slots for low priority (power of two)
 static const uint16_t code_to_strobe_us_delay = 1; //delay between setting code and strobe (and vice-versa)
 static uint32_t dsp_output_cycles = 0;
 static uint32_t dsp_output_cycles_max = 0;
@@ -36,8 +36,8 @@ static uint32_t dsp_output_cycles_max = 0;
 //******** QUEUES *******
 //must be volatile, as they are accessed inside an interrupt
 static volatile bool dsp_initialized = false;
-static volatile ring_buffer dsp_high_code_queue;
-static volatile ring_buffer dsp_low_code_queue;
+static volatile fixed_ring_buffer<uint16_t, dsp_high_code_queue_length> dsp_high_code_queue;
+static volatile fixed_ring_buffer<uint16_t, dsp_low_code_queue_length> dsp_low_code_queue;
 static volatile uint16_t event_code_queue_notification_available_count = 0;
 
 //******** EVENT CODE PROCESSING ********
@@ -80,14 +80,9 @@ bool init_dsp_output(const dsp_settings_t dsp_settings) {
     dsp_bit_count = dsp_settings.dsp_bit_count;
     max_event_code_value = (static_cast<uint16_t>(1) << dsp_bit_count) - 1; //2^bits minus 1
 
-    //init the ring buffers
-    if (!dsp_high_code_queue.init_alloc(dsp_high_code_queue_length)) {
-        return false;
-    }
-    if (!dsp_low_code_queue.init_alloc(dsp_low_code_queue_length)) {
-        return false;
-    }
-
+    //make sure the queues start empty
+    dsp_high_code_queue.reset();
+    dsp_low_code_queue.reset();
 
     //set all dsp pins to direction out, and CPU controlled
     for (uint16_t i=0; i<dsp_settings.dsp_bit_count; i++) {
@@ -286,7 +281,7 @@ void send_event_codes_with_json(const json_t *const json_root) {
 
         } else { //if (string_e.count_found() > 0) {
             //convert the string into codes
-            const uint16_t *chars = reinterpret_cast<const uint16_t *>(packet_e.value().string_);
+            const unsigned char *chars = reinterpret_cast<const unsigned char *>(packet_e.value().string_);
 
             //packet must begin with "pack"
             if (!((chars[2] == 'p') && (chars[3] == 'a') && (chars[4] == 'c') && (chars[5] == 'k'))) {
@@ -14,17 +14,34 @@
 #include "tic_toc.h"
 #include "misc.h"
 #include "io_controller.h"
+#include "status_messages.h"
 #include "serial_link.h"
 #include "scia.h"
 #include "math.h"
 #include "arrays.h"
 
 
-//internal functions
-void start_experimental_monitor_main_loop();
+//main loop state
+static uint64_t one_sec_count = 1;
+static uint64_t on_duration_count = 0;
+static uint64_t next_on_count = 1;
+static uint64_t next_off_count = 1;
 
-//main function, called first
+
+//main function, called first (the host build boots and steps the same functions itself)
+#ifndef _HOST_SIM
 void main() {
+    startup_experimental_monitor();
+
+    //and run the time-insensitive main loop
+    start_experimental_monitor_main_loop();
+    while (true) {
+        run_experimental_monitor_main_loop_once();
+    }
+}
+#endif
+
+void startup_experimental_monitor() {
     // startup the ti launchpad **** MUST BE FIRST, TO COPY ramfunc ****
     if (!ti_board.startup()) {
         lockup_cpu(); //if ti_board did not start up
@@ -43,12 +60,18 @@ void main() {
     //set the json timestamp
     set_json_timestamp_freq(ti_board.main_frequency);
 
+    //message templates are optional, so just continue without them
+    init_status_messages();
+
     //finally, initialize the io_controller (should check db is ready and get clock)
     init_io_controller();
 
     //print ready, and wait for buffer to empty
     init_serial_link(); //serial link can be initialized
 
+    //every module has added its commands by now
+    freeze_serial_commands();
+
     //print everything delayed first
     printf_delayed_json_objects(true);
 
@@ -60,62 +83,59 @@ void main() {
     twiddle_leds_ten_times();
 
     printf_delayed_json_objects(true);
-
-    //and run the time-insensitive main loop
-    start_experimental_monitor_main_loop();
 }
 
 
-//normal loop, can have anything
-__attribute__((ramfunc))
+//status led counts, then start the io controller timer
 void start_experimental_monitor_main_loop() {
+    one_sec_count = static_cast<uint64_t>(llroundl(cpu_timer0.freq_hz()));
+    on_duration_count = (25*one_sec_count)/1000;
+    next_on_count = one_sec_count;
+    next_off_count = next_on_count + on_duration_count;
 
-    //status led counts
-    const uint64_t one_sec_count = static_cast<uint64_t>(llroundl(cpu_timer0.freq_hz()));
-    const uint64_t on_duration_count = (25*one_sec_count)/1000;
-    uint64_t next_on_count = one_sec_count;
-    uint64_t next_off_count = next_on_count + on_duration_count;
-
-    //start the io controller timer
     start_io_controller();
+}
 
-    //main loop, which will be interrupted
-    while (true) {
+//normal loop, can have anything (called forever, and will be interrupted)
+__attribute__((ramfunc))
+void run_experimental_monitor_main_loop_once() {
 
-        debug_timestamps.main_b_scia = CPU_TIMESTAMP;
+    debug_timestamps.main_b_scia = CPU_TIMESTAMP;
 
-        process_scia_buffer_for_commands();
+    process_scia_buffer_for_commands();
 
-        debug_timestamps.main_b_printf_delayed = CPU_TIMESTAMP;
+    debug_timestamps.main_b_printf_delayed = CPU_TIMESTAMP;
 
-        //just print one through each loop
-        printf_delayed_json_objects(false);
+    //just print one through each loop
+    printf_delayed_json_objects(false);
 
-        debug_timestamps.main_a_printf_delayed = CPU_TIMESTAMP;
+    //queue any streamed input samples
+    process_input_stream();
 
+    debug_timestamps.main_a_printf_delayed = CPU_TIMESTAMP;
 
-        //status led code off
-        const uint64_t current_count = cpu_timer0.count();
-        if (ti_board.red_led.is_on() && (current_count >= next_off_count)) {
-            //only blink status led if not twiddling
-            if (!is_currently_twiddling_leds()) {
-                ti_board.red_led.off();
-            }
-        }
 
-        //once-per-sec routines
-        if ((!ti_board.red_led.is_on()) && (current_count >= next_on_count)) {
-            const uint64_t current_sec_count = static_cast<uint64_t>(current_count / one_sec_count) * one_sec_count;
-            next_on_count = current_sec_count + one_sec_count;
-            next_off_count = current_sec_count + on_duration_count;
+    //status led code off
+    const uint64_t current_count = cpu_timer0.count();
+    if (ti_board.red_led.is_on() && (current_count >= next_off_count)) {
+        //only blink status led if not twiddling
+        if (!is_currently_twiddling_leds()) {
+            ti_board.red_led.off();
+        }
+    }
 
-            //only blink status led if not twiddling
-            if (!is_currently_twiddling_leds()) {
-                ti_board.red_led.on();
-            }
+    //once-per-sec routines
+    if ((!ti_board.red_led.is_on()) && (current_count >= next_on_count)) {
+        const uint64_t current_sec_count = static_cast<uint64_t>(current_count / one_sec_count) * one_sec_count;
+        next_on_count = current_sec_count + one_sec_count;
+        next_off_count = current_sec_count + on_duration_count;
 
-            //other updates to happen once per sec
-            check_if_waiting_for_input();
+        //only blink status led if not twiddling
+        if (!is_currently_twiddling_leds()) {
+            ti_board.red_led.on();
         }
+
+        //other updates to happen once per sec
+        check_if_waiting_for_input();
     }
 }
@@ -8,5 +8,9 @@
 #ifndef main_defined
 #define main_defined
 
+//boot everything, then start the main loop, which is run forever
+void startup_experimental_monitor();
+void start_experimental_monitor_main_loop();
+void run_experimental_monitor_main_loop_once();
 
 #endif
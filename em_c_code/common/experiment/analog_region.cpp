@@ -0,0 +1,110 @@
+/*
+ * analog_region.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "analog_region.h"
+
+
+uint32_t region_distance_squared(uint16_t distance) {
+    return (static_cast<uint32_t>(distance) * static_cast<uint32_t>(distance));
+}
+
+uint64_t region_ellipse_coefficient(uint32_t distance_squared) {
+    if (distance_squared == 0) {
+        return 0;
+    }
+    return (region_ellipse_one / distance_squared);
+}
+
+__attribute__((ramfunc))
+uint32_t region_offset_squared(uint16_t value, uint16_t target) {
+    const uint32_t offset = (value > target) ? (value - target) : (target - value);
+    return (offset * offset);
+}
+
+__attribute__((ramfunc))
+bool region_add_circular_term(uint64_t &sum, uint32_t offset_squared, uint32_t distance_squared) {
+    //no distance is never inside (same as before, when it was a divide by 0)
+    if (distance_squared == 0) {
+        return false;
+    }
+
+    sum += offset_squared;
+    return (sum <= distance_squared);
+}
+
+void region_ellipse_sum_clear(region_ellipse_sum_t &sum) {
+    sum.floored = 0;
+    sum.slack = 0;
+    sum.count = 0;
+}
+
+__attribute__((ramfunc))
+bool region_add_elliptical_term(region_ellipse_sum_t &sum, uint32_t offset_squared, uint32_t distance_squared, uint64_t coefficient) {
+    //a term above 1 is already outside (and keeps the product <= 2^62)
+    if ((distance_squared == 0) || (offset_squared > distance_squared) || (sum.count >= region_max_terms)) {
+        return false;
+    }
+
+    sum.offsets_squared[sum.count] = offset_squared;
+    sum.distances_squared[sum.count] = distance_squared;
+    sum.count++;
+
+    //the floored sum is never above the exact one, so once it is past 1 the point is outside
+    sum.floored += (offset_squared * coefficient);
+    sum.slack += offset_squared;
+    return (sum.floored <= region_ellipse_one);
+}
+
+//exact test of sum(offset^2 / distance^2) <= 1, 32 bits at a time
+//each round scales what is left of every fraction by 2^32, and takes the whole parts out of the budget
+//1 - sum is a multiple of 1/lcm(distance^2), which is at least 2^(-32 * count),
+//so it is always decided within count + 1 rounds, unless the point is exactly on the edge
+__attribute__((ramfunc))
+static bool is_ellipse_sum_at_most_one(const region_ellipse_sum_t &sum) {
+    uint32_t remainders[region_max_terms];
+    for (uint16_t i=0; i<sum.count; i++) {
+        remainders[i] = sum.offsets_squared[i];
+    }
+
+    int64_t budget = 1;
+    for (uint16_t round_i=0; round_i<(sum.count + 2); round_i++) {
+        //the budget is always < count here, so it fits after the shift
+        budget <<= 32;
+
+        bool has_remainder = false;
+        for (uint16_t i=0; i<sum.count; i++) {
+            const uint64_t scaled = (static_cast<uint64_t>(remainders[i]) << 32);
+            budget -= static_cast<int64_t>(scaled / sum.distances_squared[i]);
+            remainders[i] = static_cast<uint32_t>(scaled % sum.distances_squared[i]);
+            has_remainder = (has_remainder || (remainders[i] != 0));
+        }
+
+        //each fraction left is below 1
+        if (budget < 0) {
+            return false;
+        }
+        if ((!has_remainder) || (budget >= sum.count)) {
+            return true;
+        }
+    }
+
+    //exactly on the edge
+    return true;
+}
+
+__attribute__((ramfunc))
+bool region_ellipse_sum_is_inside(const region_ellipse_sum_t &sum) {
+    if (sum.floored > region_ellipse_one) {
+        return false;
+    }
+
+    //nearly always decided here (only a point within count parts in 2^30 of the edge isn't)
+    if ((sum.floored + sum.slack) <= region_ellipse_one) {
+        return true;
+    }
+
+    return is_ellipse_sum_at_most_one(sum);
+}
@@ -0,0 +1,46 @@
+/*
+ * analog_region.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// integer region tests for circular and elliptical targets (no floats, so the results are exact on any host)
+// squared offsets and distances are at most 65535^2, so they always fit in a uint32
+// elliptical terms are weighted in Q62, so 1.0 is 2^62
+
+
+#ifndef analog_region_defined
+#define analog_region_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+static const uint64_t region_ellipse_one = (1ULL << 62);
+static const uint16_t region_max_terms = 16;    //one per input in the chain
+
+//an elliptical sum, kept with its terms (only needed when the floored sum is too close to 1 to tell)
+typedef struct region_ellipse_sum_t {
+    uint64_t floored;       //sum of the floored Q62 terms (never above the exact sum)
+    uint64_t slack;         //the exact sum is less than floored + slack (each term is low by less than offset^2)
+    uint16_t count;
+    uint32_t offsets_squared[region_max_terms];
+    uint32_t distances_squared[region_max_terms];
+} region_ellipse_sum_t;
+
+//only needed when the settings change
+uint32_t region_distance_squared(uint16_t distance);
+uint64_t region_ellipse_coefficient(uint32_t distance_squared);    //floor(2^62 / distance^2), 0 for no distance
+
+//per tic
+uint32_t region_offset_squared(uint16_t value, uint16_t target);
+
+//each adds one term to the sum, and returns false once the point is outside
+//circular: sum must stay <= the parent's distance^2 (exact)
+//elliptical: each term is <= 2^62, so the sum can't overflow before it is rejected
+//  once every term is added, region_ellipse_sum_is_inside gives the exact answer
+bool region_add_circular_term(uint64_t &sum, uint32_t offset_squared, uint32_t distance_squared);
+void region_ellipse_sum_clear(region_ellipse_sum_t &sum);
+bool region_add_elliptical_term(region_ellipse_sum_t &sum, uint32_t offset_squared, uint32_t distance_squared, uint64_t coefficient);
+bool region_ellipse_sum_is_inside(const region_ellipse_sum_t &sum);
+
+#endif
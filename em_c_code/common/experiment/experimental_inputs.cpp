@@ -7,6 +7,7 @@
 
 
 #include "experimental_inputs.h"
+#include "analog_region.h"
 #include "analog_input.h"
 #include "digital_io.h"
 #include "printf_json_types.h"
@@ -48,6 +49,14 @@ static const char *timeout_tics_string = "timeout_tics";
 static const char *threshold_enabled_string = "threshold_enabled";
 static const char *threshold_value_string =  "threshold_value";
 
+//errors shared by the settings and the regions
+static const char *event_code_range_error = "event code outside of range 128-255";
+static const char *output_cycles_zero_error = "'output_cycles' cannot be 0";
+
+//internal functions
+//inputs only send high priority event codes (above the ascii range)
+static inline bool is_high_priority_event_code(uint16_t event_code) {return ((event_code > 127) && (event_code < 256));}
+
 //printing settings
 static json_object_t print_reason_o = json_string("reason", "");
 static json_object_t print_timestamp_o = json_timestamp(0);
@@ -125,15 +134,35 @@ static json_element threshold_enabled_e(threshold_enabled_string, t_bool);
 static json_element threshold_value_e(threshold_value_string, t_uint16);
 
 
-void experimental_input::init(uint16_t number, uint16_t channel, bool is_digital, const volatile input_get_function get_function, const volatile experimental_input *const inputs_array, const volatile experimental_output *const outputs_array) volatile {
+void experimental_input::init(uint16_t number, uint16_t channel, bool is_digital, const volatile input_get_function get_function, const volatile experimental_input *const inputs_array, const volatile experimental_output *const outputs_array, input_hot_state_t *const hot_state) volatile {
     //default construction
-    clock_tic_ = 0;
+    hot_ = hot_state;
+    hot_->current_values[number] = 0;
+    hot_->target_met[number] = false;
+    hot_->in_timeout[number] = false;
+    hot_->conditionally_met_tics[number] = 0;
+    hot_->conditionally_left_tics[number] = 0;
+    hot_->timeout_start_tics[number] = 0;
+    hot_->is_dirty[number] = true;
+    hot_->wake_tics[number] = 0;
+    hot_->current_regions[number] = no_region;
+    hot_->candidate_regions[number] = no_region;
+    hot_->candidate_region_tics[number] = 0;
     is_enabled_ = false;
     is_digital_ = true;
 
     //target
     target_set_ = false;
+    target_.analog.type = less_than;
+    target_.analog.value = 0;
+    target_.analog.distance = 0;
+    target_.digital.polarity = false;
+    region_distance_squared_ = 0;
+    region_coefficient_ = 0;
+    regions_ = NULL;
+    region_count_ = 0;
     target_met_actions_enabled_ = true;
+    actions_enabled_setting_ = true;
     target_met_msg_on_all_transitions_ = false;
     disable_actions_after_target_met_ = false;
 
@@ -149,7 +178,6 @@ void experimental_input::init(uint16_t number, uint16_t channel, bool is_digital
     child_input_ = NULL;
 
     //timeout
-    is_in_timeout_ = false;
     timeout_length_tics_ = 0;
 
     //readout
@@ -160,17 +188,14 @@ void experimental_input::init(uint16_t number, uint16_t channel, bool is_digital
     event_codes_.off = 0;
 
     //target met/left
-    target_met_ = false;
     target_met_min_length_tics_ = 0;
     target_left_min_length_tics_ = 0;
     target_met_msg_to_computer_ = false;
-    target_conditionally_met_tic_ = 0;
-    target_conditionally_left_tic_ = 0;
-    timeout_start_tic_ = 0;
 
     //output
     output_ptr_ = NULL;
     output_enabled_ = true;
+    output_enabled_setting_ = true;
     disable_output_after_target_met_once_ = false;
     output_cycle_counts_ = 1;
     output_delay_tics_ = 0;
@@ -213,6 +238,9 @@ void experimental_input::init(uint16_t number, uint16_t channel, bool is_digital
         delay_printf_json_error("input name not ready for > 99");
     }
 
+    //the name is fixed from now on
+    this->create_message_templates();
+
     //check function once
     if (get_function_ == NULL) {
         //use regular json_error here
@@ -224,17 +252,26 @@ void experimental_input::init(uint16_t number, uint16_t channel, bool is_digital
 }
 
 void experimental_input::enable_child(bool enable, uint16_t number) volatile {
+    const char *const error_string = this->set_child(enable, number);
+    if (error_string != NULL) {
+        this->printf_error(error_string);
+    }
+}
+
+//returns the error (or NULL), so it can be printed once interrupts are enabled again
+const char *experimental_input::set_child(bool enable, uint16_t number) volatile {
     //if disabling, remove child
     if (!enable) {
 
         //if the child has a child
-        if (child_input_->child_input_ != NULL) {
+        if ((child_input_ != NULL) && (child_input_->child_input_ != NULL)) {
             volatile experimental_input *const child_ptr = child_input_;
             volatile experimental_input *const grandchild_ptr = child_input_->child_input_;
 
             //remove child from chain
             child_ptr->parent_input_ = NULL;
             child_ptr->child_input_ = NULL;
+            hot_->is_dirty[child_ptr->number_] = true;
 
             //splice in the grandchild
             child_input_ = grandchild_ptr;
@@ -246,59 +283,73 @@ void experimental_input::enable_child(bool enable, uint16_t number) volatile {
             if (child_input_ != NULL) {
                 //remove self as the child's parent
                 child_input_->parent_input_ = NULL;
+                hot_->is_dirty[child_input_->number_] = true;
             }
             //clear the child
             child_input_ = NULL;
         }
 
-        return;
+        return NULL;
     }
 
     //check conditions
     if (number_ == number) {
-        this->printf_error("child cannot be set by itself");
-        return;
+        return "child cannot be set by itself";
     }
     if (number >= get_io_input_count()) {
-        this->printf_error("child number is greater than number of inputs");
-        return;
-    }
-    if (parent_input_ != NULL) {
-        this->printf_error("current input is not a primary input");
-        return;
+        return "child number is greater than number of inputs";
     }
     if ((!inputs_array_[number].is_enabled_) || (!inputs_array_[number].target_set_)) {
-        this->printf_error("child input is not enabled or does not have a target");
-        return;
+        return "child input is not enabled or does not have a target";
     }
-    if ((inputs_array_[number].child_input_) != NULL) {
-        this->printf_error("child input already has its own child input");
-        return;
+    if (child_input_ == &(inputs_array_[number])) {
+        return NULL;
+    }
+    if (child_input_ != NULL) {
+        return "current input already has a child input (disable it first)";
+    }
+    //a chain is built one link at a time (in any order), so the child can bring its own children with it
+    if ((inputs_array_[number].parent_input_) != NULL) {
+        return "child input already has a parent input";
+    }
+    if (this->highest_primary() == &(inputs_array_[number])) {
+        return "child input is already above this input in the chain";
     }
     if (is_digital_ != inputs_array_[number].is_digital_) {
-        this->printf_error("child input does not have the same input type (digital/analog)");
-        return;
+        return "child input does not have the same input type (digital/analog)";
     }
 
     //if analog, check that types are the same
     if (!is_digital_) {
         if (target_.analog.type != inputs_array_[number].target_.analog.type) {
-            this->printf_error("child input does not have the same analog_type");
-            return;
+            return "child input does not have the same analog_type";
         }
     }
 
     //point to the child, and the child pointing back to the parent
     child_input_ = const_cast<volatile experimental_input *>(&(inputs_array_[number]));
     child_input_->parent_input_ = this;
+    hot_->is_dirty[this->highest_primary()->number_] = true;
+    return NULL;
 }
 
 __attribute__((ramfunc))
-void experimental_input::update_current_value(uint64_t experiment_tic) volatile {
+void experimental_input::update_current_value() volatile {
     if (!is_enabled_) {return;}
 
-    clock_tic_ = experiment_tic;
-    current_value_ = get_function_(channel_);
+    //digital values were all read at once (the get function is only used for analog)
+    uint16_t current_value;
+    if (is_digital_) {
+        current_value = static_cast<uint16_t>((hot_->digital_values >> channel_) & 0x1);
+    } else {
+        current_value = get_function_(channel_);
+    }
+
+    //only a change needs the target to be evaluated again (by the up-most parent)
+    if (current_value != hot_->current_values[number_]) {
+        hot_->current_values[number_] = current_value;
+        hot_->is_dirty[this->highest_primary()->number_] = true;
+    }
 
     if (history_enabled_) {
 
@@ -322,7 +373,7 @@ void experimental_input::update_current_value(uint64_t experiment_tic) volatile
             }
 
             //now, update the count
-            if (current_value_ < threshold_value_) {
+            if (current_value < threshold_value_) {
                 threshold_count_++;
 
                 //sanity check
@@ -332,19 +383,43 @@ void experimental_input::update_current_value(uint64_t experiment_tic) volatile
             }
         }
 
-        if (!history_ring_buffer_.write(current_value_)) {
+        if (!history_ring_buffer_.write(current_value)) {
             history_enabled_ = false;
             this->printf_error("could not write to history");
         }
     }
 }
 
+//same shapes as print_current_value and send_target_met_message (only the values are placeholders)
+void experimental_input::create_message_templates() volatile {
+    value_template_ = create_json_template(4, json_parent(const_cast<const char*>(name_), 3),
+                                              json_string("reason","get"),
+                                              json_timestamp(0),
+                                              json_uint16("value", 0));
+
+    target_met_template_ = create_json_template(5, json_parent(const_cast<const char*>(name_), 4),
+                                                   json_string("reason","external_event"),
+                                                   json_timestamp(0),
+                                                   json_bool("target_met", false),
+                                                   json_bool("output_queued", false));
+}
+
 __attribute__((ramfunc))
-void experimental_input::print_current_value() volatile const {
-    delay_printf_json_objects(4, json_parent(const_cast<const char*>(name_), 3),
-                              json_string("reason","get"),
-                              json_timestamp(clock_tic_),
-                              json_uint16("value", current_value_));
+void experimental_input::print_current_value(bool is_readout) volatile const {
+    //an unsent readout is replaced by the newer one
+    print_class_t print_class = print_class_event;
+    print_coalesce_t coalesce_key = print_coalesce_none;
+    if (is_readout) {
+        print_class = print_class_telemetry;
+        if (number_ < print_coalesce_readout_count) {
+            coalesce_key = static_cast<print_coalesce_t>(print_coalesce_input_readout + number_);
+        }
+    }
+
+    delay_printf_json_template(value_template_, print_class, coalesce_key, 4, json_parent(const_cast<const char*>(name_), 3),
+                               json_string("reason","get"),
+                               json_timestamp(hot_->clock_tic),
+                               json_uint16("value", hot_->current_values[number_]));
 }
 
 __attribute__((ramfunc))
@@ -352,7 +427,7 @@ void experimental_input::print_threshold_count() volatile const {
     if (threshold_enabled_) {
         delay_printf_json_objects(4, json_parent(const_cast<const char*>(name_), 3),
                                   json_string("reason","get"),
-                                  json_timestamp(clock_tic_),
+                                  json_timestamp(hot_->clock_tic),
                                   json_uint16("threshold_count", threshold_count_));
     } else {
         this->printf_error("threshold is not enabled");
@@ -366,10 +441,15 @@ void experimental_input::process_actions() volatile {
     if (!is_enabled_) {return;}
 
     //assumes that current value is already current
+    //the hot state isn't volatile, so it is only loaded once
+    input_hot_state_t &hot = *hot_;
+    const uint16_t i = number_;
+    const uint64_t clock_tic = hot.clock_tic;
 
     //if readout is enabled and the time is right (mod == 0), then print
-    if ((readout_every_x_tics_ > 0) && ((clock_tic_ % readout_every_x_tics_) == 0)) {
-        this->print_current_value();
+    const uint64_t readout_every_x_tics = readout_every_x_tics_;
+    if ((readout_every_x_tics > 0) && ((clock_tic % readout_every_x_tics) == 0)) {
+        this->print_current_value(true);
     }
 
     //non-primary input statuses will be set by the up-most parent
@@ -377,15 +457,29 @@ void experimental_input::process_actions() volatile {
         return;
     }
 
+    //nothing can change until a value changes, or a deadline is due
+    if ((!hot.is_dirty[i]) && ((hot.wake_tics[i] == 0) || (hot.wake_tics[i] > clock_tic))) {
+        return;
+    }
+    hot.is_dirty[i] = false;
+    hot.wake_tics[i] = 0;
+
+    //regions replace the target (and timeout)
+    if (region_count_ > 0) {
+        this->process_regions();
+        return;
+    }
+
     //if in timeout, see if it still is, or can leave
-    if (is_in_timeout_) {
+    if (hot.in_timeout[i]) {
         //if still in timeout, exit function
-        if ((timeout_start_tic_ + timeout_length_tics_) > clock_tic_) {
+        if ((hot.timeout_start_tics[i] + timeout_length_tics_) > clock_tic) {
+            hot.wake_tics[i] = hot.timeout_start_tics[i] + timeout_length_tics_;
             return;
         } else {
             //else, exit timeout
-            is_in_timeout_ = false;
-            timeout_start_tic_ = 0;
+            hot.in_timeout[i] = false;
+            hot.timeout_start_tics[i] = 0;
         }
     }
 
@@ -394,32 +488,33 @@ void experimental_input::process_actions() volatile {
 
     //for one, simple (for multiple, check all)
     const bool target_conditionally_met = this->does_value_meet_all_targets();
-    if (target_conditionally_met && (target_conditionally_met_tic_ == 0)) {
-        target_conditionally_met_tic_ = clock_tic_;
-    } else if ((!target_conditionally_met) && (target_conditionally_left_tic_ == 0)) {
-        target_conditionally_left_tic_ = clock_tic_;
+    if (target_conditionally_met && (hot.conditionally_met_tics[i] == 0)) {
+        hot.conditionally_met_tics[i] = clock_tic;
+    } else if ((!target_conditionally_met) && (hot.conditionally_left_tics[i] == 0)) {
+        hot.conditionally_left_tics[i] = clock_tic;
     }
 
     //reset conditional met/left
     if (target_conditionally_met) {
-        target_conditionally_left_tic_ = 0;
+        hot.conditionally_left_tics[i] = 0;
     } else {
-        target_conditionally_met_tic_ = 0;
+        hot.conditionally_met_tics[i] = 0;
     }
 
     //check how long it has been met
     bool target_actually_met_or_left = false;
+    const bool target_met = hot.target_met[i];
     //if the target is conditionally met, and was left
-    if (target_conditionally_met && (!target_met_)) {
-        const uint64_t tics_since_target_conditionally_met_or_left = clock_tic_ - target_conditionally_met_tic_;
+    if (target_conditionally_met && (!target_met)) {
+        const uint64_t tics_since_target_conditionally_met_or_left = clock_tic - hot.conditionally_met_tics[i];
         if (tics_since_target_conditionally_met_or_left >= target_met_min_length_tics_) {
             this->do_target_actions(target_conditionally_met);
             target_actually_met_or_left = true;
         }
 
     //else, if the target is conditionally left, and was met
-    } else if ((!target_conditionally_met) && target_met_){
-        const uint64_t tics_since_target_conditionally_met_or_left = clock_tic_ - target_conditionally_left_tic_;
+    } else if ((!target_conditionally_met) && target_met){
+        const uint64_t tics_since_target_conditionally_met_or_left = clock_tic - hot.conditionally_left_tics[i];
         if (tics_since_target_conditionally_met_or_left >= target_left_min_length_tics_) {
             this->do_target_actions(target_conditionally_met);
             target_actually_met_or_left = true;
@@ -434,6 +529,15 @@ void experimental_input::process_actions() volatile {
             input_pointer->do_target_actions(target_conditionally_met);
         }
     }
+
+    //wake up again for whichever deadline is still pending
+    if (hot.in_timeout[i]) {
+        hot.wake_tics[i] = hot.timeout_start_tics[i] + timeout_length_tics_;
+    } else if (target_conditionally_met && (!hot.target_met[i])) {
+        hot.wake_tics[i] = hot.conditionally_met_tics[i] + target_met_min_length_tics_;
+    } else if ((!target_conditionally_met) && hot.target_met[i]) {
+        hot.wake_tics[i] = hot.conditionally_left_tics[i] + target_left_min_length_tics_;
+    }
 }
 
 __attribute__((ramfunc))
@@ -441,25 +545,28 @@ void experimental_input::do_target_actions(bool target_met) volatile {
     //uint32_t start_time = get_cpu_timestamp();
     bool should_send_target_met_messages = false;
     bool output_was_queued = false;
+    input_hot_state_t &hot = *hot_;
+    const uint16_t i = number_;
+    const bool was_target_met = hot.target_met[i];
 
     //if actions are disabled, then just set and exit
     if (!target_met_actions_enabled_) {
-        target_met_ = target_met;
+        hot.target_met[i] = target_met;
         return;
     }
 
     //if tracking transitions, and there was a change, then send it
-    if (target_met_msg_on_all_transitions_ && (target_met != target_met_)) {
+    if (target_met_msg_on_all_transitions_ && (target_met != was_target_met)) {
         should_send_target_met_messages = true;
     }
 
     //if the target is met, and it wasn't before
-    if (target_met && (!target_met_)) {
+    if (target_met && (!was_target_met)) {
         should_send_target_met_messages = true;
 
         if (timeout_length_tics_ > 0) {
-            timeout_start_tic_ = clock_tic_;
-            is_in_timeout_ = true;
+            hot.timeout_start_tics[i] = hot.clock_tic;
+            hot.in_timeout[i] = true;
         }
 
         if (output_enabled_ && (output_ptr_ != NULL)) {
@@ -472,7 +579,7 @@ void experimental_input::do_target_actions(bool target_met) volatile {
             if (output_ptr_->is_continuous()) {
                 output_ptr_->enable(true);
             } else {
-                output_ptr_->add_cycles(output_cycle_counts_, clock_tic_ + output_delay_tics_);
+                output_ptr_->add_cycles(output_cycle_counts_, hot.clock_tic + output_delay_tics_);
             }
         }
     }
@@ -482,9 +589,9 @@ void experimental_input::do_target_actions(bool target_met) volatile {
     }
 
     //if the target isn't met, and it was before
-    if ((!target_met) && target_met_) {
+    if ((!target_met) && was_target_met) {
         //reset everything
-        target_conditionally_met_tic_ = 0;
+        hot.conditionally_met_tics[i] = 0;
         //if the output is enabled and continuous
         if (output_enabled_ && (output_ptr_ != NULL) && output_ptr_->is_continuous()) {
             output_ptr_->enable(false);
@@ -492,14 +599,15 @@ void experimental_input::do_target_actions(bool target_met) volatile {
     }
 
     //finally, update the value
-    target_met_ = target_met;
+    hot.target_met[i] = target_met;
 
     //disable the actions, if desired
-    if (disable_actions_after_target_met_ && target_met_ && target_met_actions_enabled_) {
+    if (disable_actions_after_target_met_ && target_met && target_met_actions_enabled_) {
         target_met_actions_enabled_ = false;
     }
 }
 
+__attribute__((ramfunc))
 const volatile experimental_input *experimental_input::highest_primary() volatile const {
     const volatile experimental_input *input_pointer = this;
 
@@ -512,31 +620,32 @@ const volatile experimental_input *experimental_input::highest_primary() volatil
 }
 
 __attribute__((ramfunc))
-bool experimental_input::does_value_meet_this_target() volatile const {
+bool experimental_input::does_value_meet_this_target(uint16_t current_value) volatile const {
     bool does_meet = false;
 
     if (is_digital_) {
-        does_meet = (current_value_ == target_.digital.polarity);
+        //already compared against the polarity, with the rest of the digital inputs
+        does_meet = ((hot_->digital_targets_met >> channel_) & 0x1);
     } else {
         switch(target_.analog.type) {
             case less_than:
-                does_meet = (current_value_ < target_.analog.value);
+                does_meet = (current_value < target_.analog.value);
                 break;
 
             case less_than_or_equal_to:
-                does_meet = (current_value_ <= target_.analog.value);
+                does_meet = (current_value <= target_.analog.value);
                 break;
 
             case greater_than:
-                does_meet = (current_value_ > target_.analog.value);
+                does_meet = (current_value > target_.analog.value);
                 break;
 
             case greater_than_or_equal_to:
-                does_meet = (current_value_ >= target_.analog.value);
+                does_meet = (current_value >= target_.analog.value);
                 break;
 
             case rectangular_distance:
-                does_meet = (labs(static_cast<int32_t>(current_value_) - static_cast<int32_t>(target_.analog.value)) <= static_cast<int32_t>(target_.analog.distance));
+                does_meet = (labs(static_cast<int32_t>(current_value) - static_cast<int32_t>(target_.analog.value)) <= static_cast<int32_t>(target_.analog.distance));
                 break;
         }
     }
@@ -555,59 +664,39 @@ bool experimental_input::does_value_meet_all_targets() volatile const {
     }
 
     const volatile experimental_input *input_pointer = this;
+    const uint16_t *const current_values = hot_->current_values;
 
     //it is analog, less_than_or_equal_to_distance, and has a child
     if ((!is_digital_) && (child_input_ != NULL) && ((target_.analog.type == circular_distance) || (target_.analog.type == elliptical_distance))) {
 
+        //the coefficients were calculated when the targets were set
         const bool is_elliptical = (target_.analog.type == elliptical_distance);
-        float32 sum_of_terms = 0;
-        float32 current_term = 0;
-        float32 current_divisor = static_cast<float32>(input_pointer->target_.analog.distance);
-
-        //if circular, then calculate current_divisor once
-        if (!is_elliptical) {
-            current_divisor *= current_divisor; //square current_divisor
-            current_divisor = 1.0 / current_divisor; //invert to make it multiplication
-        }
+        const uint32_t circle_distance_squared = region_distance_squared_;  //circular only uses the parent's distance
+        uint64_t sum_of_terms = 0;
+        region_ellipse_sum_t ellipse_sum;
+        region_ellipse_sum_clear(ellipse_sum);
 
-        //calculate each term (from parent on down), and add to sum_of_terms
-        while (input_pointer->child_input_ != NULL) {
+        //add each term (from parent on down), and stop as soon as it is outside
+        while (input_pointer != NULL) {
+            const uint32_t offset_squared = region_offset_squared(current_values[input_pointer->number_], input_pointer->target_.analog.value);
 
-            //if elliptical, then calculate current_divisor each time
+            bool is_inside;
             if (is_elliptical) {
-                current_divisor = static_cast<float32>(input_pointer->target_.analog.distance);
-                current_divisor *= current_divisor; //square current_divisor
-                current_divisor = 1.0 / current_divisor; //invert to make it multiplication
+                is_inside = region_add_elliptical_term(ellipse_sum, offset_squared, input_pointer->region_distance_squared_, input_pointer->region_coefficient_);
+            } else {
+                is_inside = region_add_circular_term(sum_of_terms, offset_squared, circle_distance_squared);
             }
 
-            //get the current term
-            current_term = static_cast<float32>(input_pointer->current_value_) - static_cast<float32>(input_pointer->target_.analog.value);
-            current_term *= current_term;   //square self
-            current_term *= current_divisor;  //"divide" by current_divisor
-
-            //add to sum
-            sum_of_terms += current_term;
+            if (!is_inside) {
+                return false;
+            }
 
             //get the child pointer
             input_pointer = input_pointer->child_input_;
         }
 
-        if (is_elliptical) {
-            current_divisor = static_cast<float32>(input_pointer->target_.analog.distance);
-            current_divisor *= current_divisor; //square child_divisor
-            current_divisor = 1.0 / current_divisor; //invert to make it multiplication
-        }
-
-        //now, calculate final one
-        current_term = static_cast<float32>(input_pointer->current_value_) - static_cast<float32>(input_pointer->target_.analog.value);
-        current_term *= current_term;   //square self
-        current_term *= current_divisor; //"divide" by current_divisor
-
-        //add to sum
-        sum_of_terms += current_term;
-
-        //and make sure inside the N-D circle or ellipse
-        return (sum_of_terms <= 1.0);
+        //inside the N-D circle, or (exactly) inside the N-D ellipse
+        return ((!is_elliptical) || region_ellipse_sum_is_inside(ellipse_sum));
 
     } else {
 
@@ -616,7 +705,7 @@ bool experimental_input::does_value_meet_all_targets() volatile const {
         //now, go down - checking each value against its target
         while (input_pointer->child_input_ != NULL) {
             //if any are bad, the exit false
-            if (!input_pointer->does_value_meet_this_target()) {
+            if (!input_pointer->does_value_meet_this_target(current_values[input_pointer->number_])) {
                 return false;
             }
 
@@ -625,7 +714,7 @@ bool experimental_input::does_value_meet_all_targets() volatile const {
         }
 
         //now, check the final one
-        return (input_pointer->does_value_meet_this_target());
+        return (input_pointer->does_value_meet_this_target(current_values[input_pointer->number_]));
     }
 }
 
@@ -633,25 +722,25 @@ __attribute__((ramfunc))
 void experimental_input::printf_error(const char *const message) volatile const {
     delay_printf_json_objects(3, json_string("error", message),
                               json_uint16("input", number_),
-                              json_timestamp(clock_tic_));
+                              json_timestamp(hot_->clock_tic));
 }
 
 __attribute__((ramfunc))
 void experimental_input::printf_status(const char *const message) volatile const {
     delay_printf_json_objects(3, json_string("status", message),
                               json_uint16("input", number_),
-                              json_timestamp(clock_tic_));
+                              json_timestamp(hot_->clock_tic));
 }
 
 __attribute__((ramfunc))
 void experimental_input::send_target_met_message(bool target_met, bool output_queued) volatile const {
 
     if (target_met_msg_to_computer_) {
-        delay_printf_json_objects(5, json_parent(const_cast<const char*>(name_), 4),
-                                  json_string("reason","external_event"),
-                                  json_timestamp(clock_tic_),
-                                  json_bool("target_met", target_met),
-                                  json_bool("output_queued", output_queued));
+        delay_printf_json_template(target_met_template_, print_class_event, print_coalesce_none, 5, json_parent(const_cast<const char*>(name_), 4),
+                                   json_string("reason","external_event"),
+                                   json_timestamp(hot_->clock_tic),
+                                   json_bool("target_met", target_met),
+                                   json_bool("output_queued", output_queued));
     }
 
     if (target_met) {
@@ -703,18 +792,25 @@ void experimental_input::enable_history_copy(bool enable) volatile {
 }
 
 void experimental_input::enable_threshold(bool enable, uint16_t threshold_value) volatile {
+    const char *const error_string = this->set_threshold(enable, threshold_value);
+    if (error_string != NULL) {
+        this->printf_error(error_string);
+    }
+}
+
+//returns the error (or NULL), so it can be printed once interrupts are enabled again
+const char *experimental_input::set_threshold(bool enable, uint16_t threshold_value) volatile {
 
     //if disabling, just disable and exit
     if (!enable) {
         threshold_enabled_ = false;
         threshold_value_ = 0;
         threshold_count_ = 0;
-        return;
+        return NULL;
     }
 
     if (!history_enabled_) {
-        this->printf_error("history must be enabled to enable threshold");
-        return;
+        return "history must be enabled to enable threshold";
     }
 
     //set values and reset count
@@ -722,6 +818,7 @@ void experimental_input::enable_threshold(bool enable, uint16_t threshold_value)
     threshold_count_ = 0;
     threshold_enabled_ = true;
     history_ring_buffer_.reset();  //must force empty to get accurate counts
+    return NULL;
 }
 
 void experimental_input::enable_history(bool enable, uint16_t history_length) volatile {
@@ -782,7 +879,7 @@ uint16_t experimental_input::history_length() volatile const {
 }
 
 __attribute__((ramfunc))
-bool experimental_input::get_copy_of_history(uint16_t count, json_object_t &json_object) volatile {
+bool experimental_input::get_copy_of_history(uint16_t count, json_object_t &json_object, bool is_delta_varint) volatile {
 
     //reset the object
     json_object = blank_json_object;
@@ -809,11 +906,14 @@ bool experimental_input::get_copy_of_history(uint16_t count, json_object_t &json
     //success, set the other properties
     json_object.parameter_name = "history";
     json_object.array_count = count;
-    json_object.combined_params.value_type = t_base64;
 
     if (is_digital_) {
+        json_object.combined_params.value_type = t_base64;
         json_object.combined_params.precision = 1;  //1bit
+    } else if (is_delta_varint) {
+        json_object.combined_params.value_type = t_delta_varint;   //analog changes slowly, so deltas are small
     } else {
+        json_object.combined_params.value_type = t_base64;
         json_object.combined_params.precision = 16; //16bits (analog)
     }
 
@@ -861,10 +961,10 @@ void experimental_input::print_settings(reason_t reason_code) volatile const {
 
     //update all settings
     print_reason_o.value.string_ = get_reason_name(reason_code);
-    print_timestamp_o.value.uint64_ = clock_tic_;
+    print_timestamp_o.value.uint64_ = hot_->clock_tic;
     print_enabled_o.value.bool_ = is_enabled_;
     print_digital_o.value.bool_ = is_digital_;
-    print_value_o.value.uint16_ = current_value_;
+    print_value_o.value.uint16_ = hot_->current_values[number_];
     print_hist_en_o.value.bool_ = history_enabled_;
     print_hist_len_o.value.uint16_ = this->history_length();
     print_all_tran_o.value.bool_ = target_met_msg_on_all_transitions_;
@@ -884,7 +984,7 @@ void experimental_input::print_settings(reason_t reason_code) volatile const {
     print_has_p_o.value.bool_ = (parent_input_ != NULL);
     print_has_c_o.value.bool_ = (child_input_ != NULL);
     print_tar_set_o.value.bool_ = target_set_;
-    print_tar_met_o.value.bool_ = target_met_;
+    print_tar_met_o.value.bool_ = hot_->target_met[number_];
     print_met_min_o.value.uint64_ = target_met_min_length_tics_;
     print_left_min_o.value.uint64_ = target_left_min_length_tics_;
     print_threshold_count_o.value.uint16_ = threshold_count_;
@@ -898,8 +998,7 @@ void experimental_input::print_settings(reason_t reason_code) volatile const {
 
     delayed_json_t delayed_json_object;
     delayed_json_object.object_count = child_count + 1;
-    //use heap array, since size is unknown
-    delayed_json_object.objects = create_array_of<json_object_t>(child_count + 1, "exp_in_printf_objects");
+    delayed_json_object.objects = create_delayed_json_objects(child_count + 1);
     if (delayed_json_object.objects == NULL) {
         return;
     }
@@ -1000,10 +1099,31 @@ void experimental_input::set_actions(const json_t *const json_root) volatile con
 }
 
 void experimental_input::set_settings(const json_t *const json_root) volatile {
+    input_settings_t settings;
+    if (!this->parse_settings(json_root, settings)) {
+        return;
+    }
+
+    //only after setting the elements (and allocating anything they need)
+    if (this->prepare_settings(settings)) {
+        //disable and store the interrupt state
+        const uint16_t interrupt_settings = __disable_interrupts();
+
+        this->apply_settings(settings);
+
+        //restore the interrupt state
+        __restore_interrupts(interrupt_settings);
+    }
+
+    this->finish_settings(settings);
+}
+
+//only reads the json (nothing is changed), so it can be done well before the settings are applied
+bool experimental_input::parse_settings(const json_t *const json_root, input_settings_t &settings, bool reject_any_error) volatile const {
     json_element number_e("input_number", t_uint16, true);
     if ((!number_e.set_with_json(json_root, true)) || (number_e.value().uint16_ != number_)) {
         this->printf_error("input_number is wrong");
-        return;
+        return false;
     }
 
 
@@ -1022,55 +1142,62 @@ void experimental_input::set_settings(const json_t *const json_root) volatile {
 
     //if none found, return
     if (found_count == 0) {
-        return;
+        return false;
     }
 
-    //only after setting the elements
-    //disable and store the interrupt state
-    const uint16_t interrupt_settings = __disable_interrupts();
-
-    debug_timestamps.exp_input_set_settings.tic();
+    //nothing is set unless found (and valid)
+    memset(&settings, 0, sizeof(input_settings_t));
+    settings.number = number_;
+    uint16_t error_count = 0;
 
     //history
     if (history_enabled_e.count_found() > 0) {
-        if (!history_enabled_e.value().bool_) {
-            this->enable_history(false, 0);
+        if (history_enabled_e.value().bool_ && (history_length_e.count_found() == 0)) {
+            this->printf_error("'history_length' is required to enable history");
+            error_count++;
+        } else if (history_enabled_e.value().bool_ && (history_length_e.value().uint16_ == 0)) {
+            this->printf_error("history_length must be > 0");
+            error_count++;
         } else {
-            if (history_length_e.count_found() > 0) {
-                this->enable_history(true, history_length_e.value().uint16_);
-            } else {
-                this->printf_error("'history_length' is required to enable history");
+            //give warning, but continue
+            if (history_length_e.value().uint16_ > 4096) {
+                this->printf_status("warning: input history lengths > 4096 incur a progressively worse penalty during copies");
             }
+
+            settings.has_history = true;
+            settings.history_enabled = history_enabled_e.value().bool_;
+            settings.history_length = history_length_e.value().uint16_;
         }
     }
 
     //readout
     if (enable_readout_e.count_found() > 0) {
-        if (!enable_readout_e.value().bool_) {
-            this->enable_readout(false, 0);
+        if (enable_readout_e.value().bool_ && (readout_length_e.count_found() == 0)) {
+            this->printf_error("'readout_tics' is required to enable readout");
+            error_count++;
         } else {
-            if (readout_length_e.count_found() > 0) {
-                this->enable_readout(true, readout_length_e.value().uint16_);
-            } else {
-                this->printf_error("'readout_tics' is required to enable readout");
-            }
+            settings.has_readout = true;
+            settings.readout_enabled = enable_readout_e.value().bool_;
+            settings.readout_every_x_tics = readout_length_e.value().uint16_;
         }
     }
 
     //target
     if (met_min_tics_e.count_found() > 0) {
-        target_met_min_length_tics_ = met_min_tics_e.value().uint64_;
+        settings.has_met_min_length = true;
+        settings.target_met_min_length_tics = met_min_tics_e.value().uint64_;
     }
 
     if (left_min_tics_e.count_found() > 0) {
-        target_left_min_length_tics_ = left_min_tics_e.value().uint64_;
+        settings.has_left_min_length = true;
+        settings.target_left_min_length_tics = left_min_tics_e.value().uint64_;
     }
 
     if (is_digital_) {
         //if digital
         if (digital_target_e.count_found() > 0) {
-            target_.digital.polarity = (digital_target_e.value().uint16_ != 0);
-            target_set_ = true;
+            settings.digital_target.polarity = (digital_target_e.value().uint16_ != 0);
+            settings.has_target = true;
         }
 
     } else {
@@ -1114,114 +1241,778 @@ void experimental_input::set_settings(const json_t *const json_root) volatile {
                 had_error = true;
             }
 
-            if (!had_error) {
-                target_.analog.type = temp_analog_type;
-                target_.analog.value = analog_value_e.value().uint16_;
+            if (had_error) {
+                error_count++;
+            } else {
+                settings.analog_target.type = temp_analog_type;
+                settings.analog_target.value = analog_value_e.value().uint16_;
                 if (analog_distance_e.count_found() > 0) {
-                    target_.analog.distance = analog_distance_e.value().uint16_;
+                    settings.analog_target.distance = analog_distance_e.value().uint16_;
                 } else {
-                    target_.analog.distance = 0;
+                    settings.analog_target.distance = 0;
                 }
-                target_set_ = true;
+                settings.has_target = true;
             }
         }
     }
 
-    if ((reset_target_e.count_found() > 0) && (reset_target_e.value().bool_)) {
-        target_met_ = false;
-        target_conditionally_met_tic_ = 0;
-    }
+    settings.reset_target = ((reset_target_e.count_found() > 0) && (reset_target_e.value().bool_));
 
     //actions
     if (actions_enable_e.count_found() > 0) {
-        target_met_actions_enabled_ = actions_enable_e.value().bool_;
+        settings.has_actions_enabled = true;
+        settings.actions_enabled = actions_enable_e.value().bool_;
     }
     if (disable_actions_after_e.count_found() > 0) {
-        disable_actions_after_target_met_ = disable_actions_after_e.value().bool_;
+        settings.has_disable_actions_after = true;
+        settings.disable_actions_after = disable_actions_after_e.value().bool_;
     }
 
     //messages
     if (all_transitions_e.count_found() > 0) {
-        target_met_msg_on_all_transitions_ = all_transitions_e.value().bool_;
+        settings.has_all_transitions = true;
+        settings.all_transitions = all_transitions_e.value().bool_;
     }
     if (send_to_computer_e.count_found() > 0) {
-        target_met_msg_to_computer_ = send_to_computer_e.value().bool_;
+        settings.has_send_to_computer = true;
+        settings.send_to_computer = send_to_computer_e.value().bool_;
     }
     if (event_code_met_e.count_found() > 0) {
-        if ((event_code_met_e.value().uint16_ > 127) && (event_code_met_e.value().uint16_ < 256)) {
-            event_codes_.on = event_code_met_e.value().uint16_;
+        if (is_high_priority_event_code(event_code_met_e.value().uint16_)) {
+            settings.has_event_code_on = true;
+            settings.event_codes.on = event_code_met_e.value().uint16_;
         } else {
-            this->printf_error("event code outside of range 128-255");
+            this->printf_error(event_code_range_error);
+            error_count++;
         }
     }
     if (event_code_left_e.count_found() > 0) {
-        if ((event_code_left_e.value().uint16_ > 127) && (event_code_left_e.value().uint16_ < 256)) {
-            event_codes_.off = event_code_left_e.value().uint16_;
+        if (is_high_priority_event_code(event_code_left_e.value().uint16_)) {
+            settings.has_event_code_off = true;
+            settings.event_codes.off = event_code_left_e.value().uint16_;
         } else {
-            this->printf_error("event code outside of range 128-255");
+            this->printf_error(event_code_range_error);
+            error_count++;
         }
     }
 
-    //child
+    //child (checked against the other inputs once applied)
     if ((enable_child_e.count_found() > 0) && (child_number_e.count_found() > 0)) {
-        this->enable_child(enable_child_e.value().bool_, child_number_e.value().uint16_);
+        settings.has_child = true;
+        settings.child_enabled = enable_child_e.value().bool_;
+        settings.child_number = child_number_e.value().uint16_;
     }
     if (enable_output_e.count_found() > 0) {
-        output_enabled_ = enable_output_e.value().bool_;
+        settings.has_output_enabled = true;
+        settings.output_enabled = enable_output_e.value().bool_;
     }
     if (output_number_e.count_found() > 0) {
-        if (output_number_e.value().uint16_ >= get_io_output_count()) {
+        settings.has_output_number = true;
+        settings.output_number = output_number_e.value().uint16_;
+        if (settings.output_number >= get_io_output_count()) {
             this->printf_error("'output_number' is too high");
-            output_ptr_ = NULL;
-            return;
-        } else {
-            output_ptr_ = const_cast<volatile experimental_output *>(&(outputs_array_[output_number_e.value().uint16_]));
+            error_count++;
         }
     }
     if (output_disable_after_e.count_found() > 0) {
-        disable_output_after_target_met_once_ = output_disable_after_e.value().bool_;
+        settings.has_output_disable_after = true;
+        settings.output_disable_after = output_disable_after_e.value().bool_;
     }
     if (output_cycles_e.count_found() > 0) {
         if (output_cycles_e.value().uint16_ > 0) {
-            output_cycle_counts_ = output_cycles_e.value().uint16_;
+            settings.has_output_cycles = true;
+            settings.output_cycles = output_cycles_e.value().uint16_;
         } else {
-            this->printf_error("'output_cycles' cannot be 0");
+            this->printf_error(output_cycles_zero_error);
+            error_count++;
         }
 
     }
     if (output_delay_tics_e.count_found() > 0) {
-        output_delay_tics_ = output_delay_tics_e.value().uint64_;
+        settings.has_output_delay = true;
+        settings.output_delay_tics = output_delay_tics_e.value().uint64_;
     }
 
     //timeout
     if (timeout_e.count_found() > 0) {
-        //this->set_timeout(timeout_e.value().uint64_);
-        timeout_length_tics_ = timeout_e.value().uint64_;
-        is_in_timeout_ = false;
+        settings.has_timeout = true;
+        settings.timeout_length_tics = timeout_e.value().uint64_;
     }
 
     //threshold
     if (threshold_enabled_e.count_found() > 0) {
-        if (!threshold_enabled_e.value().bool_) {
-            this->enable_threshold(false);
+        if (threshold_enabled_e.value().bool_ && (threshold_value_e.count_found() == 0)) {
+            this->printf_error("'threshold_value' is required to enable threshold");
+            error_count++;
         } else {
-            if (threshold_value_e.count_found() > 0) {
-                this->enable_threshold(true, threshold_value_e.value().uint16_);
+            settings.has_threshold = true;
+            settings.threshold_enabled = threshold_enabled_e.value().bool_;
+            settings.threshold_value = threshold_value_e.value().uint16_;
+        }
+    }
+
+    settings.print_settings = ((settings_e.count_found() > 0) && (settings_e.value().bool_));
+
+    //staged settings are all or nothing
+    return ((error_count == 0) || (!reject_any_error));
+}
+
+//allocates anything the settings need, so applying them never touches the heap
+//returns false if it couldn't (finish_settings still has to be called, to free what was allocated)
+bool experimental_input::prepare_settings(input_settings_t &settings) volatile const {
+    settings.new_history_buffer = NULL;
+    settings.old_history_buffer = NULL;
+    settings.old_history_copy = NULL;
+    settings.apply_error = NULL;
+
+    //a new buffer, unless this length is already enabled (checked again when applied)
+    if (settings.has_history && settings.history_enabled && ((!history_enabled_) || (history_length_ != settings.history_length))) {
+        settings.new_history_buffer = create_array_of<uint16_t>(settings.history_length, "ring_buffer buffer");
+        if (settings.new_history_buffer == NULL) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//just copies what was parsed, in the same order as always (interrupts must be disabled)
+void experimental_input::apply_settings(input_settings_t &settings) volatile {
+    debug_timestamps.exp_input_set_settings.tic();
+
+    //history
+    if (settings.has_history) {
+        this->swap_history(settings);
+    }
+
+    //readout
+    if (settings.has_readout) {
+        this->enable_readout(settings.readout_enabled, settings.readout_every_x_tics);
+    }
+
+    //target
+    if (settings.has_met_min_length) {
+        target_met_min_length_tics_ = settings.target_met_min_length_tics;
+    }
+
+    if (settings.has_left_min_length) {
+        target_left_min_length_tics_ = settings.target_left_min_length_tics;
+    }
+
+    if (settings.has_target) {
+        if (is_digital_) {
+            target_.digital.polarity = settings.digital_target.polarity;
+            if (settings.digital_target.polarity) {
+                hot_->digital_polarities |= (1UL << channel_);
             } else {
-                this->printf_error("'threshold_value' is required to enable threshold");
+                hot_->digital_polarities &= ~(1UL << channel_);
             }
+        } else {
+            target_.analog.type = settings.analog_target.type;
+            target_.analog.value = settings.analog_target.value;
+            target_.analog.distance = settings.analog_target.distance;
+            region_distance_squared_ = region_distance_squared(settings.analog_target.distance);
+            region_coefficient_ = region_ellipse_coefficient(region_distance_squared_);
         }
+        target_set_ = true;
+    }
+
+    if (settings.reset_target) {
+        hot_->target_met[number_] = false;
+        hot_->conditionally_met_tics[number_] = 0;
+    }
+
+    //actions
+    if (settings.has_actions_enabled) {
+        target_met_actions_enabled_ = settings.actions_enabled;
+        actions_enabled_setting_ = settings.actions_enabled;
+    }
+    if (settings.has_disable_actions_after) {
+        disable_actions_after_target_met_ = settings.disable_actions_after;
+    }
+
+    //messages
+    if (settings.has_all_transitions) {
+        target_met_msg_on_all_transitions_ = settings.all_transitions;
+    }
+    if (settings.has_send_to_computer) {
+        target_met_msg_to_computer_ = settings.send_to_computer;
+    }
+    if (settings.has_event_code_on) {
+        event_codes_.on = settings.event_codes.on;
+    }
+    if (settings.has_event_code_off) {
+        event_codes_.off = settings.event_codes.off;
+    }
+
+    //child
+    if (settings.has_child) {
+        const char *const error_string = this->set_child(settings.child_enabled, settings.child_number);
+        if ((error_string != NULL) && (settings.apply_error == NULL)) {
+            settings.apply_error = error_string;
+        }
+    }
+    if (settings.has_output_enabled) {
+        output_enabled_ = settings.output_enabled;
+        output_enabled_setting_ = settings.output_enabled;
+    }
+    if (settings.has_output_number) {
+        if (settings.output_number >= get_io_output_count()) {
+            output_ptr_ = NULL;
+        } else {
+            output_ptr_ = const_cast<volatile experimental_output *>(&(outputs_array_[settings.output_number]));
+        }
+    }
+    if (settings.has_output_disable_after) {
+        disable_output_after_target_met_once_ = settings.output_disable_after;
+    }
+    if (settings.has_output_cycles) {
+        output_cycle_counts_ = settings.output_cycles;
+    }
+    if (settings.has_output_delay) {
+        output_delay_tics_ = settings.output_delay_tics;
+    }
+
+    //timeout
+    if (settings.has_timeout) {
+        //this->set_timeout(timeout_e.value().uint64_);
+        timeout_length_tics_ = settings.timeout_length_tics;
+        hot_->in_timeout[number_] = false;
+    }
+
+    //threshold
+    if (settings.has_threshold) {
+        const char *const error_string = this->set_threshold(settings.threshold_enabled, settings.threshold_value);
+        if ((error_string != NULL) && (settings.apply_error == NULL)) {
+            settings.apply_error = error_string;
+        }
+    }
+
+    //any setting can change the target, so evaluate it again on the next tic
+    hot_->is_dirty[number_] = true;
+    hot_->is_dirty[this->highest_primary()->number_] = true;
+
+    debug_timestamps.exp_input_set_settings.toc();
+}
+
+//frees what was swapped out (or never used), and prints (interrupts must be enabled)
+void experimental_input::finish_settings(input_settings_t &settings) volatile const {
+    delete_array(settings.new_history_buffer);
+    delete_array(settings.old_history_buffer);
+    delete_array(settings.old_history_copy);
+    settings.new_history_buffer = NULL;
+    settings.old_history_buffer = NULL;
+    settings.old_history_copy = NULL;
+
+    if (settings.apply_error != NULL) {
+        this->printf_error(settings.apply_error);
     }
 
     debug_timestamps.exp_in_print_1 = CPU_TIMESTAMP;
-    if ((settings_e.count_found() > 0) && (settings_e.value().bool_)) {
+    if (settings.print_settings) {
         debug_timestamps.exp_in_print_2 = CPU_TIMESTAMP;
         this->print_settings(set_r);
         debug_timestamps.exp_in_print_5 = CPU_TIMESTAMP;
     }
+}
 
-    debug_timestamps.exp_input_set_settings.toc();
+//the buffers were allocated before, and are freed after (so this only moves pointers)
+void experimental_input::swap_history(input_settings_t &settings) volatile {
+    if (!settings.history_enabled) {
+        if (!history_enabled_) {return;}
+
+        //make sure to disable everything (history and threshold)
+        threshold_enabled_ = false;
+        threshold_value_ = 0;
+        threshold_count_ = 0;
+        history_enabled_ = false;
+        history_length_ = 0;
+        settings.old_history_buffer = history_ring_buffer_.swap_buffer(NULL, 0);
+
+        //and the history copy
+        if (history_copy_enabled_) {
+            settings.old_history_copy = history_copy_array_;
+            history_copy_array_ = NULL;
+            history_copy_enabled_ = false;
+        }
+        return;
+    }
+
+    //already this length (an unused buffer is freed after)
+    if (history_enabled_ && (history_length_ == settings.history_length)) {
+        return;
+    }
+
+    //history was changed by something applied after this was prepared
+    if (settings.new_history_buffer == NULL) {
+        if (settings.apply_error == NULL) {
+            settings.apply_error = "history buffer was not allocated";
+        }
+        return;
+    }
+
+    settings.old_history_buffer = history_ring_buffer_.swap_buffer(settings.new_history_buffer, settings.history_length);
+    settings.new_history_buffer = NULL;     //now owned by the ring buffer
+
+    //a new length needs a new copy, and a new threshold count
+    if (history_copy_enabled_) {
+        settings.old_history_copy = history_copy_array_;
+        history_copy_array_ = NULL;
+        history_copy_enabled_ = false;
+    }
+    threshold_count_ = 0;
+
+    history_length_ = settings.history_length;
+    history_enabled_ = true;
+}
+
+//the settings that would recreate the current configuration (everything is set)
+void experimental_input::get_current_settings(input_settings_t &settings) volatile const {
+    //padding included, so the same configuration is always the same words
+    memset(&settings, 0, sizeof(input_settings_t));
+    settings.number = number_;
+
+    settings.has_history = true;
+    settings.history_enabled = history_enabled_;
+    settings.history_length = history_length_;
+    settings.has_readout = true;
+    settings.readout_enabled = (readout_every_x_tics_ > 0);
+    settings.readout_every_x_tics = readout_every_x_tics_;
+
+    settings.has_met_min_length = true;
+    settings.target_met_min_length_tics = target_met_min_length_tics_;
+    settings.has_left_min_length = true;
+    settings.target_left_min_length_tics = target_left_min_length_tics_;
+    settings.has_target = target_set_;
+    if (is_digital_) {
+        settings.digital_target.polarity = target_.digital.polarity;
+    } else {
+        settings.analog_target.type = target_.analog.type;
+        settings.analog_target.value = target_.analog.value;
+        settings.analog_target.distance = target_.analog.distance;
+    }
+    settings.reset_target = true;
+
+    settings.has_actions_enabled = true;
+    settings.actions_enabled = actions_enabled_setting_;    //not what the isr has done since
+    settings.has_disable_actions_after = true;
+    settings.disable_actions_after = disable_actions_after_target_met_;
+    settings.has_all_transitions = true;
+    settings.all_transitions = target_met_msg_on_all_transitions_;
+    settings.has_send_to_computer = true;
+    settings.send_to_computer = target_met_msg_to_computer_;
+    settings.has_event_code_on = true;
+    settings.has_event_code_off = true;
+    settings.event_codes.on = event_codes_.on;
+    settings.event_codes.off = event_codes_.off;
+
+    settings.has_child = true;
+    settings.child_enabled = (child_input_ != NULL);
+    if (child_input_ != NULL) {
+        settings.child_number = child_input_->number_;
+    }
+
+    settings.has_output_enabled = true;
+    settings.output_enabled = output_enabled_setting_;
+    settings.has_output_number = true;
+    if (output_ptr_ != NULL) {
+        settings.output_number = static_cast<uint16_t>(output_ptr_ - outputs_array_);
+    } else {
+        settings.output_number = get_io_output_count();     //clears the output
+    }
+    settings.has_output_disable_after = true;
+    settings.output_disable_after = disable_output_after_target_met_once_;
+    settings.has_output_cycles = true;
+    settings.output_cycles = output_cycle_counts_;
+    settings.has_output_delay = true;
+    settings.output_delay_tics = output_delay_tics_;
+
+    settings.has_timeout = true;
+    settings.timeout_length_tics = timeout_length_tics_;
+    settings.has_threshold = true;
+    settings.threshold_enabled = threshold_enabled_;
+    settings.threshold_value = threshold_value_;
+}
+
+__attribute__((ramfunc))
+uint16_t experimental_input::chain_length() volatile const {
+    const volatile experimental_input *input_pointer = this;
+    uint16_t length = 1;
+
+    while (input_pointer->child_input_ != NULL) {
+        input_pointer = input_pointer->child_input_;
+        length++;
+    }
+
+    return length;
+}
+
+//the first region (in order) that holds the values wins
+__attribute__((ramfunc))
+uint16_t experimental_input::find_region() volatile const {
+    //gather the chain's values once, for every region
+    uint16_t values[max_region_channels];
+    uint16_t channel_count = 0;
+    const volatile experimental_input *input_pointer = this;
+    while ((input_pointer != NULL) && (channel_count < max_region_channels)) {
+        values[channel_count] = hot_->current_values[input_pointer->number_];
+        channel_count++;
+        input_pointer = input_pointer->child_input_;
+    }
+
+    //the chain is too long for any region
+    if (input_pointer != NULL) {
+        return no_region;
+    }
+
+    for (uint16_t region_i=0; region_i<region_count_; region_i++) {
+        if (is_inside_region(regions_[region_i], values, channel_count)) {
+            return region_i;
+        }
+    }
+
+    return no_region;
+}
+
+__attribute__((ramfunc))
+void experimental_input::process_regions() volatile {
+    input_hot_state_t &hot = *hot_;
+    const uint16_t i = number_;
+    const uint64_t clock_tic = hot.clock_tic;
+
+    //restart the length whenever the values move to another region
+    const uint16_t region = this->find_region();
+    if (region != hot.candidate_regions[i]) {
+        hot.candidate_regions[i] = region;
+        hot.candidate_region_tics[i] = clock_tic;
+    }
+
+    const uint16_t current_region = hot.current_regions[i];
+    if (region == current_region) {return;}
+
+    //entering a region needs its met length, and leaving for no region needs the old one's left length
+    uint64_t min_length_tics;
+    if (region != no_region) {
+        min_length_tics = regions_[region].met_min_length_tics;
+    } else {
+        min_length_tics = regions_[current_region].left_min_length_tics;
+    }
+
+    const uint64_t due_tic = hot.candidate_region_tics[i] + min_length_tics;
+    if (clock_tic >= due_tic) {
+        this->do_region_actions(region);
+    } else {
+        hot.wake_tics[i] = due_tic;
+    }
+}
+
+__attribute__((ramfunc))
+void experimental_input::do_region_actions(uint16_t region) volatile {
+    input_hot_state_t &hot = *hot_;
+    const uint16_t old_region = hot.current_regions[number_];
+    const uint16_t output_count = get_io_output_count();
+    bool output_was_queued = false;
+
+    hot.current_regions[number_] = region;
+
+    //if actions are disabled, then just set and exit
+    if (!target_met_actions_enabled_) {return;}
+
+    //leave the old region
+    if (old_region != no_region) {
+        const input_region_t &left_region = regions_[old_region];
+
+        if (left_region.event_codes.off > 0) {
+            send_high_priority_event_code(left_region.event_codes.off);
+        }
+
+        if (left_region.output_number < output_count) {
+            volatile experimental_output *const output_ptr = const_cast<volatile experimental_output *>(&(outputs_array_[left_region.output_number]));
+            if (output_ptr->is_continuous()) {
+                output_ptr->enable(false);
+            }
+        }
+    }
+
+    //enter the new one
+    if (region != no_region) {
+        const input_region_t &met_region = regions_[region];
+
+        if (met_region.event_codes.on > 0) {
+            send_high_priority_event_code(met_region.event_codes.on);
+        }
+
+        if (met_region.output_number < output_count) {
+            volatile experimental_output *const output_ptr = const_cast<volatile experimental_output *>(&(outputs_array_[met_region.output_number]));
+            output_was_queued = true;
+
+            if (output_ptr->is_continuous()) {
+                output_ptr->enable(true);
+            } else {
+                output_ptr->add_cycles(met_region.output_cycles, hot.clock_tic + output_delay_tics_);
+            }
+        }
+    }
+
+    //leaving for no region has no region_number
+    if (target_met_msg_to_computer_) {
+        if (region != no_region) {
+            delay_printf_json_objects(6, json_parent(const_cast<const char*>(name_), 5),
+                                      json_string("reason","external_event"),
+                                      json_timestamp(hot.clock_tic),
+                                      json_string("region", regions_[region].name),
+                                      json_uint16("region_number", region),
+                                      json_bool("output_queued", output_was_queued));
+        } else {
+            delay_printf_json_objects(5, json_parent(const_cast<const char*>(name_), 4),
+                                      json_string("reason","external_event"),
+                                      json_timestamp(hot.clock_tic),
+                                      json_string("region", "none"),
+                                      json_bool("output_queued", output_was_queued));
+        }
+    }
+}
+
+//the region is checked first, and only copied in with interrupts disabled
+void experimental_input::set_region(const json_t *const json_root) volatile {
+    json_element number_e("input_number", t_uint16, true);
+    json_element region_number_e("region_number", t_uint16, true);
+    json_element region_enabled_e("region_enabled", t_bool);
+    json_element region_name_e("region_name", t_string);
+    json_element region_type_e("region_type", t_string);
+    json_element region_values_e("region_values", t_uint16, false, true);
+    json_element region_distances_e("region_distances", t_uint16, false, true);
+    json_element region_angle_e("region_angle", t_float32);
+
+    const uint16_t found_count = set_elements_with_json(json_root, 14,
+                           &number_e, &region_number_e, &region_enabled_e, &region_name_e,
+                           &region_type_e, &region_values_e, &region_distances_e, &region_angle_e,
+                           &met_min_tics_e, &left_min_tics_e, &event_code_met_e, &event_code_left_e,
+                           &output_number_e, &output_cycles_e);
+
+    //if none found, return
+    if (found_count == 0) {
+        return;
+    }
+
+    if (number_e.value().uint16_ != number_) {
+        this->printf_error("input_number is wrong");
+        return;
+    }
+    if (is_digital_ || (parent_input_ != NULL)) {
+        this->printf_error("regions can only be set on a primary analog input");
+        return;
+    }
+
+    const uint16_t region_number = region_number_e.value().uint16_;
+    if (region_number >= max_input_regions) {
+        this->printf_error("region_number is too high");
+        return;
+    }
+
+    //disabling only needs the number
+    if ((region_enabled_e.count_found() > 0) && (!region_enabled_e.value().bool_)) {
+        if (regions_ != NULL) {
+            const uint16_t interrupt_settings = __disable_interrupts();
+            regions_[region_number].enabled = false;
+            hot_->is_dirty[number_] = true;
+            __restore_interrupts(interrupt_settings);
+        }
+        return;
+    }
+
+    if ((region_name_e.count_found() == 0) || (region_type_e.count_found() == 0) || (region_values_e.count_found() == 0)) {
+        this->printf_error("region needs region_name, region_type, and region_values");
+        return;
+    }
+
+    input_region_t region;
+    memset(&region, 0, sizeof(input_region_t));
+    region.enabled = true;
+    strncpy(region.name, region_name_e.value().string_, 8);
+    region.name[8] = 0;
+
+    region.type = get_region_type(region_type_e.value().string_);
+    if (region.type == region_error) {
+        this->printf_error("region_type is not valid");
+        return;
+    }
+
+    //one value per channel (parent, then children)
+    region.channel_count = this->chain_length();
+    if ((region.channel_count > max_region_channels) || (region_values_e.count_found() != region.channel_count)) {
+        this->printf_error("region_values needs one value per channel (parent, then children)");
+        return;
+    }
+
+    //circular has one distance, the rest have one per channel
+    const uint16_t distance_count = (region.type == region_circular) ? 1 : region.channel_count;
+    if (region_distances_e.count_found() != distance_count) {
+        this->printf_error("region_distances needs one distance (circular), or one per channel");
+        return;
+    }
+
+    for (uint16_t i=0; i<region.channel_count; i++) {
+        region.values[i] = region_values_e.get_uint16_array()[i];
+    }
+    for (uint16_t i=0; i<distance_count; i++) {
+        region.distances[i] = region_distances_e.get_uint16_array()[i];
+    }
+    if (region_angle_e.count_found() > 0) {
+        region.angle = region_angle_e.value().float32_;
+    }
+
+    //actions (anything not found stays 0)
+    if (event_code_met_e.count_found() > 0) {
+        if (!is_high_priority_event_code(event_code_met_e.value().uint16_)) {
+            this->printf_error(event_code_range_error);
+            return;
+        }
+        region.event_codes.on = event_code_met_e.value().uint16_;
+    }
+    if (event_code_left_e.count_found() > 0) {
+        if (!is_high_priority_event_code(event_code_left_e.value().uint16_)) {
+            this->printf_error(event_code_range_error);
+            return;
+        }
+        region.event_codes.off = event_code_left_e.value().uint16_;
+    }
+    if (met_min_tics_e.count_found() > 0) {
+        region.met_min_length_tics = met_min_tics_e.value().uint64_;
+    }
+    if (left_min_tics_e.count_found() > 0) {
+        region.left_min_length_tics = left_min_tics_e.value().uint64_;
+    }
+    region.output_number = get_io_output_count();   //no output
+    region.output_cycles = 1;
+    if (output_number_e.count_found() > 0) {
+        if (output_number_e.value().uint16_ >= get_io_output_count()) {
+            this->printf_error("'output_number' is too high");
+            return;
+        }
+        region.output_number = output_number_e.value().uint16_;
+    }
+    if (output_cycles_e.count_found() > 0) {
+        if (output_cycles_e.value().uint16_ == 0) {
+            this->printf_error(output_cycles_zero_error);
+            return;
+        }
+        region.output_cycles = output_cycles_e.value().uint16_;
+    }
+
+    const char *const error_string = calculate_region_coefficients(region);
+    if (error_string != NULL) {
+        this->printf_error(error_string);
+        return;
+    }
+
+    if (!this->prepare_regions()) {return;}
+
+    //only after checking everything
+    //disable and store the interrupt state
+    const uint16_t interrupt_settings = __disable_interrupts();
+
+    this->apply_region(region_number, region);
 
     //restore the interrupt state
     __restore_interrupts(interrupt_settings);
+
+    this->print_region(region_number);
+}
+
+//allocate the table the first time
+bool experimental_input::prepare_regions() volatile {
+    if (regions_ == NULL) {
+        input_region_t *const regions = create_array_of<input_region_t>(max_input_regions, "input_regions");
+        if (regions == NULL) {return false;}
+        memset(regions, 0, max_input_regions * sizeof(input_region_t));
+        regions_ = regions;
+    }
+    return true;
+}
+
+//the table must already be allocated
+void experimental_input::apply_region(uint16_t region_number, const input_region_t &region) volatile {
+    regions_[region_number] = region;
+    if (region_number >= region_count_) {
+        region_count_ = region_number + 1;
+    }
+    hot_->is_dirty[number_] = true;
+}
+
+//a region that was set (even if disabled since), as set_region left it
+bool experimental_input::get_region_setting(uint16_t region_number, input_region_t &region) volatile const {
+    if ((regions_ == NULL) || (region_number >= region_count_) || (regions_[region_number].channel_count == 0)) {
+        return false;
+    }
+
+    memcpy(&region, &(regions_[region_number]), sizeof(input_region_t));
+    return true;
+}
+
+void experimental_input::reset_regions() volatile {
+    //leave the current region first, so its continuous output is turned off and its left code is sent
+    if (hot_->current_regions[number_] != no_region) {
+        this->do_region_actions(no_region);
+    }
+
+    //so nothing cleared comes back when a higher region is set
+    if (regions_ != NULL) {
+        memset(regions_, 0, max_input_regions * sizeof(input_region_t));
+    }
+    region_count_ = 0;
+    hot_->current_regions[number_] = no_region;
+    hot_->candidate_regions[number_] = no_region;
+    hot_->is_dirty[number_] = true;
+}
+
+//back to the target
+void experimental_input::clear_regions() volatile {
+    //disable and store the interrupt state
+    const uint16_t interrupt_settings = __disable_interrupts();
+
+    this->reset_regions();
+
+    //restore the interrupt state
+    __restore_interrupts(interrupt_settings);
+
+    delay_printf_json_objects(3, json_parent(const_cast<const char*>(name_), 2),
+                              json_string("reason","set"),
+                              json_uint16("region_count", 0));
+}
+
+void experimental_input::print_region(uint16_t region_number) volatile const {
+    const input_region_t &region = regions_[region_number];
+    const uint16_t distance_count = (region.type == region_circular) ? 1 : region.channel_count;
+
+    delay_printf_json_objects(14, json_parent(const_cast<const char*>(name_), 13),
+                              json_string("reason","get"),
+                              json_uint16("region_number", region_number),
+                              json_string("region_name", region.name),
+                              json_string("region_type", get_region_type_name(region.type)),
+                              json_uint16_array("region_values", region.channel_count, region.values, true),
+                              json_uint16_array("region_distances", distance_count, region.distances, true),
+                              json_float32("region_angle", region.angle),
+                              json_uint64(target_met_min_tics_string, region.met_min_length_tics),
+                              json_uint64(target_left_min_tics_string, region.left_min_length_tics),
+                              json_uint16(event_code_met_string, region.event_codes.on),
+                              json_uint16(event_code_left_string, region.event_codes.off),
+                              json_bool("has_output", (region.output_number < get_io_output_count())),
+                              json_uint16(output_cycles_string, region.output_cycles));
+}
+
+void experimental_input::print_regions() volatile const {
+    uint16_t enabled_count = 0;
+    for (uint16_t region_i=0; region_i<region_count_; region_i++) {
+        if (regions_[region_i].enabled) {
+            this->print_region(region_i);
+            enabled_count++;
+        }
+    }
+
+    const uint16_t current_region = hot_->current_regions[number_];
+    delay_printf_json_objects(4, json_parent(const_cast<const char*>(name_), 3),
+                              json_string("reason","get"),
+                              json_uint16("region_count", enabled_count),
+                              json_string("current_region", (current_region != no_region) ? regions_[current_region].name : "none"));
 }
@@ -42,28 +42,123 @@ typedef struct analog_target_t {
 } analog_target_t;
 
 
+//settings from one command, already parsed and checked (so they can be applied later, all at once)
+typedef struct input_settings_t {
+    uint16_t number;
+
+    //history and readout
+    bool has_history;
+    bool history_enabled;
+    uint16_t history_length;
+    bool has_readout;
+    bool readout_enabled;
+    uint64_t readout_every_x_tics;
+
+    //target
+    bool has_met_min_length;
+    uint64_t target_met_min_length_tics;
+    bool has_left_min_length;
+    uint64_t target_left_min_length_tics;
+    bool has_target;
+    digital_target_t digital_target;
+    analog_target_t analog_target;
+    bool reset_target;
+
+    //actions and messages
+    bool has_actions_enabled;
+    bool actions_enabled;
+    bool has_disable_actions_after;
+    bool disable_actions_after;
+    bool has_all_transitions;
+    bool all_transitions;
+    bool has_send_to_computer;
+    bool send_to_computer;
+    bool has_event_code_on;
+    bool has_event_code_off;
+    io_event_codes_t event_codes;
+
+    //child (chain)
+    bool has_child;
+    bool child_enabled;
+    uint16_t child_number;
+
+    //output
+    bool has_output_enabled;
+    bool output_enabled;
+    bool has_output_number;
+    uint16_t output_number;     //too high clears the output
+    bool has_output_disable_after;
+    bool output_disable_after;
+    bool has_output_cycles;
+    uint16_t output_cycles;
+    bool has_output_delay;
+    uint64_t output_delay_tics;
+
+    //timeout and threshold
+    bool has_timeout;
+    uint64_t timeout_length_tics;
+    bool has_threshold;
+    bool threshold_enabled;
+    uint16_t threshold_value;
+
+    bool print_settings;
+
+    //heap work and messages are kept out of apply_settings (so it only copies fields, with interrupts disabled)
+    uint16_t *new_history_buffer;   //allocated by prepare_settings
+    uint16_t *old_history_buffer;   //freed by finish_settings
+    uint16_t *old_history_copy;     //freed by finish_settings
+    const char *apply_error;        //printed by finish_settings
+} input_settings_t;
+
+
+//per-tic state of every input, as parallel arrays (indexed by input number)
+//only changed by the isr (or with interrupts disabled), so unlike the inputs, none of it is volatile
+typedef struct input_hot_state_t {
+    uint64_t clock_tic;                 //the same for every input
+    uint16_t *current_values;           //can fit both digital and analog
+    bool *target_met;                   //meets target conditions
+    bool *in_timeout;
+    uint64_t *conditionally_met_tics;
+    uint64_t *conditionally_left_tics;
+    uint64_t *timeout_start_tics;       //reset each time the target is met again
+    bool *is_dirty;                     //a value (or setting) changed, so the target must be evaluated again
+    uint64_t *wake_tics;                //next deadline (timeout or min length), 0 if none
+    uint16_t *current_regions;          //no_region if not in any region
+    uint16_t *candidate_regions;        //region the values are in now (but not for long enough)
+    uint64_t *candidate_region_tics;
+
+    //digital inputs, packed (bit n is digital channel n)
+    uint32_t digital_values;            //one snapshot per tic
+    uint32_t digital_polarities;        //digital targets
+    uint32_t digital_targets_met;       //set with digital_values, as ~(values ^ polarities)
+} input_hot_state_t;
+
+
 #include "ring_buffer.h"
+#include "input_regions.h"
 #include "printf_json_types.h"
+#include "printf_json_delayed.h"
 
 typedef uint16_t (*input_get_function) (uint16_t channel);
 
 class experimental_input {
     public:
         //init
-        void init(uint16_t number, uint16_t channel, bool is_digital, const volatile input_get_function get_function, const volatile experimental_input *const inputs_array, const volatile experimental_output *const outputs_array) volatile;
+        void init(uint16_t number, uint16_t channel, bool is_digital, const volatile input_get_function get_function, const volatile experimental_input *const inputs_array, const volatile experimental_output *const outputs_array, input_hot_state_t *const hot_state) volatile;
 
-        //process
-        void update_current_value(uint64_t experiment_tic) volatile;
-        void process_actions() volatile;    //must already have experiment_tic set
+        //process (the hot state clock_tic and digital values must already be set)
+        void update_current_value() volatile;
+        void process_actions() volatile;    //must already have updated the current values
 
         //misc
-        void print_current_value() volatile const;
+        void print_current_value(bool is_readout = false) volatile const;   //readouts are coalesced telemetry
         void print_threshold_count() volatile const;
-        uint16_t get_current_value() volatile const {return current_value_;}
+        uint16_t get_current_value() volatile const {return hot_->current_values[number_];}
         uint16_t get_channel() volatile const {return channel_;}
         uint16_t get_number() volatile const {return number_;}
         const char *get_name() volatile const {return const_cast<char*>(name_);}
         bool is_digital() volatile const {return is_digital_;}
+        void set_get_function(const input_get_function get_function) volatile {get_function_ = get_function;}
 
         //history
         void enable_history(bool enable, uint16_t history_length = 0) volatile;
@@ -71,7 +166,7 @@ class experimental_input {
         bool is_history_enabled() volatile const {return history_enabled_;}
         uint16_t history_used() volatile const;
         uint16_t history_length() volatile const;
-        bool get_copy_of_history(uint16_t count, json_object_t &json_object) volatile;
+        bool get_copy_of_history(uint16_t count, json_object_t &json_object, bool is_delta_varint) volatile;
         bool is_history_being_printed() volatile const {return history_is_printing_;}
 
         //other setting functions
@@ -81,17 +176,32 @@ class experimental_input {
 
         //functions for overall settings
         void set_settings(const json_t *const json_root) volatile;
+        bool parse_settings(const json_t *const json_root, input_settings_t &settings, bool reject_any_error = false) volatile const;
+        bool prepare_settings(input_settings_t &settings) volatile const;  //before interrupts are disabled
+        void apply_settings(input_settings_t &settings) volatile;          //interrupts must be disabled
+        void finish_settings(input_settings_t &settings) volatile const;   //after interrupts are restored
+        void get_current_settings(input_settings_t &settings) volatile const;
         void get_settings(const json_t *const json_root) volatile const;
         void set_actions(const json_t *const json_root) volatile const;
         static const char *get_analog_target_type_name(analog_target_type_t target_type);
         void print_settings(reason_t reason_code) volatile const;
 
+        //regions (once one is set, they replace the target)
+        void set_region(const json_t *const json_root) volatile;
+        void clear_regions() volatile;
+        void print_regions() volatile const;
+        uint16_t get_current_region() volatile const {return hot_->current_regions[number_];}
+        bool get_region_setting(uint16_t region_number, input_region_t &region) volatile const;    //false if not set
+        bool prepare_regions() volatile;                                                    //before interrupts are disabled
+        void reset_regions() volatile;                                                      //interrupts must be disabled
+        void apply_region(uint16_t region_number, const input_region_t &region) volatile;   //interrupts must be disabled
+
     private:
         //basic information
         uint16_t number_;
         bool is_digital_;
         bool is_enabled_;
-        uint16_t current_value_; //can fit both digital and analog
+        input_hot_state_t *hot_;    //current value, target met, and timeout state live here
 
         //history
         bool history_enabled_;
@@ -103,19 +213,17 @@ class experimental_input {
 
         //target has been met
         bool target_set_;
-        bool target_met_;      //meets target conditions
         bool target_met_msg_on_all_transitions_;    //send all transitions
         bool target_met_msg_to_computer_;
 
         //actions enabled
         bool target_met_actions_enabled_;           //so it can be set without being enabled
         bool disable_actions_after_target_met_;   //so it can be a one-shot input
-
-        //timeout
-        bool is_in_timeout_;     //timeout is enabled
+        bool actions_enabled_setting_;              //as configured (the isr clears target_met_actions_enabled_)
 
         //output
         bool output_enabled_;    //for a reward, or something else
+        bool output_enabled_setting_;   //as configured (the isr clears output_enabled_)
         bool disable_output_after_target_met_once_;
         uint16_t output_cycle_counts_; //add this many "events" to the output queue
 
@@ -123,10 +231,7 @@ class experimental_input {
         io_event_codes_t event_codes_;
         uint64_t readout_every_x_tics_; //modulo with experimental_clock
         uint64_t target_met_min_length_tics_;   //minimum length to be considered valid as met
-        uint64_t target_conditionally_met_tic_;
         uint64_t target_left_min_length_tics_;   //minimum length to be considered valid as left
-        uint64_t target_conditionally_left_tic_;
-        uint64_t timeout_start_tic_;     //reset each time the target is met again
         uint64_t timeout_length_tics_;
         uint64_t output_delay_tics_;
 
@@ -135,6 +240,8 @@ class experimental_input {
             digital_target_t digital;
             analog_target_t  analog;
         } target_;
+        uint32_t region_distance_squared_;  //for circular and elliptical targets
+        uint64_t region_coefficient_;       //elliptical only (Q62)
 
         ring_buffer history_ring_buffer_;
         bool history_is_printing_;  //true when printing, false once done
@@ -151,14 +258,30 @@ class experimental_input {
         volatile experimental_input *parent_input_;
         volatile experimental_input *child_input_;
         volatile experimental_output *output_ptr_;
-        uint64_t clock_tic_;
         char name_[9]; //limits the max number to 99
 
+        //messages that are printed often (NULL if they couldn't be created)
+        const json_template_t *value_template_;
+        const json_template_t *target_met_template_;
+
+        //region table (allocated when the first region is set)
+        input_region_t *regions_;
+        uint16_t region_count_;     //highest region number set, plus 1
+
         //private functions
+        void create_message_templates() volatile;
         const volatile experimental_input *highest_primary() volatile const;
         void do_target_actions(bool target_met) volatile;
-        bool does_value_meet_this_target() volatile const;
+        void swap_history(input_settings_t &settings) volatile;
+        const char *set_child(bool enable, uint16_t number) volatile;
+        const char *set_threshold(bool enable, uint16_t threshold_value) volatile;
+        bool does_value_meet_this_target(uint16_t current_value) volatile const;
         bool does_value_meet_all_targets() volatile const;
+        uint16_t chain_length() volatile const;
+        uint16_t find_region() volatile const;
+        void process_regions() volatile;
+        void do_region_actions(uint16_t region) volatile;
+        void print_region(uint16_t region_number) volatile const;
         void send_target_met_message(bool target_met, bool output_queued) volatile const;
         void printf_status(const char *const message) volatile const;
         void printf_error(const char *const message) volatile const;
@@ -10,6 +10,7 @@
 #include "printf_json_delayed.h"    //for safety, should only have delayed prints
 #include "extract_json.h"
 #include "tic_toc.h"
+#include "string.h"
 
 
 //internal variables
@@ -30,6 +31,7 @@ static json_element settings_out_e("get_settings", t_bool);
 void experimental_output::init(uint16_t number, uint16_t channel, const volatile output_set_function set_function) volatile {
     //default construction
     is_enabled_ = false;
+    enabled_setting_ = false;
     current_value_ = 0;
     is_continuous_ = false;
     is_in_a_cycle_now_ = false;
@@ -78,6 +80,12 @@ void experimental_output::init(uint16_t number, uint16_t channel, const volatile
         delay_printf_json_error("output name not ready for > 99");
     }
 
+    //the name is fixed from now on (only the values are placeholders)
+    output_on_template_ = create_json_template(4, json_parent(const_cast<const char*>(name_), 3),
+                                                  json_string("reason", "external_event"),
+                                                  json_timestamp(0),
+                                                  json_bool("output_on", false));
+
     if (set_function_ == NULL) {
         this->printf_error("set function points to null");
         return;
@@ -86,6 +94,7 @@ void experimental_output::init(uint16_t number, uint16_t channel, const volatile
     this->set_current_value(current_value_, false);
 
     is_enabled_ = true;
+    enabled_setting_ = true;
 }
 
 
@@ -108,10 +117,10 @@ void experimental_output::set_current_value(uint16_t new_value, bool send_codes_
         }
 
         if (output_start_cycle_msg_to_computer_) {
-            delay_printf_json_objects(4, json_parent(const_cast<const char*>(name_), 3),
-                                         json_string("reason", "external_event"),
-                                         json_timestamp(clock_tic_),
-                                         json_bool("output_on", true));
+            delay_printf_json_template(output_on_template_, print_class_event, print_coalesce_none, 4, json_parent(const_cast<const char*>(name_), 3),
+                                       json_string("reason", "external_event"),
+                                       json_timestamp(clock_tic_),
+                                       json_bool("output_on", true));
         }
     } else if (current_value_ == off_value_) {
         if (event_codes_.off > 0) {
@@ -119,10 +128,10 @@ void experimental_output::set_current_value(uint16_t new_value, bool send_codes_
         }
 
         if (output_start_cycle_msg_to_computer_ && all_transitions_) {
-            delay_printf_json_objects(4, json_parent(const_cast<const char*>(name_), 3),
-                                         json_string("reason", "external_event"),
-                                         json_timestamp(clock_tic_),
-                                         json_bool("output_on", false));
+            delay_printf_json_template(output_on_template_, print_class_event, print_coalesce_none, 4, json_parent(const_cast<const char*>(name_), 3),
+                                       json_string("reason", "external_event"),
+                                       json_timestamp(clock_tic_),
+                                       json_bool("output_on", false));
         }
     }
 }
@@ -295,10 +304,29 @@ void experimental_output::printf_error(const char *const message) volatile const
 }
 
 void experimental_output::set_settings(const json_t *const json_root) volatile {
+    output_settings_t settings;
+    if (!this->parse_settings(json_root, settings)) {
+        return;
+    }
+
+    //only after setting the elements
+    //disable and store the interrupt state
+    const uint16_t interrupt_settings = __disable_interrupts();
+
+    this->apply_settings(settings);
+
+    //restore the interrupt state
+    __restore_interrupts(interrupt_settings);
+
+    this->finish_settings(settings);
+}
+
+//only reads the json (nothing is changed), so it can be done well before the settings are applied
+bool experimental_output::parse_settings(const json_t *const json_root, output_settings_t &settings, bool reject_any_error) volatile const {
     json_element number_e("output_number", t_uint16, true);
     if ((!number_e.set_with_json(json_root, true)) || (number_e.value().uint16_ != number_)) {
         this->printf_error("'output_number' is wrong");
-        return;
+        return false;
     }
 
     const uint16_t found_count = set_elements_with_json(json_root, 13, &number_e, &enable_e, &on_value_e, &off_value_e,
@@ -307,60 +335,70 @@ void experimental_output::set_settings(const json_t *const json_root) volatile {
                                        &all_transitions_out_e);
 
     if (found_count == 0) {
-        return;
+        return false;
     }
 
-    //only after setting the elements
-    //disable and store the interrupt state
-    const uint16_t interrupt_settings = __disable_interrupts();
-
-    debug_timestamps.exp_output_set_settings.tic();
+    //nothing is set unless found (and valid)
+    memset(&settings, 0, sizeof(output_settings_t));
+    settings.number = number_;
+    uint16_t error_count = 0;
 
     if (on_tics_e.count_found() > 0) {
         uint64_t temp_value = on_tics_e.value().uint64_;
         if (temp_value == 0) {
             this->printf_error("on_tics cannot be 0");
+            error_count++;
         } else {
-            length_on_tics_ =temp_value;
+            settings.has_on_tics = true;
+            settings.on_tics = temp_value;
         }
     }
     if (off_tics_e.count_found() > 0) {
         uint64_t temp_value = off_tics_e.value().uint64_;
         if (temp_value == 0) {
             this->printf_error("off_tics cannot be 0");
+            error_count++;
         } else {
-            length_off_tics_ = temp_value;
+            settings.has_off_tics = true;
+            settings.off_tics = temp_value;
         }
     }
     if (enable_e.count_found() > 0) {
-        is_enabled_ = enable_e.value().bool_;
+        settings.has_enabled = true;
+        settings.enabled = enable_e.value().bool_;
     }
     if (on_value_e.count_found() > 0) {
         uint16_t tmp_val = on_value_e.value().uint16_;
         if (is_digital_ && (tmp_val > 1)) {
             tmp_val = 1;
         }
-        on_value_ = tmp_val;
+        settings.has_on_value = true;
+        settings.on_value = tmp_val;
     }
     if (off_value_e.count_found() > 0) {
         uint16_t tmp_val = off_value_e.value().uint16_;
         if (is_digital_ && (tmp_val > 1)) {
             tmp_val = 1;
         }
-        off_value_ = tmp_val;
+        settings.has_off_value = true;
+        settings.off_value = tmp_val;
     }
     if (event_on_e.count_found() > 0) {
         if ((event_on_e.value().uint16_ > 127) && (event_on_e.value().uint16_ < 256)) {
-            event_codes_.on = event_on_e.value().uint16_;
+            settings.has_event_code_on = true;
+            settings.event_codes.on = event_on_e.value().uint16_;
         } else {
             this->printf_error("event code outside of range 128-255");
+            error_count++;
         }
     }
     if (event_off_e.count_found() > 0) {
         if ((event_off_e.value().uint16_ > 127) && (event_off_e.value().uint16_ < 256)) {
-            event_codes_.off = event_off_e.value().uint16_;
+            settings.has_event_code_off = true;
+            settings.event_codes.off = event_off_e.value().uint16_;
         } else {
             this->printf_error("event code outside of range 128-255");
+            error_count++;
         }
     }
     if (value_e.count_found() > 0) {
@@ -368,26 +406,102 @@ void experimental_output::set_settings(const json_t *const json_root) volatile {
         if (is_digital_ && (tmp_val > 1)) {
             tmp_val = 1;
         }
-
-        //this is the only time codes/messages are not sent
-        this->set_current_value(tmp_val, false);
+        settings.has_value = true;
+        settings.value = tmp_val;
     }
     if (is_cont_e.count_found() > 0) {
-        is_continuous_ = is_cont_e.value().bool_;
+        settings.has_continuous = true;
+        settings.is_continuous = is_cont_e.value().bool_;
     }
     if (send_to_computer_out_e.count_found() > 0) {
-        output_start_cycle_msg_to_computer_ = send_to_computer_out_e.value().bool_;
+        settings.has_send_to_computer = true;
+        settings.send_to_computer = send_to_computer_out_e.value().bool_;
     }
     if (all_transitions_out_e.count_found() > 0) {
-        all_transitions_ = all_transitions_out_e.value().bool_;
+        settings.has_all_transitions = true;
+        settings.all_transitions = all_transitions_out_e.value().bool_;
     }
 
-    if ((settings_out_e.count_found() > 0) && (settings_out_e.value().bool_)) {
-        this->print_settings(set_r);
+    settings.print_settings = ((settings_out_e.count_found() > 0) && (settings_out_e.value().bool_));
+
+    //staged settings are all or nothing
+    return ((error_count == 0) || (!reject_any_error));
+}
+
+//just copies what was parsed, in the same order as always (interrupts must be disabled)
+void experimental_output::apply_settings(const output_settings_t &settings) volatile {
+    debug_timestamps.exp_output_set_settings.tic();
+
+    if (settings.has_on_tics) {
+        length_on_tics_ = settings.on_tics;
+    }
+    if (settings.has_off_tics) {
+        length_off_tics_ = settings.off_tics;
+    }
+    if (settings.has_enabled) {
+        is_enabled_ = settings.enabled;
+        enabled_setting_ = settings.enabled;
+    }
+    if (settings.has_on_value) {
+        on_value_ = settings.on_value;
+    }
+    if (settings.has_off_value) {
+        off_value_ = settings.off_value;
+    }
+    if (settings.has_event_code_on) {
+        event_codes_.on = settings.event_codes.on;
+    }
+    if (settings.has_event_code_off) {
+        event_codes_.off = settings.event_codes.off;
+    }
+    if (settings.has_value) {
+        //this is the only time codes/messages are not sent
+        this->set_current_value(settings.value, false);
+    }
+    if (settings.has_continuous) {
+        is_continuous_ = settings.is_continuous;
+    }
+    if (settings.has_send_to_computer) {
+        output_start_cycle_msg_to_computer_ = settings.send_to_computer;
+    }
+    if (settings.has_all_transitions) {
+        all_transitions_ = settings.all_transitions;
     }
 
     debug_timestamps.exp_output_set_settings.toc();
+}
 
-    //restore the interrupt state
-    __restore_interrupts(interrupt_settings);
+//prints (interrupts must be enabled)
+void experimental_output::finish_settings(const output_settings_t &settings) volatile const {
+    if (settings.print_settings) {
+        this->print_settings(set_r);
+    }
+}
+
+//the settings that would recreate the current configuration (the value itself is left alone)
+void experimental_output::get_current_settings(output_settings_t &settings) volatile const {
+    //padding included, so the same configuration is always the same words
+    memset(&settings, 0, sizeof(output_settings_t));
+    settings.number = number_;
+
+    settings.has_on_tics = true;
+    settings.on_tics = length_on_tics_;
+    settings.has_off_tics = true;
+    settings.off_tics = length_off_tics_;
+    settings.has_enabled = true;
+    settings.enabled = enabled_setting_;
+    settings.has_on_value = true;
+    settings.on_value = on_value_;
+    settings.has_off_value = true;
+    settings.off_value = off_value_;
+    settings.has_event_code_on = true;
+    settings.has_event_code_off = true;
+    settings.event_codes.on = event_codes_.on;
+    settings.event_codes.off = event_codes_.off;
+    settings.has_continuous = true;
+    settings.is_continuous = is_continuous_;
+    settings.has_send_to_computer = true;
+    settings.send_to_computer = output_start_cycle_msg_to_computer_;
+    settings.has_all_transitions = true;
+    settings.all_transitions = all_transitions_;
 }
@@ -14,10 +14,38 @@
 #include "F28x_Project.h"
 #include "tiny_json.h"
 #include "io_controller.h"
+#include "printf_json_delayed.h"
 
 
 typedef void (*output_set_function) (uint16_t channel, uint16_t value);
 
+//settings from one command, already parsed and checked (so they can be applied later, all at once)
+typedef struct output_settings_t {
+    uint16_t number;
+    bool has_on_tics;
+    uint64_t on_tics;
+    bool has_off_tics;
+    uint64_t off_tics;
+    bool has_enabled;
+    bool enabled;
+    bool has_on_value;
+    uint16_t on_value;
+    bool has_off_value;
+    uint16_t off_value;
+    bool has_event_code_on;
+    bool has_event_code_off;
+    io_event_codes_t event_codes;
+    bool has_value;
+    uint16_t value;
+    bool has_continuous;
+    bool is_continuous;
+    bool has_send_to_computer;
+    bool send_to_computer;
+    bool has_all_transitions;
+    bool all_transitions;
+    bool print_settings;
+} output_settings_t;
+
 class experimental_output {
     public:
         //init
@@ -46,6 +74,10 @@ class experimental_output {
         //settings/actions
         void set_actions(const json_t *const json_root) volatile;
         void set_settings(const json_t *const json_root) volatile;
+        bool parse_settings(const json_t *const json_root, output_settings_t &settings, bool reject_any_error = false) volatile const;
+        void apply_settings(const output_settings_t &settings) volatile;           //interrupts must be disabled
+        void finish_settings(const output_settings_t &settings) volatile const;    //after interrupts are restored
+        void get_current_settings(output_settings_t &settings) volatile const;
         void get_settings(const json_t *const json_root) volatile const;
         void print_settings(reason_t reason_code) volatile const;
 
@@ -53,6 +85,7 @@ class experimental_output {
         //basic information
         uint16_t number_;
         bool is_enabled_;
+        bool enabled_setting_;  //as configured (inputs enable and disable it while running)
         uint16_t current_value_;
         uint16_t on_value_;
         uint16_t off_value_;
@@ -78,6 +111,7 @@ class experimental_output {
         uint64_t start_delay_tic_;
         io_event_codes_t event_codes_;
         char name_[10]; //limits the max number to 99
+        const json_template_t *output_on_template_;    //NULL if it couldn't be created
 
         void set_current_value(uint16_t new_value, bool send_codes_and_messages = true) volatile;
         void printf_error(const char *const message) volatile const;
@@ -0,0 +1,132 @@
+/*
+ * input_regions.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "input_regions.h"
+#include "analog_region.h"
+#include "math.h"
+#include "string.h"
+
+
+//internal functions
+bool is_inside_rotated_ellipse(const input_region_t &region, const uint16_t *const values);
+
+
+const char *get_region_type_name(region_type_t region_type) {
+    const char *ptr;
+
+    switch (region_type) {
+        case region_rectangular:
+            ptr = "rectangular_distance";
+            break;
+        case region_circular:
+            ptr = "circular_distance";
+            break;
+        case region_elliptical:
+            ptr = "elliptical_distance";
+            break;
+        case region_rotated_elliptical:
+            ptr = "rotated_elliptical_distance";
+            break;
+        default:
+            ptr = "error";
+            break;
+    }
+
+    return ptr;
+}
+
+region_type_t get_region_type(const char *const name) {
+    for (uint16_t type_i=0; type_i<region_error; type_i++) {
+        const region_type_t region_type = static_cast<region_type_t>(type_i);
+        if (strcmp(name, get_region_type_name(region_type)) == 0) {
+            return region_type;
+        }
+    }
+
+    return region_error;
+}
+
+const char *calculate_region_coefficients(input_region_t &region) {
+    if ((region.channel_count == 0) || (region.channel_count > max_region_channels)) {
+        return "region must have between 1 and 4 channels";
+    }
+    if ((region.type == region_rotated_elliptical) && (region.channel_count != 2)) {
+        return "rotated_elliptical_distance needs exactly 2 channels";
+    }
+
+    //circular only uses the first distance
+    const uint16_t distance_count = (region.type == region_circular) ? 1 : region.channel_count;
+    for (uint16_t i=0; i<distance_count; i++) {
+        if ((region.type != region_rectangular) && (region.distances[i] == 0)) {
+            return "region distances must be greater than 0";
+        }
+        region.distances_squared[i] = region_distance_squared(region.distances[i]);
+        region.coefficients[i] = region_ellipse_coefficient(region.distances_squared[i]);
+    }
+
+    //rotate the ellipse into the three terms of x and y
+    if (region.type == region_rotated_elliptical) {
+        const float32 radians = region.angle * (3.14159265f / 180.0f);
+        const float32 cos_angle = static_cast<float32>(cos(radians));
+        const float32 sin_angle = static_cast<float32>(sin(radians));
+        const float32 inv_x_squared = 1.0f / static_cast<float32>(region.distances_squared[0]);
+        const float32 inv_y_squared = 1.0f / static_cast<float32>(region.distances_squared[1]);
+
+        region.rotated_coefficients[0] = (cos_angle * cos_angle * inv_x_squared) + (sin_angle * sin_angle * inv_y_squared);
+        region.rotated_coefficients[1] = 2.0f * sin_angle * cos_angle * (inv_x_squared - inv_y_squared);
+        region.rotated_coefficients[2] = (sin_angle * sin_angle * inv_x_squared) + (cos_angle * cos_angle * inv_y_squared);
+    }
+
+    return NULL;
+}
+
+__attribute__((ramfunc))
+bool is_inside_rotated_ellipse(const input_region_t &region, const uint16_t *const values) {
+    const float32 x = static_cast<float32>(values[0]) - static_cast<float32>(region.values[0]);
+    const float32 y = static_cast<float32>(values[1]) - static_cast<float32>(region.values[1]);
+    const float32 sum = (region.rotated_coefficients[0] * x * x) + (region.rotated_coefficients[1] * x * y) + (region.rotated_coefficients[2] * y * y);
+    return (sum <= 1.0f);
+}
+
+__attribute__((ramfunc))
+bool is_inside_region(const input_region_t &region, const uint16_t *const values, uint16_t channel_count) {
+    if ((!region.enabled) || (region.channel_count != channel_count)) {
+        return false;
+    }
+
+    if (region.type == region_rotated_elliptical) {
+        return is_inside_rotated_ellipse(region, values);
+    }
+
+    uint64_t sum = 0;
+    region_ellipse_sum_t ellipse_sum;
+    region_ellipse_sum_clear(ellipse_sum);
+    for (uint16_t i=0; i<channel_count; i++) {
+        const uint32_t offset_squared = region_offset_squared(values[i], region.values[i]);
+
+        bool is_inside;
+        switch (region.type) {
+            case region_rectangular:
+                is_inside = (offset_squared <= region.distances_squared[i]);
+                break;
+            case region_circular:
+                is_inside = region_add_circular_term(sum, offset_squared, region.distances_squared[0]);
+                break;
+            case region_elliptical:
+                is_inside = region_add_elliptical_term(ellipse_sum, offset_squared, region.distances_squared[i], region.coefficients[i]);
+                break;
+            default:
+                is_inside = false;
+                break;
+        }
+
+        if (!is_inside) {
+            return false;
+        }
+    }
+
+    return ((region.type != region_elliptical) || region_ellipse_sum_is_inside(ellipse_sum));
+}
@@ -0,0 +1,63 @@
+/*
+ * input_regions.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// a primary input can hold a small table of regions over its chain (parent, then children)
+// all regions are tested against the same values, and the first one that contains them is the current region
+
+
+#ifndef input_regions_defined
+#define input_regions_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "F28x_Project.h"
+#include "io_controller.h"
+
+
+static const uint16_t max_input_regions = 8;
+static const uint16_t max_region_channels = 4;
+static const uint16_t no_region = 0xFFFF;
+
+typedef enum {
+    region_rectangular,         //each channel, with its own distance
+    region_circular,            //one distance for all channels
+    region_elliptical,          //each channel, with its own distance
+    region_rotated_elliptical,  //two channels only, with an angle
+    region_error                //just an error
+} region_type_t;
+
+typedef struct input_region_t {
+    bool enabled;
+    char name[9];
+    region_type_t type;
+    uint16_t channel_count;     //has to match the chain length
+    uint16_t values[max_region_channels];
+    uint16_t distances[max_region_channels];
+    float32 angle;              //degrees (rotated only)
+
+    //actions
+    io_event_codes_t event_codes;
+    uint64_t met_min_length_tics;
+    uint64_t left_min_length_tics;
+    uint16_t output_number;     //no output if >= the output count
+    uint16_t output_cycles;
+
+    //calculated once the region is set
+    uint32_t distances_squared[max_region_channels];
+    uint64_t coefficients[max_region_channels];    //elliptical only (Q62)
+    float32 rotated_coefficients[3];                //a*x^2 + b*x*y + c*y^2 <= 1
+} input_region_t;
+
+//names
+const char *get_region_type_name(region_type_t region_type);
+region_type_t get_region_type(const char *const name);
+
+//returns the error (or NULL if the region is valid)
+const char *calculate_region_coefficients(input_region_t &region);
+
+//per tic
+bool is_inside_region(const input_region_t &region, const uint16_t *const values, uint16_t channel_count);
+
+#endif
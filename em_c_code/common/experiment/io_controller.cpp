@@ -26,6 +26,8 @@
 #include "limits.h"
 #include "arrays.h"
 #include "serial_link.h"
+#include "spsc_ring_buffer.h"
+#include "flash_sector.h"
 
 
 serial_command_t command_twiddle = {"twiddle_leds", true, 0, NULL, twiddle_leds_ten_times, NULL};
@@ -35,10 +37,21 @@ serial_command_t command_timestamp = {"get_experiment_timestamp", true, 0, NULL,
 serial_command_t command_set_input_settings = {"set_input_settings", true, 0, set_input_settings, NULL, NULL};
 serial_command_t command_get_input_settings = {"get_input_settings", true, 0, get_input_settings, NULL, NULL};
 serial_command_t command_set_input_actions = {"set_input_actions", true, 0, set_input_actions, NULL, NULL};
+serial_command_t command_set_input_region = {"set_input_region", true, 0, set_input_region, NULL, NULL};
+serial_command_t command_clear_input_regions = {"clear_input_regions", true, 0, clear_input_regions, NULL, NULL};
+serial_command_t command_get_input_regions = {"get_input_regions", true, 0, get_input_regions, NULL, NULL};
 serial_command_t command_get_input_history = {"get_input_history", true, 0, get_input_history, NULL, NULL};
+serial_command_t command_set_input_stream = {"set_input_stream", true, 0, set_input_stream, NULL, NULL};
 serial_command_t command_set_output_settings = {"set_output_settings", true, 0, set_output_settings, NULL, NULL};
 serial_command_t command_get_output_settings = {"get_output_settings", true, 0, get_output_settings, NULL, NULL};
 serial_command_t command_set_output_actions = {"set_output_actions", true, 0, set_output_actions, NULL, NULL};
+serial_command_t command_set_input_simulation = {"set_input_simulation", true, 0, set_input_simulation, NULL, NULL};
+serial_command_t command_get_main_loop_timing = {"get_main_loop_timing", true, 0, get_main_loop_timing, NULL, NULL};
+serial_command_t command_begin_configuration = {"begin_configuration", true, 0, NULL, begin_configuration, NULL};
+serial_command_t command_commit_configuration = {"commit_configuration", true, 0, commit_configuration, NULL, NULL};
+serial_command_t command_save_profile = {"save_profile", true, 0, NULL, save_profile, NULL};
+serial_command_t command_load_profile = {"load_profile", true, 0, load_profile, NULL, NULL};
+serial_command_t command_get_profile = {"get_profile", true, 0, NULL, get_profile, NULL};
 
 
 ///internal variables
@@ -61,6 +74,7 @@ static volatile int64_t cpu_uptime_count = 0;     //never reset, used just for u
 static volatile int64_t cla_uptime_count = 0;     //must be updated manually
 static volatile int64_t cumulative_error = 0;
 static volatile int64_t previous_cumulative_error = 0;
+static volatile uint32_t previous_over_budget_count = 0;
 
 //cla variables
 #pragma DATA_SECTION("cla_data");
@@ -79,13 +93,86 @@ static volatile uint32_t twiddle_cpu_tics = 500;   //default to 500ms
 static volatile uint16_t input_count = 0;
 static volatile uint16_t output_count = 0;
 static volatile experimental_input *experimental_inputs_;
+static input_hot_state_t input_hot_state;   //per-tic state of the inputs (not volatile)
+static volatile bool is_input_skipping_enabled = true;   //inputs without a change or a due deadline aren't evaluated
 static volatile experimental_output *experimental_outputs_;
 
+//simulated input values (replace the hardware get functions when enabled)
+static volatile bool is_simulating_inputs = false;
+static volatile uint16_t digital_in_count = 0;
+static volatile uint16_t *simulated_input_values_;
+
 //input history printing
 static volatile bool should_print_input_history_bool = false;
 static volatile bool *should_print_input_history_array;
 static volatile uint16_t desired_history_count = 0;
 static volatile uint64_t desired_history_tics = 1; //must be 1 or greater
+static volatile bool is_history_delta_varint = false;  //analog histories as delta varints (when requested), otherwise 16bit base64
+
+//input streaming (the isr appends each sample frame, and the main loop drains whole frames as chunks)
+static const uint16_t stream_max_inputs = 8;
+static const uint16_t stream_max_chunk_values = 256;
+static volatile spsc_ring_buffer<uint16_t, 2048> stream_buffer;
+static volatile bool stream_enabled = false;
+static volatile uint16_t stream_input_numbers[stream_max_inputs];
+static volatile uint16_t stream_input_count = 0;
+static volatile uint16_t stream_chunk_frames = 1;
+static volatile uint64_t stream_decimation = 1;     //must be 1 or greater
+static volatile uint64_t stream_decimation_tic = 0;
+static volatile uint32_t stream_sequence = 0;
+static volatile uint32_t stream_dropped_frames = 0;
+
+//staged configuration (each settings command is parsed and checked as it arrives, then all are applied together)
+typedef enum {
+    staged_input_settings,
+    staged_output_settings
+} staged_settings_type_t;
+
+typedef struct staged_settings_t {
+    staged_settings_type_t type;
+    union {
+        input_settings_t input;
+        output_settings_t output;
+    } settings;
+} staged_settings_t;
+
+static const uint16_t staged_settings_max_count = 32;
+static staged_settings_t *staged_settings_ = NULL;     //only allocated while staging
+static uint16_t staged_settings_count = 0;
+
+//saved profile (the complete configuration, as settings that recreate it), also kept in flash for the next boot
+static bool has_profile = false;
+static uint32_t profile_hash = 0;
+static input_settings_t *profile_inputs_ = NULL;
+static output_settings_t *profile_outputs_ = NULL;
+
+//regions are only set on a few inputs, so the profile keeps a list of them (each with its input and region number)
+static const uint16_t max_profile_regions = 16;
+
+typedef struct profile_region_t {
+    uint16_t input_number;
+    uint16_t region_number;
+    input_region_t region;
+} profile_region_t;
+
+static profile_region_t *profile_regions_ = NULL;
+static uint16_t profile_region_count = 0;
+
+//in flash: the header, then the profile arrays as they are in memory (each starting on a flash block)
+static const uint16_t profile_magic = 0xE3F1;
+static const uint16_t profile_layout_version = 2;   //change along with input_settings_t, output_settings_t, or input_region_t
+
+typedef struct profile_header_t {
+    uint16_t magic;
+    uint16_t layout_version;
+    uint16_t input_count;
+    uint16_t input_settings_words;
+    uint16_t output_count;
+    uint16_t output_settings_words;
+    uint16_t region_count;
+    uint16_t region_words;
+    uint32_t hash;
+} profile_header_t;
 
 //status messages
 static volatile bool status_messages_enabled = false;
@@ -93,6 +180,19 @@ static volatile bool status_messages_full = true;
 
 //internal functions
 void print_input_history();
+void stream_input_samples();
+uint32_t get_simulated_digital_snapshot();
+uint16_t get_simulated_analog_in(uint16_t channel);
+staged_settings_t *next_staged_settings();
+uint32_t hash_profile_words(uint32_t hash, const void *const words, uint16_t word_count);
+uint32_t get_current_profile(bool save);
+uint16_t count_current_regions();
+bool create_profile_arrays();
+bool apply_profile(float32 &apply_us);
+void get_flash_profile_offsets(uint16_t &inputs_offset, uint16_t &outputs_offset, uint16_t &regions_offset, uint16_t &end_offset);
+bool write_profile_to_flash();
+bool read_profile_from_flash();
+void load_profile_from_flash();
 
 
 
@@ -103,6 +203,13 @@ void check_cumulative_error() {
     previous_cumulative_error = cumulative_error;
 }
 
+__attribute__((ramfunc))
+void check_over_budget() {
+    const uint32_t over_budget_count = cpu_timer0.cycle_stats().over_budget_count();
+    delay_printf_json_objects(2, json_string("error", "main loop exceeded the timer period"), json_uint32("over budget count", over_budget_count));
+    previous_over_budget_count = over_budget_count;
+}
+
 //no delays, waits, or non-delayed printing
 //takes about 1.5 or 19us (depending on which tic)
 __attribute__((ramfunc))
@@ -115,6 +222,11 @@ void io_controller_main_loop() {
         check_cumulative_error();
     }
 
+    //same for any tics that ran longer than the timer period
+    if ((cpu_timer0.cycle_stats().over_budget_count() != previous_over_budget_count) && is_even_second) {
+        check_over_budget();
+    }
+
     //calculate if even second
     is_even_second = (second_count_tic == 0);
 
@@ -128,10 +240,23 @@ void io_controller_main_loop() {
     if (experiment_io_count_tic == 0) {
 
         // **** INPUTS ****
+        //this is the only place the experiment_tic is set for all
+        input_hot_state.clock_tic = experiment_tic;
+
+        //all digital inputs are read, and compared against their targets, at once
+        input_hot_state.digital_values = is_simulating_inputs ? get_simulated_digital_snapshot() : get_digital_in_snapshot();
+        input_hot_state.digital_targets_met = ~(input_hot_state.digital_values ^ input_hot_state.digital_polarities);
+
+        //without skipping, every input is evaluated every tic
+        if (!is_input_skipping_enabled) {
+            for (uint16_t i=0; i<input_count; i++) {
+                input_hot_state.is_dirty[i] = true;
+            }
+        }
+
         //update all current values first (so that parent and child values don't have to be checked again)
         for (uint16_t i=0; i<input_count; i++) {
-            //this is also the only place the experiment_tic is set for all
-            experimental_inputs_[i].update_current_value(experiment_tic);
+            experimental_inputs_[i].update_current_value();
         }
         //process each input (update values must have been done first)
         for (uint16_t i=0; i<input_count; i++) {
@@ -143,6 +268,11 @@ void io_controller_main_loop() {
             experimental_outputs_[i].process_actions(experiment_tic);
         }
 
+        // **** STREAM INPUTS ****
+        if (stream_enabled) {
+            stream_input_samples();
+        }
+
         // **** PRINT HISTORY ****
         if (should_print_input_history_bool && ((experiment_tic % desired_history_tics) == 0)) {
             print_input_history();
@@ -159,6 +289,12 @@ void io_controller_main_loop() {
             delay_printf_json_status("experiment clock was reset");
             need_to_reset_experiment_clock = false;
             experiment_tic = 0;
+
+            //the deadlines were for the old clock
+            for (uint16_t i=0; i<input_count; i++) {
+                input_hot_state.is_dirty[i] = true;
+                input_hot_state.candidate_region_tics[i] = 0;
+            }
         }
 
         //increment tic
@@ -238,7 +374,7 @@ bool init_io_controller() {
     cpu_timer0.set_callback(io_controller_main_loop);
 
     //enable the cla task
-    enable_cla_task(2, reinterpret_cast<uint16_t>(&cla_task2_cla_uptime), CLA_TRIG_TINT0);
+    enable_cla_task(2, &cla_task2_cla_uptime, CLA_TRIG_TINT0);
 
 
     //init io
@@ -260,26 +396,56 @@ bool init_io_controller() {
     //input_count = db_board.digital_in_count() + db_board.analog_in_count();
     uint16_t temp_digital_in_count = get_digital_in_count();
     input_count = temp_digital_in_count + get_analog_in_count();
+    digital_in_count = temp_digital_in_count;
+
+    //allocate the simulated values (only used once simulation is enabled)
+    simulated_input_values_ = create_array_of<uint16_t>(input_count, "simulated_input_values_");
+    if (simulated_input_values_ == NULL) {return false;}
 
     //allocate and set up for the history
     //use heap array, since size is unknown
     should_print_input_history_array = create_array_of<bool>(input_count, "should_print_input_history_array");
     if (should_print_input_history_array == NULL) {return false;}
 
+    //allocate the per-tic state, as parallel arrays
+    //use heap arrays, since size is unknown
+    input_hot_state.clock_tic = 0;
+    input_hot_state.digital_values = 0;
+    input_hot_state.digital_polarities = 0;
+    input_hot_state.digital_targets_met = 0;
+    input_hot_state.current_values = create_array_of<uint16_t>(input_count, "input_current_values");
+    input_hot_state.target_met = create_array_of<bool>(input_count, "input_target_met");
+    input_hot_state.in_timeout = create_array_of<bool>(input_count, "input_in_timeout");
+    input_hot_state.conditionally_met_tics = create_array_of<uint64_t>(input_count, "input_conditionally_met_tics");
+    input_hot_state.conditionally_left_tics = create_array_of<uint64_t>(input_count, "input_conditionally_left_tics");
+    input_hot_state.timeout_start_tics = create_array_of<uint64_t>(input_count, "input_timeout_start_tics");
+    input_hot_state.is_dirty = create_array_of<bool>(input_count, "input_is_dirty");
+    input_hot_state.wake_tics = create_array_of<uint64_t>(input_count, "input_wake_tics");
+    input_hot_state.current_regions = create_array_of<uint16_t>(input_count, "input_current_regions");
+    input_hot_state.candidate_regions = create_array_of<uint16_t>(input_count, "input_candidate_regions");
+    input_hot_state.candidate_region_tics = create_array_of<uint64_t>(input_count, "input_candidate_region_tics");
+    if ((input_hot_state.current_values == NULL) || (input_hot_state.target_met == NULL) || (input_hot_state.in_timeout == NULL) ||
+        (input_hot_state.conditionally_met_tics == NULL) || (input_hot_state.conditionally_left_tics == NULL) || (input_hot_state.timeout_start_tics == NULL) ||
+        (input_hot_state.is_dirty == NULL) || (input_hot_state.wake_tics == NULL) || (input_hot_state.current_regions == NULL) ||
+        (input_hot_state.candidate_regions == NULL) || (input_hot_state.candidate_region_tics == NULL)) {
+        return false;
+    }
+
     //allocate the inputs (no longer has a default init)
     experimental_inputs_ = create_array_of<experimental_input>(input_count, "experimental_inputs_");
     if (experimental_inputs_ == NULL) {return false;}
 
     for (uint16_t input_number=0; input_number<input_count; input_number++) {
         should_print_input_history_array[input_number] = false;
+        simulated_input_values_[input_number] = 0;
 
         const bool is_digital = (input_number < temp_digital_in_count);
         const uint16_t channel = (input_number % temp_digital_in_count);
 
         if (is_digital) {
-            experimental_inputs_[input_number].init(input_number, channel, is_digital, get_digital_in, experimental_inputs_, experimental_outputs_);
+            experimental_inputs_[input_number].init(input_number, channel, is_digital, get_digital_in, experimental_inputs_, experimental_outputs_, &input_hot_state);
         } else {
-            experimental_inputs_[input_number].init(input_number, channel, is_digital, get_analog_in, experimental_inputs_, experimental_outputs_);
+            experimental_inputs_[input_number].init(input_number, channel, is_digital, get_analog_in, experimental_inputs_, experimental_outputs_, &input_hot_state);
         }
     }
 
@@ -290,10 +456,24 @@ bool init_io_controller() {
     add_serial_command(&command_set_input_settings);
     add_serial_command(&command_get_input_settings);
     add_serial_command(&command_set_input_actions);
+    add_serial_command(&command_set_input_region);
+    add_serial_command(&command_clear_input_regions);
+    add_serial_command(&command_get_input_regions);
     add_serial_command(&command_get_input_history);
+    add_serial_command(&command_set_input_stream);
     add_serial_command(&command_set_output_settings);
     add_serial_command(&command_get_output_settings);
     add_serial_command(&command_set_output_actions);
+    add_serial_command(&command_set_input_simulation);
+    add_serial_command(&command_get_main_loop_timing);
+    add_serial_command(&command_begin_configuration);
+    add_serial_command(&command_commit_configuration);
+    add_serial_command(&command_save_profile);
+    add_serial_command(&command_load_profile);
+    add_serial_command(&command_get_profile);
+
+    //start with the saved profile, so the host doesn't have to configure it again
+    load_profile_from_flash();
 
     has_init_io_controller = true;
     delay_printf_json_status("initialized io controller");
@@ -307,6 +487,16 @@ float64 get_uptime_seconds() {
     return static_cast<float64>(cpu_uptime_count)/static_cast<float64>(main_loop_freq);
 }
 
+__attribute__((ramfunc))
+int64_t get_uptime_count() {
+    //64bit read, so protect it from the timer isr
+    const uint16_t interrupt_settings = __disable_interrupts();
+    const int64_t uptime_count = cpu_uptime_count;
+    __restore_interrupts(interrupt_settings);
+
+    return uptime_count;
+}
+
 void print_uptime() {
     const float64 uptime_f = get_uptime_seconds();
     delay_printf_json_objects(1, json_float64("uptime", uptime_f, 4));
@@ -361,6 +551,7 @@ void clear_all_should_print_flags() {
     //reset all flags back to "off"
     should_print_input_history_bool = false;
     desired_history_tics = 1;
+    is_history_delta_varint = false;
     for (uint16_t i=0; i<input_count; i++) {
         should_print_input_history_array[i] = false;
     }
@@ -448,7 +639,7 @@ void print_input_history() {
 
             //try to copy the history
             json_object_t json_history_obj;
-            experimental_inputs_[i].get_copy_of_history(actual_history_count, json_history_obj);
+            experimental_inputs_[i].get_copy_of_history(actual_history_count, json_history_obj, is_history_delta_varint);
 
             //if it succeeds or not, print what was copied
             json_parent_obj.parameter_name = experimental_inputs_[i].get_name();
@@ -467,6 +658,61 @@ void print_input_history() {
 }
 
 
+//called from the isr, once the current values have been updated
+__attribute__((ramfunc))
+void stream_input_samples() {
+    stream_decimation_tic++;
+    if (stream_decimation_tic < stream_decimation) {return;}
+    stream_decimation_tic = 0;
+
+    uint16_t frame[stream_max_inputs];
+    for (uint16_t i=0; i<stream_input_count; i++) {
+        frame[i] = experimental_inputs_[stream_input_numbers[i]].get_current_value();
+    }
+
+    //whole frames only, so the stream never gets out of step
+    if (!stream_buffer.write(stream_input_count, frame)) {
+        stream_dropped_frames++;
+    }
+}
+
+//called from the main loop, drains whole frames as sequence-numbered chunks
+__attribute__((ramfunc))
+void process_input_stream() {
+    if (!stream_enabled) {return;}
+
+    const uint16_t frame_count = stream_buffer.in_use() / stream_input_count;
+    if (frame_count < stream_chunk_frames) {return;}
+
+    //leave the frames in the stream buffer until the print queue has room (for telemetry)
+    if (get_delayed_json_class_available(print_class_telemetry) < 16) {return;}
+
+    const uint16_t value_count = stream_chunk_frames * stream_input_count;
+    uint16_t *const values = create_array_of<uint16_t>(value_count, "stream_values");
+    if (values == NULL) {return;}
+
+    stream_buffer.read(value_count, values);
+
+    //the array is freed once it has been printed
+    json_object_t json_values_obj = json_uint16_array("values", value_count, values);
+    json_values_obj.combined_params.free_array_after_print = true;
+
+    const bool is_queued = delay_printf_json_class_objects(print_class_telemetry, print_coalesce_none, 5, json_parent("input_stream", 4),
+                                                           json_uint32("sequence", stream_sequence),
+                                                           json_uint32("dropped", stream_dropped_frames),
+                                                           json_uint16("input_count", stream_input_count),
+                                                           json_values_obj);
+
+    //the frames were already read out (and the array freed), so they are dropped like any the isr couldn't write
+    if (!is_queued) {
+        const uint16_t interrupt_settings = __disable_interrupts();
+        stream_dropped_frames += stream_chunk_frames;
+        __restore_interrupts(interrupt_settings);
+        return;
+    }
+    stream_sequence++;
+}
+
 void reset_experiment_clock(const json_t *const json_root) {
 
     json_element code_e("event_code", t_uint16);
@@ -485,6 +731,10 @@ void reset_experiment_clock(const json_t *const json_root) {
     __restore_interrupts(interrupt_settings);
 }
 
+void enable_input_skipping(bool enable) {
+    is_input_skipping_enabled = enable;
+}
+
 void get_experiment_timestamp() {
     delay_printf_json_objects(1, json_timestamp(experiment_tic));
 }
@@ -497,6 +747,7 @@ void get_input_history(const json_t *const json_root) {
     json_element numbers_e("input_numbers", t_uint16, true, true);
     json_element count_e("count", t_uint16);
     json_element tics_e("tics", t_uint64);
+    json_element delta_varint_e("delta_varint", t_bool);
     json_element stop_e("stop", t_bool);
 
     stop_e.set_with_json(json_root, false);
@@ -505,7 +756,7 @@ void get_input_history(const json_t *const json_root) {
         return;
     }
 
-    const uint16_t found_count = set_elements_with_json(json_root, 3, &numbers_e, &count_e, &tics_e);
+    const uint16_t found_count = set_elements_with_json(json_root, 4, &numbers_e, &count_e, &tics_e, &delta_varint_e);
     if (found_count == 0) {
         return;
     }
@@ -576,6 +827,9 @@ void get_input_history(const json_t *const json_root) {
             } else {
                 desired_history_tics = 1;
             }
+
+            //analog histories as delta varints only when asked for (the host must decode them)
+            is_history_delta_varint = (delta_varint_e.count_found() > 0) && delta_varint_e.value().bool_;
         }
 
         //tag time
@@ -586,6 +840,65 @@ void get_input_history(const json_t *const json_root) {
     }
 }
 
+void set_input_stream(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    json_element numbers_e("input_numbers", t_uint16, false, true);
+    json_element decimation_e("decimation", t_uint64);
+    json_element chunk_e("chunk_frames", t_uint16);
+    json_element stop_e("stop", t_bool);
+
+    //stop before anything else, so the isr is no longer writing
+    stream_enabled = false;
+
+    stop_e.set_with_json(json_root, false);
+    if ((stop_e.count_found() > 0) && (stop_e.value().bool_)) {
+        delay_printf_json_status("input stream stopped");
+        return;
+    }
+
+    set_elements_with_json(json_root, 3, &numbers_e, &decimation_e, &chunk_e);
+    if ((numbers_e.count_found() == 0) || (numbers_e.count_found() > stream_max_inputs)) {
+        delay_printf_json_objects(2, json_string("error", "input_numbers must have between 1 and max_count"), json_uint16("max_count", stream_max_inputs));
+        return;
+    }
+
+    const uint16_t *const numbers_to_stream = numbers_e.get_uint16_array();
+    for (uint16_t i=0; i<numbers_e.count_found(); i++) {
+        if (numbers_to_stream[i] >= input_count) {
+            delay_printf_json_error("input_number is too high");
+            return;
+        }
+        stream_input_numbers[i] = numbers_to_stream[i];
+    }
+    stream_input_count = numbers_e.count_found();
+
+    //default to the largest chunk
+    const uint16_t max_chunk_frames = stream_max_chunk_values / stream_input_count;
+    stream_chunk_frames = max_chunk_frames;
+    if ((chunk_e.count_found() > 0) && (chunk_e.value().uint16_ > 0) && (chunk_e.value().uint16_ <= max_chunk_frames)) {
+        stream_chunk_frames = chunk_e.value().uint16_;
+    }
+
+    //minimum of 1
+    stream_decimation = 1;
+    if ((decimation_e.count_found() > 0) && (decimation_e.value().uint64_ > 1)) {
+        stream_decimation = decimation_e.value().uint64_;
+    }
+
+    //start from an empty stream (the isr is not writing, and this is the consumer)
+    stream_buffer.reset();
+    stream_sequence = 0;
+    stream_dropped_frames = 0;
+    stream_decimation_tic = stream_decimation - 1;  //first sample on the next tic
+
+    delay_printf_json_objects(4, json_parent("input_stream_started", 3),
+                                 json_uint16("input_count", stream_input_count),
+                                 json_uint16("chunk_frames", stream_chunk_frames),
+                                 json_uint64("decimation", stream_decimation));
+    stream_enabled = true;
+}
+
 void set_status_messages(const json_t *const json_root) {
     json_element enable_e("enable", t_bool, true);
     json_element minimal_e("minimal", t_bool);
@@ -658,7 +971,18 @@ void set_input_settings(const json_t *const json_root) {
     uint16_t number;
     if (is_valid_input_number(json_root, number)) {
         //delay_printf_json_status("here4");
-        experimental_inputs_[number].set_settings(json_root);
+        if (staged_settings_ == NULL) {
+            experimental_inputs_[number].set_settings(json_root);
+            return;
+        }
+
+        //otherwise, hold it until the commit
+        staged_settings_t *const staged_settings = next_staged_settings();
+        if ((staged_settings != NULL) && experimental_inputs_[number].parse_settings(json_root, staged_settings->settings.input, true)) {
+            staged_settings->type = staged_input_settings;
+            staged_settings_count++;
+            delay_printf_json_objects(1, json_uint16("staged_count", staged_settings_count));
+        }
     }
 }
 
@@ -667,8 +991,109 @@ void set_output_settings(const json_t *const json_root) {
 
     uint16_t number;
     if (is_valid_ouput_number(json_root, number)) {
-        experimental_outputs_[number].set_settings(json_root);
+        if (staged_settings_ == NULL) {
+            experimental_outputs_[number].set_settings(json_root);
+            return;
+        }
+
+        //otherwise, hold it until the commit
+        staged_settings_t *const staged_settings = next_staged_settings();
+        if ((staged_settings != NULL) && experimental_outputs_[number].parse_settings(json_root, staged_settings->settings.output, true)) {
+            staged_settings->type = staged_output_settings;
+            staged_settings_count++;
+            delay_printf_json_objects(1, json_uint16("staged_count", staged_settings_count));
+        }
+    }
+}
+
+staged_settings_t *next_staged_settings() {
+    if (staged_settings_count >= staged_settings_max_count) {
+        delay_printf_json_objects(2, json_string("error", "staged configuration is full"), json_uint16("max_count", staged_settings_max_count));
+        return NULL;
+    }
+
+    return &staged_settings_[staged_settings_count];
+}
+
+//from now on, input and output settings are only checked and held (until committed)
+void begin_configuration() {
+    if (db_board.is_not_enabled()) {return;}
+
+    //beginning again discards anything already staged
+    if (staged_settings_ == NULL) {
+        //use heap array, since it is only needed while staging
+        staged_settings_ = create_array_of<staged_settings_t>(staged_settings_max_count, "staged_settings_");
+        if (staged_settings_ == NULL) {return;}
     }
+    staged_settings_count = 0;
+
+    delay_printf_json_status("configuration staging started");
+}
+
+//applies everything staged (in order) between two tics, so the isr never sees a partial configuration
+void commit_configuration(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    json_element discard_e("discard", t_bool);
+    discard_e.set_with_json(json_root, false);
+
+    if (staged_settings_ == NULL) {
+        delay_printf_json_error("no configuration is being staged");
+        return;
+    }
+
+    bool apply = !((discard_e.count_found() > 0) && discard_e.value().bool_);
+    tic_toc apply_timing;
+
+    //allocate everything first (history buffers), so nothing but field copies are done with interrupts disabled
+    for (uint16_t i=0; (i<staged_settings_count) && apply; i++) {
+        staged_settings_t &staged_settings = staged_settings_[i];
+        if (staged_settings.type == staged_input_settings) {
+            if (!experimental_inputs_[staged_settings.settings.input.number].prepare_settings(staged_settings.settings.input)) {
+                apply = false;
+            }
+        }
+    }
+
+    if (apply) {
+        //disable and store the interrupt state
+        const uint16_t interrupt_settings = __disable_interrupts();
+        apply_timing.tic();
+
+        for (uint16_t i=0; i<staged_settings_count; i++) {
+            staged_settings_t &staged_settings = staged_settings_[i];
+            if (staged_settings.type == staged_input_settings) {
+                experimental_inputs_[staged_settings.settings.input.number].apply_settings(staged_settings.settings.input);
+            } else {
+                experimental_outputs_[staged_settings.settings.output.number].apply_settings(staged_settings.settings.output);
+            }
+        }
+
+        apply_timing.toc();
+
+        //restore the interrupt state
+        __restore_interrupts(interrupt_settings);
+    }
+
+    //then free what was replaced (or not used), and print
+    for (uint16_t i=0; i<staged_settings_count; i++) {
+        staged_settings_t &staged_settings = staged_settings_[i];
+        if (staged_settings.type == staged_input_settings) {
+            staged_settings.settings.input.print_settings = (staged_settings.settings.input.print_settings && apply);
+            experimental_inputs_[staged_settings.settings.input.number].finish_settings(staged_settings.settings.input);
+        } else if (apply) {
+            experimental_outputs_[staged_settings.settings.output.number].finish_settings(staged_settings.settings.output);
+        }
+    }
+
+    delay_printf_json_objects(4, json_parent("configuration", 3),
+                                 json_bool("applied", apply),
+                                 json_uint16("settings_count", staged_settings_count),
+                                 json_float32("apply_us", apply_timing.us(), 2));
+
+    delete_array(staged_settings_);
+    staged_settings_ = NULL;
+    staged_settings_count = 0;
 }
 
 void get_input_settings(const json_t *const json_root) {
@@ -700,6 +1125,33 @@ void set_input_actions(const json_t *const json_root) {
     }
 }
 
+void set_input_region(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    uint16_t number;
+    if (is_valid_input_number(json_root, number)) {
+        experimental_inputs_[number].set_region(json_root);
+    }
+}
+
+void clear_input_regions(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    uint16_t number;
+    if (is_valid_input_number(json_root, number)) {
+        experimental_inputs_[number].clear_regions();
+    }
+}
+
+void get_input_regions(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    uint16_t number;
+    if (is_valid_input_number(json_root, number)) {
+        experimental_inputs_[number].print_regions();
+    }
+}
+
 void set_output_actions(const json_t *const json_root) {
     if (db_board.is_not_enabled()) {return;}
 
@@ -709,6 +1161,446 @@ void set_output_actions(const json_t *const json_root) {
     }
 }
 
+//fnv-1a, one 16-bit word at a time
+uint32_t hash_profile_words(uint32_t hash, const void *const words, uint16_t word_count) {
+    const uint16_t *const words_ptr = reinterpret_cast<const uint16_t *>(words);
+
+    for (uint16_t i=0; i<word_count; i++) {
+        hash ^= words_ptr[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+//hash of the current configuration (and optionally, save it as the profile)
+uint32_t get_current_profile(bool save) {
+    input_settings_t input_settings;
+    output_settings_t output_settings;
+    uint32_t hash = 2166136261UL;
+
+    const uint16_t counts[2] = {input_count, output_count};
+    hash = hash_profile_words(hash, counts, 2);
+
+    //each one is read between tics (since the isr can change a few, like output_enabled)
+    for (uint16_t i=0; i<input_count; i++) {
+        const uint16_t interrupt_settings = __disable_interrupts();
+        experimental_inputs_[i].get_current_settings(input_settings);
+        __restore_interrupts(interrupt_settings);
+
+        hash = hash_profile_words(hash, &input_settings, words_of<input_settings_t>(1));
+        if (save) {
+            profile_inputs_[i] = input_settings;
+        }
+    }
+
+    for (uint16_t i=0; i<output_count; i++) {
+        const uint16_t interrupt_settings = __disable_interrupts();
+        experimental_outputs_[i].get_current_settings(output_settings);
+        __restore_interrupts(interrupt_settings);
+
+        hash = hash_profile_words(hash, &output_settings, words_of<output_settings_t>(1));
+        if (save) {
+            profile_outputs_[i] = output_settings;
+        }
+    }
+
+    //then every region that is set, as the records that are saved (only commands change them, so no need to disable interrupts)
+    profile_region_t profile_region;
+    uint16_t region_count = 0;
+    for (uint16_t i=0; i<input_count; i++) {
+        for (uint16_t region_i=0; region_i<max_input_regions; region_i++) {
+            memset(&profile_region, 0, sizeof(profile_region_t));
+            if (!experimental_inputs_[i].get_region_setting(region_i, profile_region.region)) {continue;}
+            profile_region.input_number = i;
+            profile_region.region_number = region_i;
+
+            hash = hash_profile_words(hash, &profile_region, words_of<profile_region_t>(1));
+            if (save && (region_count < max_profile_regions)) {
+                profile_regions_[region_count] = profile_region;
+            }
+            region_count++;
+        }
+    }
+    if (save) {
+        profile_region_count = region_count;
+    }
+
+    return hash;
+}
+
+uint16_t count_current_regions() {
+    input_region_t region;
+    uint16_t region_count = 0;
+    for (uint16_t i=0; i<input_count; i++) {
+        for (uint16_t region_i=0; region_i<max_input_regions; region_i++) {
+            if (experimental_inputs_[i].get_region_setting(region_i, region)) {
+                region_count++;
+            }
+        }
+    }
+    return region_count;
+}
+
+//use heap arrays (only once a profile is actually saved or loaded)
+bool create_profile_arrays() {
+    if (profile_inputs_ == NULL) {
+        profile_inputs_ = create_array_of<input_settings_t>(input_count, "profile_inputs_");
+        if (profile_inputs_ == NULL) {return false;}
+    }
+    if (profile_outputs_ == NULL) {
+        profile_outputs_ = create_array_of<output_settings_t>(output_count, "profile_outputs_");
+        if (profile_outputs_ == NULL) {return false;}
+    }
+    if (profile_regions_ == NULL) {
+        profile_regions_ = create_array_of<profile_region_t>(max_profile_regions, "profile_regions_");
+        if (profile_regions_ == NULL) {return false;}
+    }
+    return true;
+}
+
+void save_profile() {
+    if (db_board.is_not_enabled()) {return;}
+    if (!create_profile_arrays()) {return;}
+
+    //checked first, so the profile that was saved before is kept
+    const uint16_t region_count = count_current_regions();
+    if (region_count > max_profile_regions) {
+        delay_printf_json_objects(3, json_string("error", "too many regions to save in the profile"),
+                                     json_uint16("region_count", region_count),
+                                     json_uint16("max_count", max_profile_regions));
+        return;
+    }
+
+    profile_hash = get_current_profile(true);
+    has_profile = true;
+
+    //the erase stalls anything running from flash for tens of ms (the isr runs from ram)
+    const bool is_stored = write_profile_to_flash();
+    if (!is_stored) {
+        delay_printf_json_error("profile could not be stored in flash");
+    }
+
+    delay_printf_json_objects(6, json_parent("profile", 5),
+                                 json_bool("saved", true),
+                                 json_bool("stored", is_stored),
+                                 json_uint32("hash", profile_hash),
+                                 json_uint16("setting_count", input_count + output_count),
+                                 json_uint16("region_count", profile_region_count));
+}
+
+//replaces the whole configuration with the profile, between two tics
+void load_profile(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    json_element hash_e("hash", t_uint32);
+    hash_e.set_with_json(json_root, false);
+
+    if (!has_profile) {
+        delay_printf_json_error("no profile has been saved");
+        return;
+    }
+
+    //the host can make sure it is the profile it expects
+    if ((hash_e.count_found() > 0) && (hash_e.value().uint32_ != profile_hash)) {
+        delay_printf_json_objects(3, json_string("error", "profile hash does not match"),
+                                     json_uint32("hash", profile_hash),
+                                     json_uint32("expected_hash", hash_e.value().uint32_));
+        return;
+    }
+
+    float32 apply_us = 0.0;
+    if (!apply_profile(apply_us)) {
+        delay_printf_json_error("profile could not be loaded");
+        return;
+    }
+
+    delay_printf_json_objects(4, json_parent("profile", 3),
+                                 json_bool("loaded", true),
+                                 json_uint32("hash", profile_hash),
+                                 json_float32("apply_us", apply_us, 2));
+}
+
+//applies the saved profile (only field copies are done with interrupts disabled)
+bool apply_profile(float32 &apply_us) {
+    tic_toc apply_timing;
+
+    //allocate everything first (history buffers)
+    bool apply = true;
+    for (uint16_t i=0; (i<input_count) && apply; i++) {
+        apply = experimental_inputs_[i].prepare_settings(profile_inputs_[i]);
+    }
+    for (uint16_t region_i=0; (region_i<profile_region_count) && apply; region_i++) {
+        apply = experimental_inputs_[profile_regions_[region_i].input_number].prepare_regions();
+    }
+
+    if (apply) {
+        //disable and store the interrupt state
+        const uint16_t interrupt_settings = __disable_interrupts();
+        apply_timing.tic();
+
+        //first, everything but the children (which also removes every current child)
+        for (uint16_t i=0; i<input_count; i++) {
+            const bool child_enabled = profile_inputs_[i].child_enabled;
+            profile_inputs_[i].child_enabled = false;
+            experimental_inputs_[i].apply_settings(profile_inputs_[i]);
+            profile_inputs_[i].child_enabled = child_enabled;
+        }
+
+        //then the children (now that every target is set)
+        input_settings_t child_settings;
+        for (uint16_t i=0; i<input_count; i++) {
+            if (profile_inputs_[i].child_enabled) {
+                memset(&child_settings, 0, sizeof(input_settings_t));
+                child_settings.number = i;
+                child_settings.has_child = true;
+                child_settings.child_enabled = true;
+                child_settings.child_number = profile_inputs_[i].child_number;
+                experimental_inputs_[i].apply_settings(child_settings);
+                if (profile_inputs_[i].apply_error == NULL) {
+                    profile_inputs_[i].apply_error = child_settings.apply_error;
+                }
+            }
+        }
+
+        for (uint16_t i=0; i<output_count; i++) {
+            experimental_outputs_[i].apply_settings(profile_outputs_[i]);
+        }
+
+        //and last, the regions (which replace every current one)
+        for (uint16_t i=0; i<input_count; i++) {
+            experimental_inputs_[i].reset_regions();
+        }
+        for (uint16_t region_i=0; region_i<profile_region_count; region_i++) {
+            const profile_region_t &profile_region = profile_regions_[region_i];
+            experimental_inputs_[profile_region.input_number].apply_region(profile_region.region_number, profile_region.region);
+        }
+
+        apply_timing.toc();
+
+        //restore the interrupt state
+        __restore_interrupts(interrupt_settings);
+    }
+
+    //then free what was replaced (or not used), and print any errors
+    for (uint16_t i=0; i<input_count; i++) {
+        experimental_inputs_[i].finish_settings(profile_inputs_[i]);
+        profile_inputs_[i].apply_error = NULL;
+    }
+
+    apply_us = apply_timing.us();
+    return apply;
+}
+
+//each part starts on a flash block (so each is programmed once)
+void get_flash_profile_offsets(uint16_t &inputs_offset, uint16_t &outputs_offset, uint16_t &regions_offset, uint16_t &end_offset) {
+    const uint16_t align = flash_sector_align_words;
+
+    inputs_offset = ((words_of<profile_header_t>(1) + align - 1) / align) * align;
+    outputs_offset = inputs_offset + (((words_of<input_settings_t>(input_count) + align - 1) / align) * align);
+    regions_offset = outputs_offset + (((words_of<output_settings_t>(output_count) + align - 1) / align) * align);
+    end_offset = regions_offset + words_of<profile_region_t>(profile_region_count);
+}
+
+bool write_profile_to_flash() {
+    uint16_t inputs_offset;
+    uint16_t outputs_offset;
+    uint16_t regions_offset;
+    uint16_t end_offset;
+    get_flash_profile_offsets(inputs_offset, outputs_offset, regions_offset, end_offset);
+    if (end_offset > flash_sector_word_count()) {return false;}
+
+    profile_header_t header;
+    memset(&header, 0, sizeof(profile_header_t));
+    header.magic = profile_magic;
+    header.layout_version = profile_layout_version;
+    header.input_count = input_count;
+    header.input_settings_words = words_of<input_settings_t>(1);
+    header.output_count = output_count;
+    header.output_settings_words = words_of<output_settings_t>(1);
+    header.region_count = profile_region_count;
+    header.region_words = words_of<profile_region_t>(1);
+    header.hash = profile_hash;
+
+    //the header goes last, so a write that stops part way is never loaded
+    return flash_sector_erase() &&
+           flash_sector_write(inputs_offset, profile_inputs_, words_of<input_settings_t>(input_count)) &&
+           flash_sector_write(outputs_offset, profile_outputs_, words_of<output_settings_t>(output_count)) &&
+           ((profile_region_count == 0) || flash_sector_write(regions_offset, profile_regions_, words_of<profile_region_t>(profile_region_count))) &&
+           flash_sector_write(0, &header, words_of<profile_header_t>(1));
+}
+
+//false if nothing usable was saved (an erased sector, or a profile from a different build)
+bool read_profile_from_flash() {
+    profile_header_t header;
+    if (!flash_sector_read(0, &header, words_of<profile_header_t>(1))) {return false;}
+    if (header.magic != profile_magic) {return false;}
+
+    if ((header.layout_version != profile_layout_version) || (header.input_count != input_count) || (header.output_count != output_count) ||
+        (header.input_settings_words != words_of<input_settings_t>(1)) || (header.output_settings_words != words_of<output_settings_t>(1)) ||
+        (header.region_count > max_profile_regions) || (header.region_words != words_of<profile_region_t>(1))) {
+        delay_printf_json_error("saved profile in flash is from a different build");
+        return false;
+    }
+
+    if (!create_profile_arrays()) {return false;}
+    profile_region_count = header.region_count;
+
+    uint16_t inputs_offset;
+    uint16_t outputs_offset;
+    uint16_t regions_offset;
+    uint16_t end_offset;
+    get_flash_profile_offsets(inputs_offset, outputs_offset, regions_offset, end_offset);
+    if ((!flash_sector_read(inputs_offset, profile_inputs_, words_of<input_settings_t>(input_count))) ||
+        (!flash_sector_read(outputs_offset, profile_outputs_, words_of<output_settings_t>(output_count))) ||
+        (!flash_sector_read(regions_offset, profile_regions_, words_of<profile_region_t>(profile_region_count)))) {
+        profile_region_count = 0;
+        return false;
+    }
+
+    //the same words as get_current_profile hashed, so the hash also checks what was read
+    const uint16_t counts[2] = {input_count, output_count};
+    uint32_t hash = hash_profile_words(2166136261UL, counts, 2);
+    hash = hash_profile_words(hash, profile_inputs_, words_of<input_settings_t>(input_count));
+    hash = hash_profile_words(hash, profile_outputs_, words_of<output_settings_t>(output_count));
+    hash = hash_profile_words(hash, profile_regions_, words_of<profile_region_t>(profile_region_count));
+    if (hash != header.hash) {
+        profile_region_count = 0;
+        delay_printf_json_error("saved profile in flash is corrupt");
+        return false;
+    }
+
+    profile_hash = header.hash;
+    has_profile = true;
+    return true;
+}
+
+//at boot (the timer hasn't started yet)
+void load_profile_from_flash() {
+    if (!read_profile_from_flash()) {return;}
+
+    float32 apply_us = 0.0;
+    if (!apply_profile(apply_us)) {
+        delay_printf_json_error("saved profile could not be loaded");
+        return;
+    }
+
+    delay_printf_json_objects(4, json_parent("profile", 3),
+                                 json_bool("loaded", true),
+                                 json_string("from", "flash"),
+                                 json_uint32("hash", profile_hash));
+}
+
+//if current_hash is the same as when the host configured it, there is no need to configure it again
+void get_profile() {
+    if (db_board.is_not_enabled()) {return;}
+
+    const uint32_t current_hash = get_current_profile(false);
+
+    delay_printf_json_objects(4, json_parent("profile", 3),
+                                 json_bool("saved", has_profile),
+                                 json_uint32("hash", profile_hash),
+                                 json_uint32("current_hash", current_hash));
+}
+
+//packed the same as get_digital_in_snapshot
+__attribute__((ramfunc))
+uint32_t get_simulated_digital_snapshot() {
+    uint32_t snapshot = 0;
+    for (uint16_t i=0; i<digital_in_count; i++) {
+        snapshot |= (static_cast<uint32_t>(simulated_input_values_[i] > 0) << i);
+    }
+    return snapshot;
+}
+
+__attribute__((ramfunc))
+uint16_t get_simulated_analog_in(uint16_t channel) {
+    //analog inputs follow the digital inputs
+    return simulated_input_values_[digital_in_count + channel];
+}
+
+//replaces the hardware values with values set over serial
+//allows the experiment logic to be driven (and profiled) deterministically without any signals attached
+void set_input_simulation(const json_t *const json_root) {
+    if (db_board.is_not_enabled()) {return;}
+
+    json_element enable_e("enable", t_bool);
+    json_element numbers_e("input_numbers", t_uint16, false, true);
+    json_element values_e("values", t_uint16, false, true);
+
+    const uint16_t found_count = set_elements_with_json(json_root, 3, &enable_e, &numbers_e, &values_e);
+    if (found_count == 0) {
+        return;
+    }
+
+    //numbers and values must be paired
+    if (numbers_e.count_found() != values_e.count_found()) {
+        delay_printf_json_error("input_numbers and values must have the same count");
+        return;
+    }
+
+    const uint16_t *const numbers = numbers_e.get_uint16_array();
+    const uint16_t *const values = values_e.get_uint16_array();
+    for (uint16_t i=0; i<numbers_e.count_found(); i++) {
+        if (numbers[i] >= input_count) {
+            delay_printf_json_error("input_number is too high");
+            return;
+        }
+    }
+
+    //disable and store the interrupt state
+    const uint16_t interrupt_settings = __disable_interrupts();
+
+    for (uint16_t i=0; i<numbers_e.count_found(); i++) {
+        simulated_input_values_[numbers[i]] = values[i];
+    }
+
+    //swap the get functions only when the state changes
+    if ((enable_e.count_found() > 0) && (enable_e.value().bool_ != is_simulating_inputs)) {
+        is_simulating_inputs = enable_e.value().bool_;
+
+        for (uint16_t i=0; i<input_count; i++) {
+            //digital inputs use the simulated snapshot instead
+            if (!experimental_inputs_[i].is_digital()) {
+                experimental_inputs_[i].set_get_function(is_simulating_inputs ? get_simulated_analog_in : get_analog_in);
+            }
+        }
+    }
+
+    //restore the interrupt state
+    __restore_interrupts(interrupt_settings);
+
+    delay_printf_json_objects(1, json_bool("input_simulation", is_simulating_inputs));
+}
+
+//statistics for every timer0 tic since the last reset (includes the isr overhead)
+void get_main_loop_timing(const json_t *const json_root) {
+    json_element reset_e("reset", t_bool);
+    reset_e.set_with_json(json_root, false);
+
+    const volatile tic_toc_stats &stats = cpu_timer0.cycle_stats();
+
+    //copy everything at once, so that the values are consistent
+    const uint16_t interrupt_settings = __disable_interrupts();
+    const uint32_t count = stats.count();
+    const uint32_t over_budget_count = stats.over_budget_count();
+    const float32 min_us = stats.min_us();
+    const float32 mean_us = stats.mean_us();
+    const float32 p99_us = stats.percentile_us(99);
+    const float32 max_us = stats.max_us();
+    const float32 budget_us = stats.budget_us();
+
+    if ((reset_e.count_found() > 0) && reset_e.value().bool_) {
+        cpu_timer0.reset_cycle_stats();
+        previous_over_budget_count = 0;
+    }
+    __restore_interrupts(interrupt_settings);
+
+    delay_printf_json_objects(8, json_parent("main_loop_timing", 7), json_uint32("count", count), json_float32("min_us", min_us, 2),
+                              json_float32("mean_us", mean_us, 2), json_float32("p99_us", p99_us, 2), json_float32("max_us", max_us, 2),
+                              json_float32("budget_us", budget_us, 2), json_uint32("over_budget_count", over_budget_count));
+}
+
 const char *get_reason_name(reason_t reason_i) {
     const char *ptr;
 
@@ -35,10 +35,17 @@ void start_io_controller();
 void reset_experiment_clock(const json_t *const json_root);
 void get_experiment_timestamp();
 
+//skip evaluating inputs that can't change (off evaluates every input every tic, to compare against)
+void enable_input_skipping(bool enable);
+
 //get uptime information
 float64 get_uptime_seconds();
+int64_t get_uptime_count();
 void print_uptime();
 
+//input streaming (drained from the main loop)
+void process_input_stream();
+
 uint16_t get_io_input_count();
 uint16_t get_io_output_count();
 
@@ -51,12 +58,27 @@ bool is_currently_twiddling_leds();
 
 // **** serial setting functions ****
 void get_input_history(const json_t *const json_root);
+void set_input_stream(const json_t *const json_root);
 void set_input_settings(const json_t *const json_root);
 void set_output_settings(const json_t *const json_root);
 void get_input_settings(const json_t *const json_root);
 void get_output_settings(const json_t *const json_root);
 void set_input_actions(const json_t *const json_root);
+void set_input_region(const json_t *const json_root);
+void clear_input_regions(const json_t *const json_root);
+void get_input_regions(const json_t *const json_root);
 void set_output_actions(const json_t *const json_root);
+void set_input_simulation(const json_t *const json_root);
+void get_main_loop_timing(const json_t *const json_root);
+
+//staged configuration (settings are held until committed, then applied all at once)
+void begin_configuration();
+void commit_configuration(const json_t *const json_root);
+
+//profiles (a saved copy of the whole configuration, with a hash so the host can tell if it needs to configure again)
+void save_profile();
+void load_profile(const json_t *const json_root);
+void get_profile();
 
 const char *get_reason_name(reason_t reason_i);
 
@@ -78,7 +78,7 @@ void init_cla(void) {
 
 }
 
-void enable_cla_task(uint16_t task_number, uint16_t cla_function_addr, uint16_t trigger) {
+void enable_cla_task(uint16_t task_number, cla_task_function_ptr cla_function, uint16_t trigger) {
     if (task_number > cla_task_count) {
         delay_printf_json_error("cla task number is too high");
         return;
@@ -95,7 +95,7 @@ void enable_cla_task(uint16_t task_number, uint16_t cla_function_addr, uint16_t
     }
 
 
-    set_cla_task(task_number, true, cla_function_addr, trigger);
+    set_cla_task(task_number, true, reinterpret_cast<uint16_t>(cla_function), trigger);
     is_cla_task_enabled[task_number - 1] = true;
 }
 void disable_cla_task(uint16_t task_number) {
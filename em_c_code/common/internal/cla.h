@@ -18,8 +18,8 @@ typedef void (*cla_task_function_ptr) (void);
 void init_cla(void);
 
 //enable and disable cla tasks
-//the cla_function_addr must be type cast to uin16_t
-void enable_cla_task(uint16_t task_number, uint16_t cla_function_addr, uint16_t trigger);
+//the cla program space is in the lower 64k, so only 16bits of the function address are used
+void enable_cla_task(uint16_t task_number, cla_task_function_ptr cla_function, uint16_t trigger);
 void disable_cla_task(uint16_t task_number);
 
 
@@ -133,6 +133,7 @@ void cpu_timer::update_cpu_timer_calcs_and_regs() volatile {
     cycle_accumulation_scaled_ = 0;
     count_ = 0;
     timing_.reset();
+    timing_stats_.set_budget_us(static_cast<float32>(1000000.0L / freq_hz_));
 
 
     //scale is used to increase the accuracy of the accumulation check that can be performed
@@ -234,6 +235,7 @@ void cpu_timer::execute_isr_routine() volatile {
 
     //finally, stop the timer
     timing_.toc();
+    timing_stats_.add(timing_.tics());
 }
 
 //isrs
@@ -31,8 +31,11 @@ class cpu_timer {
         bool is_running() volatile const;
         float64 freq_hz() volatile const {return freq_hz_;}
         float32 cycle_us() volatile const;
+        uint32_t cycle_tics() volatile const {return timing_.tics();}
         float32 cycle_max_us() volatile const;
         uint64_t count() volatile const {return count_;}
+        const volatile tic_toc_stats &cycle_stats() volatile const {return timing_stats_;}
+        void reset_cycle_stats() volatile {timing_stats_.reset();}
 
         //this must be public for the isr to work
         void execute_isr_routine() volatile;
@@ -57,6 +60,7 @@ class cpu_timer {
 
         //timing info
         tic_toc timing_;
+        tic_toc_stats timing_stats_;    //budget is the timer period
 
         //methods
         void update_cpu_timer_calcs_and_regs() volatile;
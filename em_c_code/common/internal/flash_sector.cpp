@@ -0,0 +1,128 @@
+/*
+ * flash_sector.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// sector N through the F021 flash api (links F021_API_F2837xD_FPU32.lib, or the F2837xS one)
+// the api and these functions run from ram, since bank 0 can't be read while it is erased or programmed
+// the isr keeps running from ram the whole time, anything it needs from flash waits for the operation
+
+#include "flash_sector.h"
+#include "ti_launchpad.h"
+#include "string.h"
+#ifdef _LAUNCHXL_F28379D
+#include "F021_F2837xD_C28x.h"
+#else
+#include "F021_F2837xS_C28x.h"
+#endif
+
+
+//sector N (8k words), the last sector of bank 0
+static const uint32_t sector_start_address = 0x0BE000;
+static const uint16_t sector_word_count = 0x2000;
+static const uint32_t flash_cpu_mhz = 200;
+
+static bool has_init_flash_api = false;
+
+
+//internal functions
+static bool init_flash_api();
+static bool wait_for_flash();
+
+
+uint16_t flash_sector_word_count() {
+    return sector_word_count;
+}
+
+__attribute__((ramfunc))
+bool flash_sector_erase() {
+    if (!init_flash_api()) {return false;}
+
+    EALLOW;
+#ifdef _LAUNCHXL_F28379D
+    SeizeFlashPump();
+#endif
+
+    Fapi_issueAsyncCommandWithAddress(Fapi_EraseSector, reinterpret_cast<uint32 *>(sector_start_address));
+    bool is_erased = wait_for_flash();
+
+    //erase stops at the first failing word, so make sure
+    Fapi_FlashStatusWordType status_word;
+    if (is_erased) {
+        is_erased = (Fapi_doBlankCheck(reinterpret_cast<uint32 *>(sector_start_address), sector_word_count / 2, &status_word) == Fapi_Status_Success);
+    }
+
+#ifdef _LAUNCHXL_F28379D
+    ReleaseFlashPump();
+#endif
+    EDIS;
+
+    return is_erased;
+}
+
+__attribute__((ramfunc))
+bool flash_sector_write(uint16_t word_offset, const void *const words, uint16_t word_count) {
+    if ((word_offset % flash_sector_align_words) != 0) {return false;}
+    if ((word_offset > sector_word_count) || (word_count > (sector_word_count - word_offset))) {return false;}
+    if (!init_flash_api()) {return false;}
+
+    const uint16_t *const words_ptr = reinterpret_cast<const uint16_t *>(words);
+    uint16_t block[flash_sector_align_words];
+    bool is_written = true;
+
+    EALLOW;
+#ifdef _LAUNCHXL_F28379D
+    SeizeFlashPump();
+#endif
+
+    //128 bits at a time (a partial last block is padded with erased words)
+    for (uint16_t block_i=0; (block_i<word_count) && is_written; block_i+=flash_sector_align_words) {
+        for (uint16_t i=0; i<flash_sector_align_words; i++) {
+            block[i] = ((block_i + i) < word_count) ? words_ptr[block_i + i] : 0xFFFF;
+        }
+
+        uint32 *const address = reinterpret_cast<uint32 *>(sector_start_address + word_offset + block_i);
+        Fapi_issueProgrammingCommand(address, block, flash_sector_align_words, NULL, 0, Fapi_AutoEccGeneration);
+        is_written = wait_for_flash();
+
+        //read it back
+        for (uint16_t i=0; (i<flash_sector_align_words) && is_written; i++) {
+            is_written = (reinterpret_cast<const volatile uint16_t *>(address)[i] == block[i]);
+        }
+    }
+
+#ifdef _LAUNCHXL_F28379D
+    ReleaseFlashPump();
+#endif
+    EDIS;
+
+    return is_written;
+}
+
+bool flash_sector_read(uint16_t word_offset, void *const words, uint16_t word_count) {
+    if ((word_offset > sector_word_count) || (word_count > (sector_word_count - word_offset))) {return false;}
+
+    //flash is memory mapped
+    memcpy(words, reinterpret_cast<const void *>(sector_start_address + word_offset), word_count);
+    return true;
+}
+
+
+__attribute__((ramfunc))
+static bool init_flash_api() {
+    if (has_init_flash_api) {return true;}
+
+    EALLOW;
+    const bool is_ready = (Fapi_initializeAPI(F021_CPU0_BASE_ADDRESS, flash_cpu_mhz) == Fapi_Status_Success) &&
+                          (Fapi_setActiveFlashBank(Fapi_FlashBank0) == Fapi_Status_Success);
+    EDIS;
+
+    has_init_flash_api = is_ready;
+    return is_ready;
+}
+
+__attribute__((ramfunc))
+static bool wait_for_flash() {
+    while (Fapi_checkFsmForReady() != Fapi_Status_FsmReady) {}
+    return (Fapi_getFsmStatus() == 0);
+}
@@ -0,0 +1,25 @@
+/*
+ * flash_sector.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// one flash sector kept for data that survives a reboot (sector N, past everything the linker places)
+// the host build stands in a file for it (host/sim/sim_flash.cpp)
+
+#ifndef flash_sector_defined
+#define flash_sector_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//a write starts on a 128-bit boundary, and each boundary is programmed once per erase (the ecc covers all of it)
+static const uint16_t flash_sector_align_words = 8;
+
+uint16_t flash_sector_word_count();
+bool flash_sector_erase();      //every word back to 0xFFFF (takes tens of ms, while flash can't be read)
+bool flash_sector_write(uint16_t word_offset, const void *const words, uint16_t word_count);
+bool flash_sector_read(uint16_t word_offset, void *const words, uint16_t word_count);
+
+
+#endif
@@ -7,7 +7,7 @@
 
 #include "scia.h"
 #include "F28x_Project.h"
-#include "ring_buffer.h"
+#include "spsc_ring_buffer.h"
 #include "math.h"
 #include "stdarg.h"
 #include "ti_launchpad.h"
@@ -15,6 +15,10 @@
 #include "printf_json_delayed.h"
 #include "misc.h"
 #include "tic_toc.h"
+#include "string.h"
+#include "arrays.h"
+#include "fpu_vector.h"
+#include "limits.h"
 
 
 //internal variables
@@ -24,21 +28,41 @@ static volatile bool scia_initialized = false;
 
 //RX
 static const uint16_t sci_rx_isr_on_count = 1;          //call interrupt (need at least 10 spaces to handle a max of 100us in the main interrupt)
-static const uint16_t sci_rx_ring_buffer_len = 1000;    //about 92bits could be transferred in the max 1ms main interrupt, so about 5.5X that
-static volatile ring_buffer sci_rx_ring_buffer;
+static const uint16_t sci_rx_ring_buffer_len = 1024;    //about 92bits could be transferred in the max 1ms main interrupt, so about 5.5X that (power of two)
+static volatile spsc_ring_buffer<uint16_t, sci_rx_ring_buffer_len> sci_rx_ring_buffer;  //producer is the rx isr
 __interrupt void sci_rx_isr(void);
 static volatile bool had_scia_rx_buffer_full_error = false;
 static volatile bool had_scia_rx_buffer_overflow_error = false;
 
 //TX
 static const uint16_t sci_tx_isr_on_count = 12;         //call interrupt (need at least 10 spaces to handle a max of 100us in the main interrupt)
-static const uint16_t sci_tx_ring_buffer_len = 1000;    //32x the size of the FIFO buffer (no rhyme or reason)
-static volatile ring_buffer sci_tx_ring_buffer;
+static const uint16_t sci_tx_ring_buffer_len = 1024;    //64x the size of the FIFO buffer (no rhyme or reason, but a power of two)
+static volatile spsc_ring_buffer<uint16_t, sci_tx_ring_buffer_len> sci_tx_ring_buffer;  //consumer is the tx isr
 __interrupt void sci_tx_isr(void);
 
+//TX staging (a whole message is rendered here, so the ring buffer is only written once)
+static const uint16_t sci_tx_staging_len = 256;         //most messages fit, larger ones are sent in multiple spans
+static uint16_t *sci_tx_staging_buffer = NULL;
+static uint16_t sci_tx_staging_count = 0;
+static bool sci_tx_staging_on = false;
+static bool sci_tx_staging_enabled = true;
+#if CHAR_BIT == 8
+static const uint16_t host_string_chunk_length = 64;
+#endif
+
+//link statistics
+static volatile uint32_t sci_rx_byte_count = 0;
+static volatile uint32_t sci_tx_byte_count = 0;
+static volatile uint32_t sci_tx_full_wait_count = 0;
+static volatile uint16_t sci_tx_max_in_use = 0;
+static volatile uint32_t sci_tx_staged_span_count = 0;
+
 
 //send character directly to buffer (only internal)
 void scia_send_char(uint16_t a_char);
+void scia_send_span(const uint16_t *span, uint16_t span_length);
+void scia_send_staged();
+void printf_words(const uint16_t *const words, uint16_t word_count);
 
 
 //this init makes assumptions about the clock rate, will need to be a parameter
@@ -46,16 +70,6 @@ void scia_send_char(uint16_t a_char);
 bool init_scia(uint32_t baud_rate, const sci_gpio_t sci_gpio_settings) {
     if (scia_initialized) {return true;}
 
-    //Create the ring buffers (always)
-    if (!sci_rx_ring_buffer.init_alloc(sci_rx_ring_buffer_len)) {
-        return false;
-    }
-
-    if (!sci_tx_ring_buffer.init_alloc(sci_tx_ring_buffer_len)) {
-        return false;
-    }
-
-
     //Turn on the appropriate pins and mux
     GPIO_SetupPinMux(sci_gpio_settings.rx_gpio, GPIO_MUX_CPU1, sci_gpio_settings.rx_mux);
     GPIO_SetupPinOptions(sci_gpio_settings.rx_gpio, GPIO_INPUT, GPIO_ASYNC);
@@ -132,6 +146,9 @@ bool init_scia(uint32_t baud_rate, const sci_gpio_t sci_gpio_settings) {
     SciaRegs.SCIFFTX.bit.TXFIFORESET = 1;
     SciaRegs.SCIFFRX.bit.RXFIFORESET = 1;
 
+    //without the staging buffer, every char goes directly to the ring buffer
+    sci_tx_staging_buffer = create_array_of<uint16_t>(sci_tx_staging_len, "sci_tx_staging_buffer");
+
     //enable the pie interrupts
     PieCtrlRegs.PIEIER9.bit.INTx1 = 1;  // PIE Group 9, INT1   RX
     PieCtrlRegs.PIEIER9.bit.INTx2 = 1;  // PIE Group 9, INT2   TX
@@ -160,16 +177,13 @@ __interrupt void sci_rx_isr(void) {
 
         //will overwrite if necessary
         const uint16_t incoming_byte = SciaRegs.SCIRXBUF.bit.SAR;
+        sci_rx_byte_count++;
 
-        //if the buffer is full
-        if (sci_rx_ring_buffer.is_full()) {
+        //if the buffer is full, the byte is dropped
+        if (!sci_rx_ring_buffer.write(incoming_byte)) {
             delay_printf_json_error("scia rx buffer full");
             had_scia_rx_buffer_full_error = true;
         }
-
-        if (!sci_rx_ring_buffer.write(incoming_byte)) {
-            lockup_cpu();
-        }
     }
 
     //clear the flag and acknowledge the isr
@@ -181,17 +195,21 @@ __interrupt void sci_rx_isr(void) {
 
 __attribute__((ramfunc))
 __interrupt void sci_tx_isr(void) {
-    uint16_t outgoing_byte;
+    uint16_t outgoing_bytes[sci_fifo_buffer_max];
 
-    //if the FIFO isn't full, and there are bytes in the ring buffer, copy them to the FIFO buffer
-    while ((SciaRegs.SCIFFTX.bit.TXFFST < sci_fifo_buffer_max) && (!sci_tx_ring_buffer.is_empty())) {
+    //copy whatever fits in the FIFO buffer from the ring buffer, as a single span
+    uint16_t span_count = sci_fifo_buffer_max - SciaRegs.SCIFFTX.bit.TXFFST;
+    const uint16_t in_use = sci_tx_ring_buffer.in_use();
+    if (span_count > in_use) {
+        span_count = in_use;
+    }
+    sci_tx_ring_buffer.read(span_count, outgoing_bytes);
 
-        //copy bytes to the FIFO buffer
-        if (sci_tx_ring_buffer.read(outgoing_byte)) {
-            SciaRegs.SCITXBUF.bit.TXDT = outgoing_byte;
-            if (outgoing_byte == '}') {
-                debug_timestamps.scia_tx_close_bracket = CPU_TIMESTAMP;
-            }
+    //copy bytes to the FIFO buffer
+    for (uint16_t byte_i=0; byte_i<span_count; byte_i++) {
+        SciaRegs.SCITXBUF.bit.TXDT = outgoing_bytes[byte_i];
+        if (outgoing_bytes[byte_i] == '}') {
+            debug_timestamps.scia_tx_close_bracket = CPU_TIMESTAMP;
         }
     }
 
@@ -211,16 +229,25 @@ void scia_send_char(uint16_t send_char) {
     if (send_char > 255) {return;}  // only allow 7bit char
 
     //if the ring buffer is full, wait, then add
-    while (sci_tx_ring_buffer.is_full()) {
+    if (sci_tx_ring_buffer.is_full()) {
+        sci_tx_full_wait_count++;
+        while (sci_tx_ring_buffer.is_full()) {
+        }
     }
 
     if (!sci_tx_ring_buffer.write(send_char)) {
         lockup_cpu();
     }
+    sci_tx_byte_count++;
 
-    //wait until there is at least one buffer full, or a return has been issued,
+    const uint16_t in_use = sci_tx_ring_buffer.in_use();
+    if (in_use > sci_tx_max_in_use) {
+        sci_tx_max_in_use = in_use;
+    }
+
+    //wait until there is at least one buffer full, or a return (or a binary frame's delimiter) has been issued,
     //then, allow interrupt to start again
-    if ((sci_tx_ring_buffer.in_use() > sci_fifo_buffer_max) || (send_char == 10)) {
+    if ((in_use > sci_fifo_buffer_max) || (send_char == 10) || (send_char == 0)) {
         //allow the interrupt to start again
         SciaRegs.SCIFFTX.bit.TXFFINTCLR = 1;    // Clear SCI Interrupt flag
     }
@@ -239,21 +266,172 @@ void wait_until_scia_tx_buffer_is_empty() {
     }
 }
 
+scia_statistics_t get_scia_statistics(bool reset) {
+    scia_statistics_t statistics;
+
+    //rx count is updated inside the isr
+    const uint16_t interrupt_settings = __disable_interrupts();
+    statistics.rx_bytes = sci_rx_byte_count;
+    statistics.tx_bytes = sci_tx_byte_count;
+    statistics.tx_full_waits = sci_tx_full_wait_count;
+    statistics.tx_max_in_use = sci_tx_max_in_use;
+    statistics.tx_buffer_length = sci_tx_ring_buffer_len;
+    statistics.tx_staged_spans = sci_tx_staged_span_count;
+
+    if (reset) {
+        sci_rx_byte_count = 0;
+        sci_tx_byte_count = 0;
+        sci_tx_full_wait_count = 0;
+        sci_tx_max_in_use = 0;
+        sci_tx_staged_span_count = 0;
+    }
+    __restore_interrupts(interrupt_settings);
+
+    return statistics;
+}
+
+//chars are 16bits, so the string can be copied directly in spans
+__attribute__((ramfunc))
+void scia_send_span(const uint16_t *span, uint16_t span_length) {
+    while (span_length > 0) {
+
+        //wait for at least some space
+        uint16_t span_count = sci_tx_ring_buffer.available();
+        if (span_count == 0) {
+            sci_tx_full_wait_count++;
+            while (span_count == 0) {
+                span_count = sci_tx_ring_buffer.available();
+            }
+        }
+        if (span_count > span_length) {
+            span_count = span_length;
+        }
+
+        if (!sci_tx_ring_buffer.write(span_count, span)) {
+            lockup_cpu();
+        }
+        sci_tx_byte_count += span_count;
+        span += span_count;
+        span_length -= span_count;
+
+        const uint16_t in_use = sci_tx_ring_buffer.in_use();
+        if (in_use > sci_tx_max_in_use) {
+            sci_tx_max_in_use = in_use;
+        }
+
+        //allow the interrupt to start again (a span is already a batch, and may end a short message)
+        SciaRegs.SCIFFTX.bit.TXFFINTCLR = 1;    // Clear SCI Interrupt flag
+    }
+}
+
+__attribute__((ramfunc))
+void scia_send_staged() {
+    if (sci_tx_staging_count == 0) {return;}
+
+    scia_send_span(sci_tx_staging_buffer, sci_tx_staging_count);
+    sci_tx_staging_count = 0;
+    sci_tx_staged_span_count++;
+}
+
+//a begin while already staging just continues the same span
+__attribute__((ramfunc))
+void scia_tx_stage_begin() {
+    if ((sci_tx_staging_buffer == NULL) || (!sci_tx_staging_enabled)) {return;}
+    sci_tx_staging_on = true;
+}
+
+//always stops staging, so anything printed after goes directly (and stays in order)
+__attribute__((ramfunc))
+void scia_tx_stage_commit() {
+    if (!sci_tx_staging_on) {return;}
+
+    sci_tx_staging_on = false;
+    scia_send_staged();
+
+    //the message is complete, so allow the interrupt to start again
+    SciaRegs.SCIFFTX.bit.TXFFINTCLR = 1;    // Clear SCI Interrupt flag
+}
+
+//the buffer is kept, so it can be turned back on
+void scia_tx_enable_staging(bool enable) {
+    scia_tx_stage_commit();
+    sci_tx_staging_enabled = enable;
+}
+
 __attribute__((ramfunc))
 void printf_string(const char *const string) {
-    for (char *c = const_cast<char*>(string); (*c) != 0; c++) {
-        scia_send_char(static_cast<uint16_t>(*c));
+#if CHAR_BIT == 8
+    //the host has 8-bit chars, so they are widened to words a chunk at a time
+    uint16_t words[host_string_chunk_length];
+    const char *remaining = string;
+    uint16_t remaining_count = static_cast<uint16_t>(strlen(string));
+
+    while (remaining_count > 0) {
+        uint16_t chunk_count = host_string_chunk_length;
+        if (chunk_count > remaining_count) {
+            chunk_count = remaining_count;
+        }
+        for (uint16_t i=0; i<chunk_count; i++) {
+            words[i] = static_cast<uint8_t>(remaining[i]);
+        }
+
+        printf_words(words, chunk_count);
+        remaining += chunk_count;
+        remaining_count -= chunk_count;
+    }
+#else
+    //a char is already a 16-bit word
+    printf_words(reinterpret_cast<const uint16_t *>(string), static_cast<uint16_t>(strlen(string)));
+#endif
+}
+
+__attribute__((ramfunc))
+void printf_words(const uint16_t *const words, uint16_t word_count) {
+    const uint16_t *remaining = words;
+    uint16_t remaining_count = word_count;
+
+    if (!sci_tx_staging_on) {
+        scia_send_span(remaining, remaining_count);
+        return;
+    }
+
+    //fill the staging buffer, and send it each time it is full
+    while (remaining_count > 0) {
+        if (sci_tx_staging_count == sci_tx_staging_len) {
+            scia_send_staged();
+        }
+
+        uint16_t span_count = sci_tx_staging_len - sci_tx_staging_count;
+        if (span_count > remaining_count) {
+            span_count = remaining_count;
+        }
+
+        memcpy_fast(&sci_tx_staging_buffer[sci_tx_staging_count], remaining, span_count);
+        sci_tx_staging_count += span_count;
+        remaining += span_count;
+        remaining_count -= span_count;
     }
 }
 
 __attribute__((ramfunc))
 void printf_char(uint16_t c) {
-    scia_send_char(c);
+    if (!sci_tx_staging_on) {
+        scia_send_char(c);
+        return;
+    }
+
+    if (c > 255) {return;}  // same as scia_send_char
+
+    if (sci_tx_staging_count == sci_tx_staging_len) {
+        scia_send_staged();
+    }
+    sci_tx_staging_buffer[sci_tx_staging_count] = c;
+    sci_tx_staging_count++;
 }
 
 __attribute__((ramfunc))
 void printf_return() {
     //CR+LF to be compatible with windows
-    scia_send_char(13);
-    scia_send_char(10);
+    printf_char(13);
+    printf_char(10);
 }
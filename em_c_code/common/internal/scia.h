@@ -14,6 +14,16 @@
 #include "sci.h"
 
 
+typedef struct scia_statistics_t {
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;
+    uint32_t tx_full_waits;     //chars that had to wait for space in the tx ring buffer
+    uint16_t tx_max_in_use;     //high-water mark of the tx ring buffer
+    uint16_t tx_buffer_length;
+    uint32_t tx_staged_spans;   //staged messages (or parts of a message) copied to the tx ring buffer at once
+} scia_statistics_t;
+
+
 //init
 bool init_scia(uint32_t baud_rate, const sci_gpio_t sci_gpio_settings);
 
@@ -22,10 +32,16 @@ void printf_char(uint16_t c);
 void printf_return();
 void printf_string(const char *const string);
 
+//staging (main loop only), everything printed between begin and commit is copied to the tx ring buffer as one span
+void scia_tx_stage_begin();
+void scia_tx_stage_commit();
+void scia_tx_enable_staging(bool enable);   //on by default (off sends every char directly, to compare against)
+
 //receive buffer
 bool scia_rx_buffer_read(uint16_t &rx_buffer_byte);
 
 //buffer info
 void wait_until_scia_tx_buffer_is_empty();
+scia_statistics_t get_scia_statistics(bool reset);
 
 #endif
@@ -17,23 +17,36 @@
 #include "cpu_timers.h"
 
 
+//internal variables
+static const json_template_t *uptime_template = NULL;
+static const json_template_t *status_tic_toc_template = NULL;
+
+
+//the templates are optional (without them, the messages are printed normally)
+bool init_status_messages() {
+    uptime_template = create_json_template(1, json_float64("uptime", 0, 4));
+    status_tic_toc_template = create_json_template(1, json_float32_array("tic_toc main_current, main_max, analog_in", 3, NULL, false, 2));
+
+    return ((uptime_template != NULL) && (status_tic_toc_template != NULL));
+}
+
 __attribute__((ramfunc))
 void print_uptime_only() {
-    delay_printf_json_objects(1, json_float64("uptime", get_uptime_seconds(), 4));
+    delay_printf_json_template(uptime_template, print_class_telemetry, print_coalesce_uptime, 1, json_float64("uptime", get_uptime_seconds(), 4));
 }
 
 __attribute__((ramfunc))
 void print_full_status_message() {
 
     //uptime
-    delay_printf_json_objects(1, json_float64("uptime", get_uptime_seconds(), 4));
+    delay_printf_json_template(uptime_template, print_class_telemetry, print_coalesce_uptime, 1, json_float64("uptime", get_uptime_seconds(), 4));
 
     //print out the cycles
     float status_tic_toc_in_us[3];
     status_tic_toc_in_us[0] = cpu_timer0.cycle_us(); //get_time_sensitive_cycle_count_us();
     status_tic_toc_in_us[1] = cpu_timer0.cycle_max_us(); //get_time_sensitive_cycle_count_max_us();
     status_tic_toc_in_us[2] = analog_in_cla_task_length_in_us();
-    delay_printf_json_objects(1, json_float32_array("tic_toc main_current, main_max, analog_in", 3, status_tic_toc_in_us, true, 2));
+    delay_printf_json_template(status_tic_toc_template, print_class_telemetry, print_coalesce_status_tic_toc, 1, json_float32_array("tic_toc main_current, main_max, analog_in", 3, status_tic_toc_in_us, true, 2));
 
     //print current values
     printf_digital_in_values();
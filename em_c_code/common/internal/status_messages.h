@@ -13,6 +13,7 @@
 
 
 //status messages
+bool init_status_messages();
 void print_full_status_message();
 void print_uptime_only();
 
@@ -452,4 +452,100 @@ float32 tic_toc::max_us() volatile const {
 #endif
 }
 
+
+
+tic_toc_stats::tic_toc_stats() {
+    budget_tics_ = 0;
+    bin_width_tics_ = 1;
+    reset();
+}
+
+__attribute__((ramfunc))
+void tic_toc_stats::add(uint32_t tics) volatile {
+    if (tics < min_tics_) {
+        min_tics_ = tics;
+    }
+    if (tics > max_tics_) {
+        max_tics_ = tics;
+    }
+    sum_tics_ += tics;
+    count_++;
+
+    //the last bin is everything at or over the budget
+    if (tics >= budget_tics_) {
+        over_budget_count_++;
+        bins_[tic_toc_stats_bins - 1]++;
+    } else {
+        bins_[tics / bin_width_tics_]++;
+    }
+}
+
+void tic_toc_stats::reset() volatile {
+    min_tics_ = 0xFFFFFFFFUL;
+    max_tics_ = 0;
+    sum_tics_ = 0;
+    count_ = 0;
+    over_budget_count_ = 0;
+    for (uint16_t i=0; i<tic_toc_stats_bins; i++) {
+        bins_[i] = 0;
+    }
+}
+
+void tic_toc_stats::set_budget_us(float32 budget_us) volatile {
+#ifdef _LAUNCHXL_F28379D
+    budget_tics_ = static_cast<uint32_t>(budget_us / cpu_ts_tics_us_per_div);
+#else
+    budget_tics_ = static_cast<uint32_t>(budget_us / cpu_hs_us_per_div);
+#endif
+
+    //all but the last bin cover the budget
+    bin_width_tics_ = (budget_tics_ / (tic_toc_stats_bins - 1)) + 1;
+    reset();
+}
+
+float32 tic_toc_stats::tics_in_us(uint32_t tics) volatile const {
+#ifdef _LAUNCHXL_F28379D
+    return cpu_ts_tics_us_per_div * static_cast<float32>(tics);
+#else
+    return cpu_hs_us_per_div * static_cast<float32>(tics);
+#endif
+}
+
+float32 tic_toc_stats::min_us() volatile const {
+    if (count_ == 0) {return 0.0f;}
+    return tics_in_us(min_tics_);
+}
+
+float32 tic_toc_stats::mean_us() volatile const {
+    if (count_ == 0) {return 0.0f;}
+    return tics_in_us(1) * static_cast<float32>(static_cast<float64>(sum_tics_) / static_cast<float64>(count_));
+}
+
+float32 tic_toc_stats::max_us() volatile const {
+    return tics_in_us(max_tics_);
+}
+
+float32 tic_toc_stats::budget_us() volatile const {
+    return tics_in_us(budget_tics_);
+}
+
+//upper edge of the bin that contains the percentile (so it is never underestimated)
+float32 tic_toc_stats::percentile_us(uint16_t percent) volatile const {
+    if (count_ == 0) {return 0.0f;}
+
+    const uint64_t needed_count = (static_cast<uint64_t>(count_) * percent + 99) / 100;
+    uint64_t cumulative_count = 0;
+    for (uint16_t i=0; i<(tic_toc_stats_bins - 1); i++) {
+        cumulative_count += bins_[i];
+        if (cumulative_count >= needed_count) {
+            //cannot be above the actual max
+            const uint32_t upper_tics = (i + 1) * bin_width_tics_;
+            return tics_in_us((upper_tics < max_tics_) ? upper_tics : max_tics_);
+        }
+    }
+
+    //otherwise, it is in the over budget bin
+    return tics_in_us(max_tics_);
+}
+
 #pragma diag_default 1463
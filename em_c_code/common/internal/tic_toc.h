@@ -42,6 +42,39 @@ class tic_toc {
 };
 
 
+//fixed histogram, so that a percentile can be estimated without storing every tic
+static const uint16_t tic_toc_stats_bins = 64;
+
+//accumulates the tics from a tic_toc against a budget (last bin holds everything over budget)
+class tic_toc_stats {
+    public:
+        tic_toc_stats();
+        void add(uint32_t tics) volatile;
+        void reset() volatile;
+        void set_budget_us(float32 budget_us) volatile;
+
+        uint32_t count() volatile const {return count_;}
+        uint32_t over_budget_count() volatile const {return over_budget_count_;}
+        float32 min_us() volatile const;
+        float32 mean_us() volatile const;
+        float32 max_us() volatile const;
+        float32 percentile_us(uint16_t percent) volatile const;
+        float32 budget_us() volatile const;
+
+    private:
+        uint32_t min_tics_;
+        uint32_t max_tics_;
+        uint64_t sum_tics_;
+        uint32_t count_;
+        uint32_t over_budget_count_;
+        uint32_t budget_tics_;
+        uint32_t bin_width_tics_;
+        uint32_t bins_[tic_toc_stats_bins];
+
+        float32 tics_in_us(uint32_t tics) volatile const;
+};
+
+
 //timestamp define
 #ifdef _LAUNCHXL_F28379D
     //the free-running 64bit counter only exists of the 79D
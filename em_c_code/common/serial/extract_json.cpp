@@ -18,12 +18,66 @@
 #include "printf_json.h"
 
 
+//scratch arena for everything extracted from a command (reset after each command, so nothing is freed)
+static const uint16_t element_arena_length = 2048;  //enough for a full command of 16bit values
+static uint16_t *element_arena = NULL;
+static uint16_t element_arena_used = 0;
+static uint16_t element_arena_max_used = 0;
+static uint32_t element_arena_failures = 0;
+
 //internal functions
 bool set_pointer_with_json_object(const char* const value, const void *const value_ptr, uint16_t index, value_type_t value_type);
 bool store_value_for_value_type(const char* const value, const value_type_t value_type, value_union_t &value_union);
 bool types_are_compatible(value_type_t value_type, jsonType_t json_type);
 const json_t* get_json_property(const json_t *const obj, char const* const property);
 
+bool init_json_element_arena() {
+    if (element_arena != NULL) {return true;}
+
+    element_arena = create_array_of<uint16_t>(element_arena_length, "element_arena");
+    return (element_arena != NULL);
+}
+
+//bump allocation, kept even for the 32 and 64bit types
+__attribute__((ramfunc))
+void *json_element_arena_alloc(uint16_t word_count) {
+    const uint16_t even_word_count = (word_count + 1) & 0xFFFE;
+
+    if ((element_arena == NULL) || (even_word_count > (element_arena_length - element_arena_used))) {
+        element_arena_failures++;
+        delay_printf_json_objects(2, json_string("error", "not enough space in the element arena"), json_uint16("needed", even_word_count));
+        return NULL;
+    }
+
+    void *const ptr = &element_arena[element_arena_used];
+    element_arena_used += even_word_count;
+
+    if (element_arena_used > element_arena_max_used) {
+        element_arena_max_used = element_arena_used;
+    }
+
+    return ptr;
+}
+
+__attribute__((ramfunc))
+void reset_json_element_arena() {
+    element_arena_used = 0;
+}
+
+json_element_arena_statistics_t get_json_element_arena_statistics(bool reset) {
+    json_element_arena_statistics_t statistics;
+    statistics.length = element_arena_length;
+    statistics.max_used = element_arena_max_used;
+    statistics.failures = element_arena_failures;
+
+    if (reset) {
+        element_arena_max_used = 0;
+        element_arena_failures = 0;
+    }
+
+    return statistics;
+}
+
 //cannot be ramfunc as these are created before the code runs (in experimental_input)
 json_element::json_element(const char *const property_name, value_type_t value_type, bool is_required, bool force_array_creation) {
 
@@ -41,8 +95,7 @@ json_element::json_element(const char *const property_name, value_type_t value_t
 
 //don't make ramfunc, just in case
 json_element::~json_element() {
-    //delete array, if not null
-    delete_array(array_ptr_);
+    //array is in the arena, so just forget it
     array_ptr_ = NULL;
 }
 
@@ -51,8 +104,7 @@ void json_element::reset() {
     //reset all non-set parameters
     //property_name, value_type_t value_type, bool is_required
 
-    //delete array, if not null
-    delete_array(array_ptr_);
+    //array is in the arena, so just forget it
     array_ptr_ = NULL;
 
     count_found_ = 0;
@@ -136,16 +188,15 @@ bool json_element::set_with_json(const json_t *const json_root, bool print_if_mi
 
             //create equivalent array and check it
             const uint16_t multiplier = array_size_multiplier_for_value_type(requirements_.value_type);
-            const uint64_t equivalent_length = static_cast<uint64_t>(count)*static_cast<uint64_t>(multiplier);
-            const uint64_t max_length = get_max_heap_free() - 2; //subtract 2 for padding
-            if (equivalent_length > max_length) {
+            const uint32_t equivalent_length = static_cast<uint32_t>(count)*static_cast<uint32_t>(multiplier);
+            if (equivalent_length > element_arena_length) {
                 delay_printf_json_error("not enough space to allocate extracted array");
                 json_property_ = NULL;
                 return false;
             }
 
-            //use heap array, since size is unknown
-            array_ptr_ = create_array_of<uint16_t>(static_cast<uint16_t>(equivalent_length), "array_ptr_");
+            //use the arena, since size is unknown
+            array_ptr_ = reinterpret_cast<uint16_t *>(json_element_arena_alloc(static_cast<uint16_t>(equivalent_length)));
             if (array_ptr_ == NULL) {
                 json_property_ = NULL;
                 return false;
@@ -165,7 +216,6 @@ bool json_element::set_with_json(const json_t *const json_root, bool print_if_mi
                                                           json_string("expected", value_type_name(requirements_.value_type)),
                                                           json_string("received", temp_property_ptr->u.value));
                     json_property_ = NULL;
-                    delete_array(array_ptr_);
                     array_ptr_ = NULL;
                     return false;
                 }
@@ -261,9 +311,10 @@ uint16_t set_elements_with_json(const json_t *const json_root, uint16_t element_
     //copy pointers to array of pointers
     va_start(element_list, element_count);
 
-    //use heap array, since size is unknown
-    json_element **const temp_element_array = create_array_of<json_element *>(element_count, "temp_element_array");
+    //use the arena, since size is unknown
+    json_element **const temp_element_array = reinterpret_cast<json_element **>(json_element_arena_alloc(words_of<json_element *>(element_count)));
     if (temp_element_array == NULL) {
+        va_end(element_list);
         return 0;
     }
 
@@ -277,8 +328,6 @@ uint16_t set_elements_with_json(const json_t *const json_root, uint16_t element_
     //now, fill the elements from the json objects
     const uint16_t filled_count = fill_element_array_with_json(json_root, element_count, temp_element_array);
 
-    delete_array(temp_element_array);
-
     return filled_count;
 }
 
@@ -300,8 +349,7 @@ uint16_t fill_element_array_with_json(const json_t *const json_root, uint16_t el
 
         delayed_json_t delayed_json_object;
         delayed_json_object.object_count = total_count;
-        //use heap array, since size is unknown
-        delayed_json_object.objects = create_array_of<json_object_t>(total_count, "printf_objects");
+        delayed_json_object.objects = create_delayed_json_objects(total_count);
         if (delayed_json_object.objects == NULL) {
             return 0;
         }
@@ -347,8 +395,8 @@ uint16_t fill_element_array_with_json(const json_t *const json_root, uint16_t el
     //next, check for any extra parameters not asked for
     const json_t *current_json_property = json_root;
 
-    //use heap array, since size is unknown
-    bool *const still_not_found = create_array_of<bool>(element_count, "still_not_found");
+    //use the arena, since size is unknown
+    bool *const still_not_found = reinterpret_cast<bool *>(json_element_arena_alloc(words_of<bool>(element_count)));
     if (still_not_found == NULL) {
         return 0;
     }
@@ -390,8 +438,6 @@ uint16_t fill_element_array_with_json(const json_t *const json_root, uint16_t el
         current_json_property = current_json_property->sibling;
     }
 
-    delete_array(still_not_found);
-
     //if not all required elements were found, then exit with error
     if (!found_required_elements) {
         return 0;
@@ -13,6 +13,12 @@
 #include "stdbool.h"
 #include "printf_json_types.h"
 
+typedef struct json_element_arena_statistics_t {
+    uint16_t length;
+    uint16_t max_used;  //high-water mark (the largest command footprint)
+    uint32_t failures;
+} json_element_arena_statistics_t;
+
 typedef struct requirements_t {
     value_type_t value_type : 6;
     bool is_required        : 1;
@@ -62,16 +68,25 @@ class json_element {
         uint16_t count_found_;          //1byte  //found count (0 = not found)
 
         //everything else is set by json object
-        uint16_t *array_ptr_;       //2bytes //array is stored as equivalent uint16_t, malloced if at least one value is found
+        uint16_t *array_ptr_;       //2bytes //array is stored as equivalent uint16_t, in the arena if at least one value is found
         value_union_t value_;       //4byte  //first or only value
 };
 
+//scratch arena for all extracted arrays (reset after each command)
+bool init_json_element_arena();
+void *json_element_arena_alloc(uint16_t word_count);
+void reset_json_element_arena();
+json_element_arena_statistics_t get_json_element_arena_statistics(bool reset);
+
 //work with several elements
 uint16_t set_elements_with_json(const json_t *const json_root, uint16_t element_count, ...);
 uint16_t fill_element_array_with_json(const json_t *const json_root, uint16_t element_count, json_element **const element_array);
 
 bool has_help_element(const json_t *const json_root);
 
+//first of the siblings with the name (or NULL)
+const json_t* get_json_property(const json_t *const obj, char const* const property);
+
 void test_extraction();
 
 #endif
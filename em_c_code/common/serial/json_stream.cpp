@@ -0,0 +1,394 @@
+/*
+ * json_stream.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "json_stream.h"
+#include "string.h"
+
+
+//internal functions (same rules as tiny_json)
+__attribute__((ramfunc))
+static bool is_blank(char c) {
+    return ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\f'));
+}
+
+__attribute__((ramfunc))
+static bool is_digit(char c) {
+    return ((c >= '0') && (c <= '9'));
+}
+
+__attribute__((ramfunc))
+static bool is_hex_digit(char c) {
+    return (is_digit(c) || ((c >= 'A') && (c <= 'F')) || ((c >= 'a') && (c <= 'f')));
+}
+
+__attribute__((ramfunc))
+static bool is_end_of_primitive(char c) {
+    return ((c == ',') || (c == '}') || (c == ']') || is_blank(c));
+}
+
+__attribute__((ramfunc))
+static char escape_char(char c) {
+    switch (c) {
+        case '\"': return '\"';
+        case '\\': return '\\';
+        case '/':  return '/';
+        case 'b':  return '\b';
+        case 'f':  return '\f';
+        case 'n':  return '\n';
+        case 'r':  return '\r';
+        case 't':  return '\t';
+        default:   return '\0';
+    }
+}
+
+//checks a complete (null terminated) number, and sets the type
+__attribute__((ramfunc))
+static bool check_number(const char *const number, jsonType_t &type) {
+    const char *c = number;
+
+    if (*c == '-') {c++;}
+    if (!is_digit(*c)) {return false;}
+
+    //no leading zeros
+    if (*c != '0') {
+        while (is_digit(*c)) {c++;}
+    } else {
+        c++;
+        if (is_digit(*c)) {return false;}
+    }
+    type = JSON_INTEGER;
+
+    if (*c == '.') {
+        c++;
+        if (!is_digit(*c)) {return false;}
+        while (is_digit(*c)) {c++;}
+        type = JSON_REAL;
+    }
+
+    if ((*c == 'e') || (*c == 'E')) {
+        c++;
+        if ((*c == '-') || (*c == '+')) {c++;}
+        if (!is_digit(*c)) {return false;}
+        while (is_digit(*c)) {c++;}
+        type = JSON_REAL;
+    }
+
+    if (*c != '\0') {return false;}
+
+    //integers must fit in an int64
+    if (type == JSON_INTEGER) {
+        const bool negative = (number[0] == '-');
+        const char *const threshold = negative ? "-9223372036854775808" : "9223372036854775807";
+        const uint16_t max_digits = strlen(threshold);
+        const uint16_t length = c - number;
+
+        if (length > max_digits) {return false;}
+        if ((length == max_digits) && (strcmp(threshold, number) < 0)) {return false;}
+    }
+
+    return true;
+}
+
+
+void json_stream_parser::init(char *const buffer, uint16_t buffer_length, json_t *const pool, uint16_t pool_length) {
+    buffer_ = buffer;
+    buffer_length_ = buffer_length;
+    pool_ = pool;
+    pool_length_ = pool_length;
+    reset();
+}
+
+__attribute__((ramfunc))
+void json_stream_parser::reset() {
+    buffer_i_ = 0;
+    pool_i_ = 0;
+    state_ = js_start;
+    is_name_ = false;
+    unicode_count_ = 0;
+    literal_ = NULL;
+    literal_i_ = 0;
+    current_ = NULL;
+    depth_ = 0;
+}
+
+__attribute__((ramfunc))
+const json_t *json_stream_parser::root() const {
+    if (state_ != js_done) {
+        return NULL;
+    }
+    return &pool_[0];
+}
+
+__attribute__((ramfunc))
+bool json_stream_parser::set_error() {
+    state_ = js_error;
+    return false;
+}
+
+__attribute__((ramfunc))
+bool json_stream_parser::store(char c) {
+    if (buffer_i_ >= buffer_length_) {
+        return set_error();
+    }
+
+    buffer_[buffer_i_] = c;
+    buffer_i_++;
+    return true;
+}
+
+__attribute__((ramfunc))
+json_t *json_stream_parser::new_child() {
+    if (pool_i_ >= pool_length_) {
+        return NULL;
+    }
+
+    json_t *const child = &pool_[pool_i_];
+    pool_i_++;
+    child->sibling = NULL;
+    child->name = NULL;
+    child->u.child = NULL;
+
+    //append to the open container (kept in order)
+    const uint16_t container_i = depth_ - 1;
+    if (last_children_[container_i] == NULL) {
+        containers_[container_i]->u.child = child;
+    } else {
+        last_children_[container_i]->sibling = child;
+    }
+    last_children_[container_i] = child;
+
+    return child;
+}
+
+__attribute__((ramfunc))
+bool json_stream_parser::push(json_t *const container) {
+    if (depth_ == json_stream_max_depth) {
+        return set_error();
+    }
+
+    container->u.child = NULL;
+    containers_[depth_] = container;
+    last_children_[depth_] = NULL;
+    depth_++;
+    return true;
+}
+
+__attribute__((ramfunc))
+bool json_stream_parser::start_value(char c) {
+    //text starts at the next stored character (the quote is not stored)
+    current_->u.value = &buffer_[buffer_i_];
+
+    switch (c) {
+        case '{':
+            current_->type = JSON_OBJ;
+            state_ = js_member;
+            return push(current_);
+
+        case '[':
+            current_->type = JSON_ARRAY;
+            state_ = js_element;
+            return push(current_);
+
+        case '\"':
+            current_->type = JSON_TEXT;
+            is_name_ = false;
+            state_ = js_string;
+            return true;
+
+        case 't':
+            current_->type = JSON_BOOLEAN;
+            literal_ = "true";
+            break;
+
+        case 'f':
+            current_->type = JSON_BOOLEAN;
+            literal_ = "false";
+            break;
+
+        case 'n':
+            current_->type = JSON_NULL;
+            literal_ = "null";
+            break;
+
+        default:
+            if ((c != '-') && (!is_digit(c))) {
+                return set_error();
+            }
+            state_ = js_number;
+            return store(c);
+    }
+
+    //only the literals are left
+    literal_i_ = 1;
+    state_ = js_literal;
+    return store(c);
+}
+
+//after a value, go back to the open container
+__attribute__((ramfunc))
+bool json_stream_parser::end_token() {
+    if (containers_[depth_ - 1]->type == JSON_OBJ) {
+        state_ = js_member;
+    } else {
+        state_ = js_element;
+    }
+    return true;
+}
+
+//blanks and commas are skipped (same as tiny_json)
+__attribute__((ramfunc))
+bool json_stream_parser::container_char(char c) {
+    if (is_blank(c) || (c == ',')) {
+        return true;
+    }
+
+    const bool is_object = (state_ == js_member);
+    if (c == (is_object ? '}' : ']')) {
+        depth_--;
+        if (depth_ == 0) {
+            state_ = js_done;
+            return true;
+        }
+        return end_token();
+    }
+
+    current_ = new_child();
+    if (current_ == NULL) {
+        return set_error();
+    }
+
+    if (is_object) {
+        if (c != '\"') {
+            return set_error();
+        }
+        current_->name = &buffer_[buffer_i_];
+        is_name_ = true;
+        state_ = js_string;
+        return true;
+    }
+
+    return start_value(c);
+}
+
+__attribute__((ramfunc))
+bool json_stream_parser::add_char(char c) {
+    switch (state_) {
+        case js_start:
+            if (is_blank(c)) {
+                return true;
+            }
+            if (c != '{') {
+                return set_error();
+            }
+
+            //the root is always the first in the pool, and unnamed
+            pool_i_ = 1;
+            pool_[0].name = NULL;
+            pool_[0].sibling = NULL;
+            pool_[0].type = JSON_OBJ;
+            state_ = js_member;
+            return push(&pool_[0]);
+
+        case js_member:
+        case js_element:
+            return container_char(c);
+
+        case js_colon:
+            if (is_blank(c)) {
+                return true;
+            }
+            if (c != ':') {
+                return set_error();
+            }
+            state_ = js_value;
+            return true;
+
+        case js_value:
+            if (is_blank(c)) {
+                return true;
+            }
+            return start_value(c);
+
+        case js_string:
+            if (static_cast<uint16_t>(c) < ' ') {
+                return set_error();
+            }
+            if (c == '\"') {
+                if (!store('\0')) {
+                    return false;
+                }
+                if (is_name_) {
+                    state_ = js_colon;
+                    return true;
+                }
+                return end_token();
+            }
+            if (c == '\\') {
+                state_ = js_escape;
+                return true;
+            }
+            return store(c);
+
+        case js_escape:
+            if (c == 'u') {
+                unicode_count_ = 0;
+                state_ = js_unicode;
+                return true;
+            }
+            c = escape_char(c);
+            if (c == '\0') {
+                return set_error();
+            }
+            state_ = js_string;
+            return store(c);
+
+        case js_unicode:
+            //just like tiny_json, any unicode is replaced with a '?'
+            if (!is_hex_digit(c)) {
+                return set_error();
+            }
+            unicode_count_++;
+            if (unicode_count_ < 4) {
+                return true;
+            }
+            state_ = js_string;
+            return store('?');
+
+        case js_number:
+            if (!is_end_of_primitive(c)) {
+                return store(c);
+            }
+            if (!store('\0')) {
+                return false;
+            }
+            if (!check_number(current_->u.value, current_->type)) {
+                return set_error();
+            }
+            end_token();
+            return container_char(c);
+
+        case js_literal:
+            if (literal_[literal_i_] != '\0') {
+                if (c != literal_[literal_i_]) {
+                    return set_error();
+                }
+                literal_i_++;
+                return store(c);
+            }
+            if ((!is_end_of_primitive(c)) || (!store('\0'))) {
+                return set_error();
+            }
+            end_token();
+            return container_char(c);
+
+        case js_done:
+            //anything after the root is ignored
+            return true;
+
+        default:
+            return false;
+    }
+}
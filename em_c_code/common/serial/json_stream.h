@@ -0,0 +1,78 @@
+/*
+ * json_stream.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// resumable json tokenizer, that is fed one character at a time (as they arrive)
+// produces the same json_t tree as json_create, so the rest of the command handling is unchanged
+// token text is compacted into the buffer (structural characters are never stored)
+
+#ifndef json_stream_defined
+#define json_stream_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tiny_json.h"
+
+
+//max nesting (commands only have a root object with arrays)
+static const uint16_t json_stream_max_depth = 8;
+
+typedef enum {
+    js_start,       //before the root object
+    js_member,      //in an object, before a name or the end
+    js_element,     //in an array, before a value or the end
+    js_colon,       //after a name
+    js_value,       //after a colon
+    js_string,      //inside a name or text value
+    js_escape,      //after a backslash
+    js_unicode,     //inside a \uXXXX escape
+    js_number,      //inside a number
+    js_literal,     //inside true, false, or null
+    js_done,        //root object is complete
+    js_error        //stays here until reset
+} json_stream_state_t;
+
+class json_stream_parser {
+    public:
+        void init(char *const buffer, uint16_t buffer_length, json_t *const pool, uint16_t pool_length);
+        void reset();
+
+        //returns false once there is an error
+        bool add_char(char c);
+
+        //NULL until the root object is complete
+        const json_t *root() const;
+        bool has_error() const {return state_ == js_error;}
+
+    private:
+        char *buffer_;
+        uint16_t buffer_length_;
+        uint16_t buffer_i_;
+        json_t *pool_;
+        uint16_t pool_length_;
+        uint16_t pool_i_;
+
+        json_stream_state_t state_;
+        bool is_name_;
+        uint16_t unicode_count_;
+        const char *literal_;
+        uint16_t literal_i_;
+        json_t *current_;
+
+        //open objects and arrays
+        uint16_t depth_;
+        json_t *containers_[json_stream_max_depth];
+        json_t *last_children_[json_stream_max_depth];
+
+        //private functions
+        bool store(char c);
+        json_t *new_child();
+        bool push(json_t *const container);
+        bool start_value(char c);
+        bool end_token();
+        bool container_char(char c);
+        bool set_error();
+};
+
+#endif
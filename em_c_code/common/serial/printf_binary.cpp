@@ -0,0 +1,139 @@
+/*
+ * printf_binary.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "printf_binary.h"
+#include "scia.h"
+
+
+//internal variables
+static volatile bool binary_mode_on = false;   //default is json
+
+//COBS block (a block holds at most 254 non-zero bytes)
+static const uint16_t cobs_max_block_length = 254;
+static uint16_t cobs_block[cobs_max_block_length];
+static uint16_t cobs_block_length = 0;
+static uint16_t frame_crc = 0xFFFF;
+
+//internal functions
+void cobs_put_byte(uint16_t byte);
+void cobs_flush_block(bool is_full_block);
+
+
+void set_binary_mode(bool enable) {
+    binary_mode_on = enable;
+}
+
+__attribute__((ramfunc))
+bool is_binary_mode() {
+    return binary_mode_on;
+}
+
+__attribute__((ramfunc))
+uint16_t crc16_update(uint16_t crc, uint16_t byte) {
+    crc ^= ((byte & 0x00FF) << 8);
+
+    for (uint16_t bit_i=0; bit_i<8; bit_i++) {
+        if (crc & 0x8000) {
+            crc = (crc << 1) ^ 0x1021;
+        } else {
+            crc = (crc << 1);
+        }
+    }
+
+    return (crc & 0xFFFF);  //keep it to 16 bits
+}
+
+__attribute__((ramfunc))
+void cobs_flush_block(bool is_full_block) {
+    //a full block has no implied zero after it
+    if (is_full_block) {
+        printf_char(0xFF);
+    } else {
+        printf_char(cobs_block_length + 1);
+    }
+
+    for (uint16_t block_i=0; block_i<cobs_block_length; block_i++) {
+        printf_char(cobs_block[block_i]);
+    }
+
+    cobs_block_length = 0;
+}
+
+__attribute__((ramfunc))
+void cobs_put_byte(uint16_t byte) {
+    byte &= 0x00FF;
+
+    if (byte == 0) {
+        cobs_flush_block(false);
+    } else {
+        cobs_block[cobs_block_length] = byte;
+        cobs_block_length++;
+
+        if (cobs_block_length == cobs_max_block_length) {
+            cobs_flush_block(true);
+        }
+    }
+}
+
+__attribute__((ramfunc))
+void binary_frame_begin(binary_record_type_t record_type, int64_t timestamp) {
+    cobs_block_length = 0;
+    frame_crc = 0xFFFF;
+
+    binary_frame_put_byte(static_cast<uint16_t>(record_type));
+    binary_frame_put_uint64(static_cast<uint64_t>(timestamp));
+}
+
+__attribute__((ramfunc))
+void binary_frame_put_byte(uint16_t byte) {
+    frame_crc = crc16_update(frame_crc, byte);
+    cobs_put_byte(byte);
+}
+
+//all multi-byte values are little-endian
+__attribute__((ramfunc))
+void binary_frame_put_uint16(uint16_t value) {
+    binary_frame_put_byte(value & 0x00FF);
+    binary_frame_put_byte(value >> 8);
+}
+
+__attribute__((ramfunc))
+void binary_frame_put_uint32(uint32_t value) {
+    binary_frame_put_uint16(static_cast<uint16_t>(value & 0xFFFF));
+    binary_frame_put_uint16(static_cast<uint16_t>(value >> 16));
+}
+
+__attribute__((ramfunc))
+void binary_frame_put_uint64(uint64_t value) {
+    binary_frame_put_uint32(static_cast<uint32_t>(value & 0xFFFFFFFF));
+    binary_frame_put_uint32(static_cast<uint32_t>(value >> 32));
+}
+
+__attribute__((ramfunc))
+void binary_frame_put_string(const char *const string) {
+    if (string != NULL) {
+        uint16_t string_i = 0;
+        while (string[string_i] != '\0') {
+            binary_frame_put_byte(string[string_i]);
+            string_i++;
+        }
+    }
+
+    binary_frame_put_byte(0);
+}
+
+__attribute__((ramfunc))
+void binary_frame_end() {
+    //crc is over the record bytes (not the crc itself)
+    const uint16_t crc = frame_crc;
+    cobs_put_byte(crc & 0x00FF);
+    cobs_put_byte(crc >> 8);
+
+    //final block, then the frame delimiter
+    cobs_flush_block(false);
+    printf_char(0);
+}
@@ -0,0 +1,36 @@
+/*
+ * printf_binary.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#ifndef printf_binary_defined
+#define printf_binary_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//binary record types (first byte of every record)
+typedef enum {
+    binary_record_message = 1   //a converted json message
+} binary_record_type_t;
+
+//output mode (json is the default)
+void set_binary_mode(bool enable);
+bool is_binary_mode();
+
+//framing (record bytes are COBS encoded, followed by a CRC16 and a zero delimiter)
+void binary_frame_begin(binary_record_type_t record_type, int64_t timestamp);
+void binary_frame_put_byte(uint16_t byte);
+void binary_frame_put_uint16(uint16_t value);
+void binary_frame_put_uint32(uint32_t value);
+void binary_frame_put_uint64(uint64_t value);
+void binary_frame_put_string(const char *const string); //includes the terminator
+void binary_frame_end();
+
+//crc16-ccitt (0x1021 polynomial, 0xFFFF initial value)
+uint16_t crc16_update(uint16_t crc, uint16_t byte);
+
+#endif
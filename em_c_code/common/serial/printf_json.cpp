@@ -12,13 +12,16 @@
 #include <stdbool.h>
 #include "math.h"
 #include "stdarg.h"
+#include "string.h"
 #include "scia.h"
-#include "ring_buffer.h"
+#include "fixed_ring_buffer.h"
 #include "fpu_vector.h"
 #include "misc.h"
 #include "printf_raw.h"
 #include "tic_toc.h"
 #include "arrays.h"
+#include "printf_binary.h"
+#include "io_controller.h"
 
 
 
@@ -28,13 +31,57 @@
 static volatile bool has_had_print_error = false;
 static volatile bool has_had_fatal_print_error = false;
 
-//delayed queue size
-static const uint16_t delayed_json_object_queue_length = 200;
+//delayed queue size (power of two)
+static const uint16_t delayed_json_object_queue_length = 256;
 
 //queue objects need to be volatile since they can be added at any time
+//each class is a linked list of entries (in order), and unused entries are in the free ring buffer
 static volatile bool has_init_delayed_queue = false;
-static volatile delayed_json_t *delayed_json_objects;
-static volatile ring_buffer delayed_json_object_queue;
+static volatile delayed_json_t delayed_json_objects[delayed_json_object_queue_length];
+static volatile fixed_ring_buffer<uint16_t, delayed_json_object_queue_length> delayed_json_free_entries;
+static const uint16_t delayed_json_no_entry = 0xFFFF;
+static uint16_t *delayed_json_next_entry;       //next entry in the same class
+static uint16_t *delayed_json_entry_keys;       //coalesce key of each entry
+static const json_template_t **delayed_json_entry_templates;   //template of each entry (NULL for none)
+static volatile uint16_t delayed_json_class_head[print_class_count];
+static volatile uint16_t delayed_json_class_tail[print_class_count];
+static volatile uint16_t delayed_json_coalesce_entry[print_coalesce_count];  //unsent entry for each key
+
+//a class can only take an entry when more than its reserve are free (kept for the more important classes)
+static const uint16_t delayed_json_class_reserve[print_class_count] = {0, 16, 64, 128};
+static volatile uint32_t delayed_json_class_drops[print_class_count];
+static volatile uint32_t delayed_json_coalesced = 0;
+
+//message slab (fixed-size slots, so that small messages never touch the heap)
+//one slot per queue entry, so the slab can't run out while the queue still has room
+//larger messages (only from serial commands) still use the heap, the host tests check that every isr message fits
+static const uint16_t delayed_json_slot_count = delayed_json_object_queue_length;
+static const uint16_t delayed_json_slot_objects = 6;   //the largest isr message (a region event), 256*6*12 = 0x4800 words of heap
+static json_object_t *delayed_json_slab;
+static volatile fixed_ring_buffer<uint16_t, delayed_json_slot_count> delayed_json_free_slots;
+static volatile uint16_t delayed_json_max_slots_in_use = 0;
+static volatile uint32_t delayed_json_slot_failures = 0;
+static volatile uint32_t delayed_json_heap_messages = 0;
+static volatile tic_toc delayed_json_print_timing;     //render and copy of one message
+
+//template being created (while not NULL, the text goes here instead of to the serial port)
+static const uint16_t json_template_max_text = 256;
+static const uint16_t json_template_max_values = 16;
+static char *json_template_text = NULL;
+static uint16_t *json_template_starts = NULL;
+static uint16_t json_template_text_i = 0;
+static uint16_t json_template_value_i = 0;
+static bool json_template_overflow = false;
+
+//request id (added to every message queued by the command being processed)
+static volatile bool json_request_id_active = false;
+static volatile uint32_t json_request_id = 0;
+static volatile uint16_t json_request_ier = 0;    //enabled interrupts in the main loop
+
+//command errors (noted for each command in a batch)
+static volatile bool json_command_errors_watched = false;
+static volatile bool json_command_had_error = false;
+static volatile uint16_t json_command_errors_ier = 0;
 
 //timestamp constants
 static volatile uint64_t ts_multiplier = 1;
@@ -42,19 +89,88 @@ static volatile uint16_t ts_shift = 0;
 
 //internal functions
 void internal_printf_json_object(const json_object_t &json_object);
+void internal_printf_json_value(const json_object_t &json_object);
+void internal_print_json_template(const json_template_t *const json_template, const json_object_t *const objects, uint16_t object_count);
 void internal_printf_value(value_type_t value_type, const void *const value_ptr, uint16_t index, uint16_t precision_or_sig_figs);
 void internal_printf_array(value_type_t value_type, uint16_t array_count, const array_ptr_union_t values_ptr, uint16_t precision_or_sig_figs);
+void internal_binary_json_object(const json_object_t &json_object, uint16_t object_i, uint16_t object_count);
+void internal_binary_value(value_type_t value_type, const void *const value_ptr, uint16_t index);
 json_object_t create_blank_json_object();
+bool is_json_request_message();
+void note_json_command_error(const json_object_t &first_object);
+uint16_t take_next_delayed_json_entry();
 
 //global variable
 const json_object_t blank_json_object = create_blank_json_object();
 
 
+//the structure of a message (names, quotes, and brackets) goes through these, so that it can be captured for a template
+__attribute__((ramfunc))
+void json_text_char(uint16_t c) {
+    if (json_template_text == NULL) {
+        printf_char(c);
+        return;
+    }
+
+    //always leave room for the null terminator
+    if (json_template_text_i < (json_template_max_text - 1)) {
+        json_template_text[json_template_text_i] = c;
+        json_template_text_i++;
+    } else {
+        json_template_overflow = true;
+    }
+}
+
+__attribute__((ramfunc))
+void json_text_string(const char *const string) {
+    if (json_template_text == NULL) {
+        printf_string(string);
+        return;
+    }
+
+    uint16_t string_i = 0;
+    while (string[string_i] != '\0') {
+        json_text_char(string[string_i]);
+        string_i++;
+    }
+}
+
+__attribute__((ramfunc))
+void json_text_return() {
+    if (json_template_text == NULL) {
+        printf_return();
+        return;
+    }
+
+    //CR+LF to be compatible with windows
+    json_text_char(13);
+    json_text_char(10);
+}
+
+//string values (e.g., the reason) are part of the template, anything else is printed each time
+__attribute__((ramfunc))
+bool is_json_template_value(const json_object_t &json_object) {
+    if (json_object.combined_params.value_type == t_parent) {
+        return false;
+    }
+    return (json_object.combined_params.is_array || (json_object.combined_params.value_type != t_string));
+}
+
 __attribute__((ramfunc))
 void internal_inner_print_json_objects(const json_object_t &json_object, uint16_t object_i, uint16_t object_count, uint16_t &object_child_count) {
+    //binary records carry the same objects, so no brackets or commas
+    if (is_binary_mode() && (json_template_text == NULL)) {
+        internal_binary_json_object(json_object, object_i, object_count);
+
+        if (json_object.is_printing_bool_ptr != NULL) {
+            *(json_object.is_printing_bool_ptr) = false;
+        }
+        return;
+    }
+
     if (object_i == 0) {
         //open the JSON string
-        printf_char('{');
+        json_text_char('{');
     }
 
     const uint16_t final_object_i = (object_count - 1);
@@ -66,16 +182,16 @@ void internal_inner_print_json_objects(const json_object_t &json_object, uint16_
         if (object_child_count == 0) {
             //print a comma, if not the last object
             if (object_i != final_object_i) {
-                printf_char(',');
+                json_text_char(',');
             }
         }
 
     } else {
         //print the string, and open bracket
-        printf_char('"');
-        printf_string(json_object.parameter_name);  //this is for a parent
-        printf_string("\":");
-        printf_char('{');
+        json_text_char('"');
+        json_text_string(json_object.parameter_name);  //this is for a parent
+        json_text_string("\":");
+        json_text_char('{');
         object_child_count = json_object.array_count;
     }
 
@@ -85,18 +201,18 @@ void internal_inner_print_json_objects(const json_object_t &json_object, uint16_
 
         //if the last child, or no more objects, then close bracket
         if ((object_child_count == 0) || (object_i == final_object_i)) {
-            printf_char('}');
+            json_text_char('}');
         }
 
         if (object_i != final_object_i) {
-            printf_char(',');
+            json_text_char(',');
         }
     }
 
     if (object_i == final_object_i) {
         //close the JSON string and return
-        printf_char('}');
-        printf_return();
+        json_text_char('}');
+        json_text_return();
     }
 
     //set the callback bool pointer, if defined
@@ -113,6 +229,9 @@ void printf_json_objects(uint16_t object_count, ...) {
 
     va_start(json_objects, object_count);
 
+    //render the whole message, then copy it to the tx buffer at once
+    scia_tx_stage_begin();
+
     //loop through each object
     for (uint16_t object_i = 0; object_i<object_count; object_i++) {
         const json_object_t json_object = va_arg(json_objects, json_object_t);
@@ -120,6 +239,8 @@ void printf_json_objects(uint16_t object_count, ...) {
         internal_inner_print_json_objects(json_object, object_i, object_count, object_child_count);
     }
 
+    scia_tx_stage_commit();
+
     va_end(json_objects);
 }
 
@@ -131,15 +252,15 @@ void printf_delayed_json_objects(bool print_all) {
     debug_timestamps.printf_s_print = CPU_TIMESTAMP;
 
     //if there is an object in the queue, print it (only one per each call)
-    while (!delayed_json_object_queue.is_empty()) {
+    while (true) {
         debug_timestamps.printf_s_loop = CPU_TIMESTAMP;
 
         debug_timestamps.printf_b_read_i = CPU_TIMESTAMP;
 
-        //grab the next object and copy locally
-        uint16_t queue_i;
-        if (!delayed_json_object_queue.read(queue_i)) {
-            lockup_cpu();
+        //grab the next object (most important class first)
+        const uint16_t queue_i = take_next_delayed_json_entry();
+        if (queue_i == delayed_json_no_entry) {
+            break;
         }
 
         debug_timestamps.printf_a_read_i = CPU_TIMESTAMP;
@@ -150,7 +271,7 @@ void printf_delayed_json_objects(bool print_all) {
             debug_timestamps.printf_is_valid = CPU_TIMESTAMP;
 
             //get the count
-            const uint16_t object_count = delayed_json_objects[queue_i].object_count;
+            uint16_t object_count = delayed_json_objects[queue_i].object_count;
 
             debug_timestamps.printf_a_count = CPU_TIMESTAMP;
 
@@ -159,6 +280,17 @@ void printf_delayed_json_objects(bool print_all) {
 
             debug_timestamps.printf_b_obj_loop = CPU_TIMESTAMP;
 
+            //render the whole message, then copy it to the tx buffer at once
+            delayed_json_print_timing.tic();
+            scia_tx_stage_begin();
+
+            //templates only have the json text (and must be the same shape)
+            const json_template_t *const json_template = delayed_json_entry_templates[queue_i];
+            if ((json_template != NULL) && (json_template->object_count == object_count) && (!is_binary_mode())) {
+                internal_print_json_template(json_template, delayed_json_objects[queue_i].objects, object_count);
+                object_count = 0;
+            }
+
             //loop through each object
             for (uint16_t object_i = 0; object_i<object_count; object_i++) {
 
@@ -175,10 +307,13 @@ void printf_delayed_json_objects(bool print_all) {
                 debug_timestamps.printf_a_print = CPU_TIMESTAMP;
             }
 
+            scia_tx_stage_commit();
+            delayed_json_print_timing.toc();
+
             debug_timestamps.printf_b_delete = CPU_TIMESTAMP;
 
-            //delete the objects
-            delete_array(delayed_json_objects[queue_i].objects);
+            //release the objects
+            release_delayed_json_objects(delayed_json_objects[queue_i].objects);
             delayed_json_objects[queue_i].objects = NULL;
 
             //reset count to zero
@@ -188,6 +323,11 @@ void printf_delayed_json_objects(bool print_all) {
 
         }
 
+        //the entry can be used again
+        if (!delayed_json_free_entries.write(queue_i)) {
+            lockup_cpu();
+        }
+
         //if not printing all, then exit after 1
         if (!print_all) {
             break;
@@ -198,22 +338,129 @@ void printf_delayed_json_objects(bool print_all) {
 bool init_delayed_json_object_queue() {
     if (has_init_delayed_queue) {return true;}
 
-    //alloc both the object array and the ring buffer
-    delayed_json_objects = create_array_of<delayed_json_t>(delayed_json_object_queue_length, "delayed_json_objects");
-    if (delayed_json_objects == NULL) {
+    //the links and keys are only used here, so allocate them once
+    delayed_json_next_entry = create_array_of<uint16_t>(delayed_json_object_queue_length, "delayed_json_next_entry");
+    delayed_json_entry_keys = create_array_of<uint16_t>(delayed_json_object_queue_length, "delayed_json_entry_keys");
+    delayed_json_entry_templates = create_array_of<const json_template_t *>(delayed_json_object_queue_length, "delayed_json_entry_templates");
+    if ((delayed_json_next_entry == NULL) || (delayed_json_entry_keys == NULL) || (delayed_json_entry_templates == NULL)) {
         lockup_cpu();
         return false;
     }
 
-    if (!delayed_json_object_queue.init_alloc(delayed_json_object_queue_length)) {
+    //the object array and the ring buffer are static, so just clear them (every entry starts free)
+    delayed_json_free_entries.reset();
+    for (uint16_t i=0; i<delayed_json_object_queue_length; i++) {
+        delayed_json_objects[i].object_count = 0;
+        delayed_json_objects[i].objects = NULL;
+        delayed_json_next_entry[i] = delayed_json_no_entry;
+        delayed_json_entry_keys[i] = print_coalesce_none;
+        delayed_json_entry_templates[i] = NULL;
+        delayed_json_free_entries.write(i);
+    }
+
+    //every class is empty, and nothing can be coalesced
+    for (uint16_t class_i=0; class_i<print_class_count; class_i++) {
+        delayed_json_class_head[class_i] = delayed_json_no_entry;
+        delayed_json_class_tail[class_i] = delayed_json_no_entry;
+        delayed_json_class_drops[class_i] = 0;
+    }
+    for (uint16_t key_i=0; key_i<print_coalesce_count; key_i++) {
+        delayed_json_coalesce_entry[key_i] = delayed_json_no_entry;
+    }
+
+    //allocate the slab once, and mark every slot as free
+    delayed_json_slab = create_array_of<json_object_t>(delayed_json_slot_count * delayed_json_slot_objects, "delayed_json_slab");
+    if (delayed_json_slab == NULL) {
         lockup_cpu();
         return false;
     }
+    delayed_json_free_slots.reset();
+    for (uint16_t slot_i=0; slot_i<delayed_json_slot_count; slot_i++) {
+        delayed_json_free_slots.write(slot_i);
+    }
 
     has_init_delayed_queue = true;
     return true;
 }
 
+//O(1) from the free slots, or the heap if too large for a slot
+//the class keeps the same reserve of slots as of queue entries, so a burst of telemetry can't use the slots held for errors
+//a message that can't get its objects is counted as a drop of its class
+__attribute__((ramfunc))
+json_object_t *create_delayed_json_objects(uint16_t object_count, print_class_t print_class) {
+    if (object_count > delayed_json_slot_objects) {
+        delayed_json_heap_messages++;
+        json_object_t *const heap_objects = create_array_of<json_object_t>(object_count, "printf_objects");
+        if (heap_objects == NULL) {
+            delayed_json_class_drops[print_class]++;
+        }
+        return heap_objects;
+    }
+
+    uint16_t slot_i;
+    const uint16_t interrupt_settings = __disable_interrupts();
+    if ((delayed_json_free_slots.in_use() <= delayed_json_class_reserve[print_class]) || (!delayed_json_free_slots.read(slot_i))) {
+        delayed_json_slot_failures++;
+        delayed_json_class_drops[print_class]++;
+        __restore_interrupts(interrupt_settings);
+        return NULL;
+    }
+    __restore_interrupts(interrupt_settings);
+
+    const uint16_t slots_in_use = delayed_json_slot_count - delayed_json_free_slots.in_use();
+    if (slots_in_use > delayed_json_max_slots_in_use) {
+        delayed_json_max_slots_in_use = slots_in_use;
+    }
+
+    return &delayed_json_slab[slot_i * delayed_json_slot_objects];
+}
+
+__attribute__((ramfunc))
+void release_delayed_json_objects(const json_object_t *const objects) {
+    if (objects == NULL) {return;}
+
+    //anything outside of the slab came from the heap
+    if ((objects >= delayed_json_slab) && (objects < &delayed_json_slab[delayed_json_slot_count * delayed_json_slot_objects])) {
+        const uint16_t slot_i = static_cast<uint16_t>((objects - delayed_json_slab) / delayed_json_slot_objects);
+        delayed_json_free_slots.write(slot_i);
+    } else {
+        delete_array(objects);
+    }
+}
+
+delayed_json_statistics_t get_delayed_json_statistics(bool reset) {
+    delayed_json_statistics_t statistics;
+
+    const uint16_t interrupt_settings = __disable_interrupts();
+    statistics.queue_length = delayed_json_object_queue_length;
+    statistics.queue_in_use = delayed_json_object_queue_length - delayed_json_free_entries.in_use();
+    statistics.slot_count = delayed_json_slot_count;
+    statistics.slot_objects = delayed_json_slot_objects;
+    statistics.slots_in_use = delayed_json_slot_count - delayed_json_free_slots.in_use();
+    statistics.max_slots_in_use = delayed_json_max_slots_in_use;
+    statistics.slot_failures = delayed_json_slot_failures;
+    statistics.heap_messages = delayed_json_heap_messages;
+    statistics.print_max_us = delayed_json_print_timing.max_us();
+    for (uint16_t class_i=0; class_i<print_class_count; class_i++) {
+        statistics.class_drops[class_i] = delayed_json_class_drops[class_i];
+    }
+    statistics.coalesced = delayed_json_coalesced;
+
+    if (reset) {
+        delayed_json_max_slots_in_use = statistics.slots_in_use;
+        delayed_json_slot_failures = 0;
+        delayed_json_heap_messages = 0;
+        delayed_json_print_timing.reset();
+        for (uint16_t class_i=0; class_i<print_class_count; class_i++) {
+            delayed_json_class_drops[class_i] = 0;
+        }
+        delayed_json_coalesced = 0;
+    }
+    __restore_interrupts(interrupt_settings);
+
+    return statistics;
+}
+
 
 //cannot be a ramfunc, as it is used before available
 json_object_t create_blank_json_object() {
@@ -237,20 +484,106 @@ json_object_t create_blank_json_object() {
 
 __attribute__((ramfunc))
 void copy_json_object(const json_object_t *const copy_from, json_object_t *const copy_to) {
-    //a uint16_t is the smallest unit (1), so no reason to divide by it
-    memcpy_fast(copy_to, copy_from, static_cast<uint16_t>(sizeof(json_object_t)));
+    memcpy_fast_of<json_object_t>(copy_to, copy_from, 1);
+}
+
+//errors are recognized by the name of the first object (so every existing error goes to the error class)
+__attribute__((ramfunc))
+bool is_error_json_object(const json_object_t &json_object) {
+    const char *const name = json_object.parameter_name;
+    return ((name != NULL) && (name[0] == 'e') && (strcmp(name, "error") == 0));
+}
+
+__attribute__((ramfunc))
+uint16_t get_delayed_json_class_available(print_class_t print_class) {
+    const uint16_t free_count = delayed_json_free_entries.in_use();
+    const uint16_t reserve = delayed_json_class_reserve[print_class];
+
+    if (free_count > reserve) {
+        return free_count - reserve;
+    }
+    return 0;
 }
 
+//either replaces the objects of an unsent entry with the same key, or links a new entry to the end of the class
+//returns the objects that were replaced (or the new objects, if there was no room), which must then be discarded
 __attribute__((ramfunc))
-uint16_t get_next_delayed_objects_queue_i_for_writing() {
+json_object_t *enqueue_delayed_json_objects(print_class_t print_class, print_coalesce_t coalesce_key, const json_template_t *const json_template, json_object_t *const objects, uint16_t object_count, uint16_t &discard_count) {
+    json_object_t *discard_objects = NULL;
+    discard_count = 0;
+
     //disable and store the interrupt state
     const uint16_t interrupt_settings = __disable_interrupts();
 
-    //atomically get the index and write it to the queue
-    const uint16_t queue_i = delayed_json_object_queue.write_index();
+    if ((coalesce_key != print_coalesce_none) && (delayed_json_coalesce_entry[coalesce_key] != delayed_json_no_entry)) {
+        //swap in the newer objects (the entry keeps its place)
+        const uint16_t queue_i = delayed_json_coalesce_entry[coalesce_key];
+        discard_objects = delayed_json_objects[queue_i].objects;
+        discard_count = delayed_json_objects[queue_i].object_count;
+        delayed_json_objects[queue_i].objects = objects;
+        delayed_json_objects[queue_i].object_count = object_count;
+        delayed_json_entry_templates[queue_i] = json_template;
+        delayed_json_coalesced++;
 
-    if (!delayed_json_object_queue.write(queue_i)) {
-        lockup_cpu();
+    } else {
+        uint16_t queue_i;
+        if ((get_delayed_json_class_available(print_class) == 0) || (!delayed_json_free_entries.read(queue_i))) {
+            delayed_json_class_drops[print_class]++;
+            __restore_interrupts(interrupt_settings);
+
+            discard_count = object_count;
+            return objects;
+        }
+
+        delayed_json_objects[queue_i].objects = objects;
+        delayed_json_objects[queue_i].object_count = object_count;
+        delayed_json_entry_keys[queue_i] = coalesce_key;
+        delayed_json_entry_templates[queue_i] = json_template;
+        delayed_json_next_entry[queue_i] = delayed_json_no_entry;
+
+        //link to the end of the class
+        if (delayed_json_class_tail[print_class] == delayed_json_no_entry) {
+            delayed_json_class_head[print_class] = queue_i;
+        } else {
+            delayed_json_next_entry[delayed_json_class_tail[print_class]] = queue_i;
+        }
+        delayed_json_class_tail[print_class] = queue_i;
+
+        if (coalesce_key != print_coalesce_none) {
+            delayed_json_coalesce_entry[coalesce_key] = queue_i;
+        }
+    }
+
+    //restore the interrupt state
+    __restore_interrupts(interrupt_settings);
+
+    return discard_objects;
+}
+
+//unlinks the first entry of the most important class (it is no longer able to be coalesced)
+__attribute__((ramfunc))
+uint16_t take_next_delayed_json_entry() {
+    uint16_t queue_i = delayed_json_no_entry;
+
+    //disable and store the interrupt state
+    const uint16_t interrupt_settings = __disable_interrupts();
+
+    for (uint16_t class_i=0; class_i<print_class_count; class_i++) {
+        queue_i = delayed_json_class_head[class_i];
+        if (queue_i == delayed_json_no_entry) {
+            continue;
+        }
+
+        delayed_json_class_head[class_i] = delayed_json_next_entry[queue_i];
+        if (delayed_json_class_head[class_i] == delayed_json_no_entry) {
+            delayed_json_class_tail[class_i] = delayed_json_no_entry;
+        }
+
+        const uint16_t coalesce_key = delayed_json_entry_keys[queue_i];
+        if ((coalesce_key != print_coalesce_none) && (delayed_json_coalesce_entry[coalesce_key] == queue_i)) {
+            delayed_json_coalesce_entry[coalesce_key] = delayed_json_no_entry;
+        }
+        break;
     }
 
     //restore the interrupt state
@@ -259,108 +592,321 @@ uint16_t get_next_delayed_objects_queue_i_for_writing() {
     return queue_i;
 }
 
+//frees any arrays that were only copied for printing, then the objects themselves
+__attribute__((ramfunc))
+void discard_delayed_json_objects(json_object_t *const objects, uint16_t object_count) {
+    if (objects == NULL) {return;}
+
+    for (uint16_t object_i = 0; object_i<object_count; object_i++) {
+        json_object_t temp_json_object;
+        copy_json_object(&(objects[object_i]), &temp_json_object);
+        if (temp_json_object.combined_params.is_array && temp_json_object.combined_params.free_array_after_print) {
+            delete_array_for_value_type(temp_json_object.combined_params.value_type, temp_json_object.value.array_ptr);
+        }
+    }
+
+    release_delayed_json_objects(objects);
+}
+
 void deal_with_delay_printf_error() {
     has_had_print_error = true;
 
-    //otherwise, show an error (if able)
-    if (!delayed_json_object_queue.is_full()) {
-
-        //allocate first, then copy
-        json_object_t *const objects = create_array_of<json_object_t>(1, "printf_objects");
-        if (objects == NULL) {
-            has_had_fatal_print_error = true;
-            lockup_cpu();
-            return;
-        }
+    //otherwise, show an error (if able), only one is ever waiting to print
+    json_object_t *const objects = create_delayed_json_objects(1, print_class_error);
+    if (objects == NULL) {
+        has_had_fatal_print_error = true;
+        return;
+    }
 
-        const uint16_t queue_i = get_next_delayed_objects_queue_i_for_writing();
-        const json_object_t json_object = json_string("error", "printf delay queue is full");
-        copy_json_object(&json_object, const_cast<json_object_t *>(&(objects[0])));
-        delayed_json_objects[queue_i].object_count = 1;
-        delayed_json_objects[queue_i].objects = objects;
+    const json_object_t json_object = json_string("error", "printf delay queue is full");
+    copy_json_object(&json_object, objects);
 
-    } else {
+    uint16_t discard_count;
+    json_object_t *const discard_objects = enqueue_delayed_json_objects(print_class_error, print_coalesce_queue_full, NULL, objects, 1, discard_count);
+    if (discard_objects == objects) {
         has_had_fatal_print_error = true;
     }
+    discard_delayed_json_objects(discard_objects, discard_count);
 }
 
+//returns false if there was no room (and the objects were discarded)
 __attribute__((ramfunc))
-void delay_printf_json_objects(const delayed_json_t delayed_json_object) {
-    if (!has_init_delayed_queue) {return;}
+bool add_delayed_json_objects(print_class_t print_class, print_coalesce_t coalesce_key, const json_template_t *const json_template, json_object_t *const objects, uint16_t object_count) {
+    uint16_t discard_count;
+    json_object_t *const discard_objects = enqueue_delayed_json_objects(print_class, coalesce_key, json_template, objects, object_count, discard_count);
 
-    //must always be at least 1 extra free space, otherwise show error
-    if (delayed_json_object_queue.available() > 1) {
+    //if there was no room, then show the error
+    const bool is_added = (discard_objects != objects);
+    if (!is_added) {
+        deal_with_delay_printf_error();
+    }
 
-        //just copy the delayed_json object
-        const uint16_t queue_i = get_next_delayed_objects_queue_i_for_writing();
-        delayed_json_objects[queue_i].object_count = delayed_json_object.object_count;
-        delayed_json_objects[queue_i].objects = delayed_json_object.objects;
+    discard_delayed_json_objects(discard_objects, discard_count);
+    return is_added;
+}
 
-    } else {
+void set_delayed_json_request_id(uint32_t request_id) {
+    json_request_ier = IER;
+    json_request_id = request_id;
+    json_request_id_active = true;
+}
 
-        deal_with_delay_printf_error();
+void clear_delayed_json_request_id() {
+    json_request_id_active = false;
+}
 
-        //and dealloc any objects that couldn't be added
-        for (uint16_t object_i = 0; object_i<delayed_json_object.object_count; object_i++) {
-            json_object_t temp_json_object;
-            copy_json_object(const_cast<json_object_t *>(&(delayed_json_object.objects[object_i])), const_cast<json_object_t *>(&temp_json_object));
-            if (temp_json_object.combined_params.is_array && temp_json_object.combined_params.free_array_after_print) {
-                delete_array_for_value_type(temp_json_object.combined_params.value_type, temp_json_object.value.array_ptr);
-            }
-        }
-    }
+//an interrupt clears its own group in IER until it returns (the command handlers only ever change INTM)
+//so a message is from the command as long as all of the main loop's interrupts are still enabled
+__attribute__((ramfunc))
+bool is_json_request_message() {
+    return (json_request_id_active && ((IER & json_request_ier) == json_request_ier));
+}
+
+void watch_delayed_json_command_errors() {
+    json_command_errors_ier = IER;
+    json_command_had_error = false;
+    json_command_errors_watched = true;
 }
 
+bool end_watch_delayed_json_command_errors() {
+    json_command_errors_watched = false;
+    return json_command_had_error;
+}
+
+//the same test as for the request id, so an error from an interrupt isn't the command's
 __attribute__((ramfunc))
-void delay_printf_json_objects(uint16_t object_count, ...) {
-    debug_timestamps.delay_printf_1 = CPU_TIMESTAMP;
+void note_json_command_error(const json_object_t &first_object) {
+    if (json_command_errors_watched && ((IER & json_command_errors_ier) == json_command_errors_ier) && is_error_json_object(first_object)) {
+        json_command_had_error = true;
+    }
+}
 
+__attribute__((ramfunc))
+void delay_printf_json_objects(const delayed_json_t delayed_json_object) {
     if (!has_init_delayed_queue) {return;}
 
-    //va start before modification
-    va_list json_objects;
-    va_start(json_objects, object_count);
+    print_class_t print_class = print_class_event;
+    if ((delayed_json_object.object_count > 0) && is_error_json_object(delayed_json_object.objects[0])) {
+        print_class = print_class_error;
+        note_json_command_error(delayed_json_object.objects[0]);
+    }
 
-    //must always be at least 1 extra free space, otherwise show error
-    if (delayed_json_object_queue.available() > 1) {
+    json_object_t *objects = delayed_json_object.objects;
+    uint16_t object_count = delayed_json_object.object_count;
 
-        json_object_t *const objects = create_array_of<json_object_t>(object_count, "printf_objects");
-        if (objects == NULL) {
-            has_had_fatal_print_error = true;
-            lockup_cpu();
-            return;
+    //move the objects over to one more, to add the id (if that fails, it is sent without)
+    if (is_json_request_message()) {
+        json_object_t *const request_objects = create_delayed_json_objects(object_count + 1, print_class);
+        if (request_objects != NULL) {
+            for (uint16_t object_i = 0; object_i<object_count; object_i++) {
+                copy_json_object(&(objects[object_i]), &(request_objects[object_i]));
+            }
+            const json_object_t id_object = json_uint32("id", json_request_id);
+            copy_json_object(&id_object, &(request_objects[object_count]));
+
+            release_delayed_json_objects(objects);
+            objects = request_objects;
+            object_count++;
         }
+    }
 
-        const uint16_t queue_i = get_next_delayed_objects_queue_i_for_writing();
+    add_delayed_json_objects(print_class, print_coalesce_none, NULL, objects, object_count);
+}
+
+__attribute__((ramfunc))
+bool internal_delay_printf_json_objects(print_class_t print_class, print_coalesce_t coalesce_key, const json_template_t *const json_template, uint16_t object_count, va_list &json_objects) {
+    //the id (if any) is always last, which means the template is not used
+    //every reply is an event (or error) and never coalesced, so none are lost or sent after the "done"
+    const bool is_request = is_json_request_message();
+    const uint16_t total_count = is_request ? (object_count + 1) : object_count;
+    if (is_request) {
+        if (print_class > print_class_event) {
+            print_class = print_class_event;
+        }
+        coalesce_key = print_coalesce_none;
+    }
+
+    //anything else is an error, if it looks like one (known before the objects are taken, so it can use the error reserve)
+    json_object_t first_object;
+    if (object_count > 0) {
+        first_object = va_arg(json_objects, json_object_t);
+        if ((print_class == print_class_event) && is_error_json_object(first_object)) {
+            print_class = print_class_error;
+        }
+    }
+    json_object_t *const objects = create_delayed_json_objects(total_count, print_class);
+
+    if (objects != NULL) {
 
         //add each object
         for (uint16_t object_i = 0; object_i<object_count; object_i++) {
-            const json_object_t json_object = va_arg(json_objects, json_object_t);
-            copy_json_object(&json_object, const_cast<json_object_t *>(&(objects[object_i])));
+            if (object_i == 0) {
+                copy_json_object(&first_object, &(objects[object_i]));
+            } else {
+                const json_object_t json_object = va_arg(json_objects, json_object_t);
+                copy_json_object(&json_object, &(objects[object_i]));
+            }
+        }
+        if (object_count > 0) {
+            note_json_command_error(objects[0]);
         }
 
-        //copy to queue
-        delayed_json_objects[queue_i].object_count = object_count;
-        delayed_json_objects[queue_i].objects = objects;
+        if (is_request) {
+            const json_object_t id_object = json_uint32("id", json_request_id);
+            copy_json_object(&id_object, &(objects[object_count]));
+        }
+
+        return add_delayed_json_objects(print_class, coalesce_key, json_template, objects, total_count);
 
     } else {
 
+        //already counted as a drop of its class
         deal_with_delay_printf_error();
 
-        //and dealloc any objects that couldn't be added
+        //and dealloc any objects that couldn't be added (an error that was dropped still counts)
         for (uint16_t object_i = 0; object_i<object_count; object_i++) {
-            const json_object_t json_object = va_arg(json_objects, json_object_t);
+            const json_object_t json_object = (object_i == 0) ? first_object : va_arg(json_objects, json_object_t);
+            if (object_i == 0) {
+                note_json_command_error(json_object);
+            }
             if (json_object.combined_params.is_array && json_object.combined_params.free_array_after_print) {
                 delete_array_for_value_type(json_object.combined_params.value_type, json_object.value.array_ptr);
             }
         }
+        return false;
     }
+}
+
+__attribute__((ramfunc))
+void delay_printf_json_objects(uint16_t object_count, ...) {
+    debug_timestamps.delay_printf_1 = CPU_TIMESTAMP;
+
+    if (!has_init_delayed_queue) {return;}
 
+    va_list json_objects;
+    va_start(json_objects, object_count);
+    internal_delay_printf_json_objects(print_class_event, print_coalesce_none, NULL, object_count, json_objects);
     va_end(json_objects);
 
     debug_timestamps.delay_printf_2 = CPU_TIMESTAMP;
 }
 
+__attribute__((ramfunc))
+bool delay_printf_json_class_objects(print_class_t print_class, print_coalesce_t coalesce_key, uint16_t object_count, ...) {
+    if (!has_init_delayed_queue) {return false;}
+
+    va_list json_objects;
+    va_start(json_objects, object_count);
+    const bool is_queued = internal_delay_printf_json_objects(print_class, coalesce_key, NULL, object_count, json_objects);
+    va_end(json_objects);
+
+    return is_queued;
+}
+
+//same as above, but only the values are printed (a NULL template is printed normally)
+__attribute__((ramfunc))
+void delay_printf_json_template(const json_template_t *const json_template, print_class_t print_class, print_coalesce_t coalesce_key, uint16_t object_count, ...) {
+    if (!has_init_delayed_queue) {return;}
+
+    va_list json_objects;
+    va_start(json_objects, object_count);
+    internal_delay_printf_json_objects(print_class, coalesce_key, json_template, object_count, json_objects);
+    va_end(json_objects);
+}
+
+//renders the objects once (the values are only used for their type), and keeps the text between the values
+//only call from init or the main loop
+json_template_t *create_json_template(uint16_t object_count, ...) {
+    if (object_count == 0) {return NULL;}
+
+    char *const text = create_array_of<char>(json_template_max_text, "json_template_text");
+    uint16_t *const starts = create_array_of<uint16_t>(json_template_max_values + 1, "json_template_starts");
+    if ((text == NULL) || (starts == NULL)) {
+        delete_array(text);
+        delete_array(starts);
+        return NULL;
+    }
+
+    //capture the text instead of printing it
+    json_template_text = text;
+    json_template_starts = starts;
+    json_template_starts[0] = 0;
+    json_template_text_i = 0;
+    json_template_value_i = 0;
+    json_template_overflow = false;
+
+    va_list json_objects;
+    va_start(json_objects, object_count);
+
+    uint16_t object_child_count = 0;
+    for (uint16_t object_i = 0; object_i<object_count; object_i++) {
+        const json_object_t json_object = va_arg(json_objects, json_object_t);
+        internal_inner_print_json_objects(json_object, object_i, object_count, object_child_count);
+    }
+
+    va_end(json_objects);
+
+    json_text_char('\0');
+    const uint16_t text_length = json_template_text_i;
+    const uint16_t value_count = json_template_value_i;
+    const bool overflow = json_template_overflow;
+    json_template_text = NULL;
+    json_template_starts = NULL;
+
+    //keep only what was used
+    json_template_t *json_template = NULL;
+    if (overflow) {
+        delay_printf_json_objects(2, json_string("error", "json template is too long"), json_uint16("max_length", json_template_max_text));
+    } else {
+        json_template = create_array_of<json_template_t>(1, "json_template");
+        char *const template_text = create_array_of<char>(text_length, "json_template_text");
+        uint16_t *const template_starts = create_array_of<uint16_t>(value_count + 1, "json_template_starts");
+
+        if ((json_template != NULL) && (template_text != NULL) && (template_starts != NULL)) {
+            memcpy_fast_of<char>(template_text, text, text_length);
+            memcpy_fast_of<uint16_t>(template_starts, starts, value_count + 1);
+            json_template->object_count = object_count;
+            json_template->value_count = value_count;
+            json_template->text = template_text;
+            json_template->starts = template_starts;
+        } else {
+            delete_array(json_template);
+            delete_array(template_text);
+            delete_array(template_starts);
+            json_template = NULL;
+        }
+    }
+
+    delete_array(text);
+    delete_array(starts);
+    return json_template;
+}
+
+//the text before each value is copied at once, then only the values are printed
+__attribute__((ramfunc))
+void internal_print_json_template(const json_template_t *const json_template, const json_object_t *const objects, uint16_t object_count) {
+    uint16_t value_i = 0;
+
+    for (uint16_t object_i = 0; object_i<object_count; object_i++) {
+        json_object_t json_object;
+        copy_json_object(&(objects[object_i]), &json_object);
+
+        if (is_json_template_value(json_object) && (value_i < json_template->value_count)) {
+            printf_string(&(json_template->text[json_template->starts[value_i]]));
+            internal_printf_json_value(json_object);
+            value_i++;
+        }
+
+        //set the callback bool pointer, if defined
+        if (json_object.is_printing_bool_ptr != NULL) {
+            *(json_object.is_printing_bool_ptr) = false;
+        }
+    }
+
+    //the closing text
+    printf_string(&(json_template->text[json_template->starts[json_template->value_count]]));
+}
+
 void printf_json_error(const char *const error_string) {
     printf_json_objects(1, json_string("error", error_string));
 }
@@ -386,11 +932,34 @@ void delay_printf_json_status(const char *const text_string) {
 __attribute__((ramfunc))
 void internal_printf_json_object(const json_object_t &json_object) {
     //print the string and colon
-    printf_char('"');
-    printf_string(json_object.parameter_name);
-    printf_string("\":");
+    json_text_char('"');
+    json_text_string(json_object.parameter_name);
+    json_text_string("\":");
+
+    //for a template, the text so far is before this value
+    if (json_template_text != NULL) {
+        if (is_json_template_value(json_object)) {
+            json_text_char('\0');
+            if (json_template_value_i < json_template_max_values) {
+                json_template_starts[json_template_value_i + 1] = json_template_text_i;
+                json_template_value_i++;
+            } else {
+                json_template_overflow = true;
+            }
+        } else {
+            json_text_char('"');
+            json_text_string(json_object.value.string_);
+            json_text_char('"');
+        }
+        return;
+    }
+
+    internal_printf_json_value(json_object);
+}
 
-    //then print the value or array
+__attribute__((ramfunc))
+void internal_printf_json_value(const json_object_t &json_object) {
+    //print the value or array
     //all pointers inside pointer union should be the same (just test against NULL)
     if (json_object.combined_params.is_array) {
         internal_printf_array(json_object.combined_params.value_type, json_object.array_count, json_object.value.array_ptr, json_object.combined_params.precision);
@@ -476,7 +1045,7 @@ __attribute__((ramfunc))
 void internal_printf_array(value_type_t value_type, uint16_t array_count, const array_ptr_union_t values_ptr, uint16_t precision_or_sig_figs) {
 
     //open the array
-    if (value_type == t_base64) {
+    if ((value_type == t_base64) || (value_type == t_delta_varint)) {
         printf_char('\"');
     } else {
         printf_char('[');
@@ -489,6 +1058,10 @@ void internal_printf_array(value_type_t value_type, uint16_t array_count, const
             print_base64_array(values_ptr.uint16_, array_count, precision_or_sig_figs);
             break;
 
+        case t_delta_varint:
+            print_delta_varint_array(values_ptr.uint16_, array_count);
+            break;
+
         default:
             for (uint16_t value_index=0; value_index<array_count; value_index++) {
                 //the values_ptr union should be a pointer to all
@@ -502,13 +1075,124 @@ void internal_printf_array(value_type_t value_type, uint16_t array_count, const
     }
 
     //close the array
-    if (value_type == t_base64) {
+    if ((value_type == t_base64) || (value_type == t_delta_varint)) {
         printf_char('\"');
     } else {
         printf_char(']');
     }
 }
 
+//binary message record:
+//  header: record type (1 byte), uptime count (8 bytes), object count (2 bytes)
+//  object: value type (1 byte, 0x80 set for arrays), name (null terminated), then
+//          parent: child count (2 bytes)
+//          array:  value count (2 bytes), then each value
+//          value:  bool (1 byte), 16/32/64 bit values (little-endian), strings (null terminated)
+__attribute__((ramfunc))
+void internal_binary_json_object(const json_object_t &json_object, uint16_t object_i, uint16_t object_count) {
+    if (object_i == 0) {
+        binary_frame_begin(binary_record_message, get_uptime_count());
+        binary_frame_put_uint16(object_count);
+    }
+
+    const value_type_t value_type = json_object.combined_params.value_type;
+    const bool is_array = json_object.combined_params.is_array;
+
+    binary_frame_put_byte(static_cast<uint16_t>(value_type) | (is_array ? 0x80 : 0x00));
+    binary_frame_put_string(json_object.parameter_name);
+
+    if (value_type == t_parent) {
+        binary_frame_put_uint16(json_object.array_count);
+
+    } else if (is_array) {
+        binary_frame_put_uint16(json_object.array_count);
+
+        //base64 and delta varint are only text encodings, so send the raw uint16 values
+        const value_type_t array_type = ((value_type == t_base64) || (value_type == t_delta_varint)) ? t_uint16 : value_type;
+        for (uint16_t value_index=0; value_index<json_object.array_count; value_index++) {
+            internal_binary_value(array_type, json_object.value.array_ptr.bool_, value_index);
+        }
+
+        //now that it has been sent, free the pointer (if necessary)
+        if (json_object.combined_params.free_array_after_print) {
+            delete_array_for_value_type(value_type, json_object.value.array_ptr);
+        }
+
+    } else {
+        internal_binary_value(value_type, &(json_object.value), 0);
+    }
+
+    if (object_i == (object_count - 1)) {
+        binary_frame_end();
+    }
+}
+
+__attribute__((ramfunc))
+void internal_binary_value(value_type_t value_type, const void *const value_ptr, uint16_t index) {
+    //the float types are sent as their raw IEEE-754 bits
+    union {
+        float32 float32_;
+        uint32_t uint32_;
+    } float32_bits;
+
+    union {
+        float64 float64_;
+        uint64_t uint64_;
+    } float64_bits;
+
+    switch (value_type) {
+        //16 bits
+        case t_bool:
+            binary_frame_put_byte((reinterpret_cast<const bool *>(value_ptr))[index] ? 1 : 0);
+            break;
+
+        case t_uint16:
+            binary_frame_put_uint16( (reinterpret_cast<const uint16_t *>(value_ptr))[index] );
+            break;
+
+        case t_int16:
+            binary_frame_put_uint16(static_cast<uint16_t>( (reinterpret_cast<const int16_t *>(value_ptr))[index] ));
+            break;
+
+        //32 bits
+        case t_uint32:
+            binary_frame_put_uint32( (reinterpret_cast<const uint32_t *>(value_ptr))[index] );
+            break;
+
+        case t_int32:
+            binary_frame_put_uint32(static_cast<uint32_t>( (reinterpret_cast<const int32_t *>(value_ptr))[index] ));
+            break;
+
+        case t_string:
+            binary_frame_put_string(reinterpret_cast<char **>(const_cast<void *>(value_ptr))[index]);
+            break;
+
+        case t_float32:
+            float32_bits.float32_ = (reinterpret_cast<const float32 *>(value_ptr))[index];
+            binary_frame_put_uint32(float32_bits.uint32_);
+            break;
+
+        //64 bits (timestamps are sent as raw tics)
+        case t_uint64:
+        case t_timestamp:
+            binary_frame_put_uint64( (reinterpret_cast<const uint64_t *>(value_ptr))[index] );
+            break;
+
+        case t_int64:
+            binary_frame_put_uint64(static_cast<uint64_t>( (reinterpret_cast<const int64_t *>(value_ptr))[index] ));
+            break;
+
+        case t_float64:
+            float64_bits.float64_ = (reinterpret_cast<const float64 *>(value_ptr))[index];
+            binary_frame_put_uint64(float64_bits.uint64_);
+            break;
+
+        //default (nothing is sent, which the decoder will see as a bad record)
+        default:
+            break;
+    }
+}
+
 const char *json_type_name(jsonType_t json_type) {
     const char *name = "error";
 
@@ -593,6 +1277,10 @@ const char *value_type_name(value_type_t value_type) {
             name = "base64";
             break;
 
+        case t_delta_varint:
+            name = "delta_varint";
+            break;
+
         case t_timestamp:
             name = "t_timestamp";
             break;
@@ -725,7 +1413,7 @@ json_object_t json_bool_array(const char *const parameter_name, uint16_t array_c
     if (copy) {
         bool *const copy_array = create_array_of<bool>(array_count, "json_bool_array");
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count);    //bool is 16bits
+            memcpy_fast_of<bool>(copy_array, array, array_count);
             json_object.value.array_ptr.bool_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -749,7 +1437,7 @@ json_object_t json_uint16_array(const char *const parameter_name, uint16_t array
         uint16_t *const copy_array = create_array_of<uint16_t>(array_count, "json_uint16_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count);    //uint16_t is 16bits
+            memcpy_fast_of<uint16_t>(copy_array, array, array_count);
             json_object.value.array_ptr.uint16_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -773,7 +1461,7 @@ json_object_t json_int16_array(const char *const parameter_name, uint16_t array_
         int16_t *const copy_array = create_array_of<int16_t>(array_count, "json_int16_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count);    //int16_t is 16bits
+            memcpy_fast_of<int16_t>(copy_array, array, array_count);
             json_object.value.array_ptr.int16_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -797,7 +1485,7 @@ json_object_t json_uint32_array(const char *const parameter_name, uint16_t array
         uint32_t *const copy_array = create_array_of<uint32_t>(array_count, "json_uint32_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count * 2);    //uint32_t is 32bits
+            memcpy_fast_of<uint32_t>(copy_array, array, array_count);
             json_object.value.array_ptr.uint32_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -821,7 +1509,7 @@ json_object_t json_int32_array(const char *const parameter_name, uint16_t array_
         int32_t *const copy_array = create_array_of<int32_t>(array_count, "json_int32_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count);    //int32_t is 32bits
+            memcpy_fast_of<int32_t>(copy_array, array, array_count);
             json_object.value.array_ptr.int32_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -846,7 +1534,7 @@ json_object_t json_float32_array(const char *const parameter_name, uint16_t arra
         float32 *const copy_array = create_array_of<float32>(array_count, "json_float32_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count * 2);    //float32 is 32bits
+            memcpy_fast_of<float32>(copy_array, array, array_count);
             json_object.value.array_ptr.float32_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -870,7 +1558,7 @@ json_object_t json_string_array(const char *const parameter_name, uint16_t array
         char **const copy_array = create_array_of<char *>(array_count, "json_string_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count * 2);    //*char is 32bits
+            memcpy_fast_of<char *>(copy_array, array, array_count);
             json_object.value.array_ptr.string_ = const_cast<const char**>(copy_array);    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -894,7 +1582,7 @@ json_object_t json_uint64_array(const char *const parameter_name, uint16_t array
         uint64_t *const copy_array = create_array_of<uint64_t>(array_count, "json_uint64_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count * 4);    //uint64_t is 64bits
+            memcpy_fast_of<uint64_t>(copy_array, array, array_count);
             json_object.value.array_ptr.uint64_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -918,7 +1606,7 @@ json_object_t json_int64_array(const char *const parameter_name, uint16_t array_
         int64_t *const copy_array = create_array_of<int64_t>(array_count, "json_int64_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count * 4);    //int64_t is 64bits
+            memcpy_fast_of<int64_t>(copy_array, array, array_count);
             json_object.value.array_ptr.int64_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -943,7 +1631,7 @@ json_object_t json_float64_array(const char *const parameter_name, uint16_t arra
         float64 *const copy_array = create_array_of<float64>(array_count, "json_float64_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count * 4);    //float64 is 64bits
+            memcpy_fast_of<float64>(copy_array, array, array_count);
             json_object.value.array_ptr.float64_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -969,7 +1657,32 @@ json_object_t json_base64_array(const char *const parameter_name, uint16_t array
         uint16_t *const copy_array = create_array_of<uint16_t>(array_count, "json_base64_array");
 
         if (copy_array != NULL) {
-            memcpy_fast(copy_array, array, array_count);
+            memcpy_fast_of<uint16_t>(copy_array, array, array_count);
+            json_object.value.array_ptr.uint16_ = copy_array;    //store the copy
+        } else {
+            error_allocating_array(json_object);
+        }
+    } else {
+        json_object.value.array_ptr.uint16_ = array;         //store the original pointer
+    }
+
+    return json_object;
+}
+
+json_object_t json_delta_varint_array(const char *const parameter_name, uint16_t array_count, const uint16_t *const array, bool copy) {
+    json_object_t json_object = blank_json_object;
+
+    json_object.parameter_name = parameter_name;
+    json_object.combined_params.value_type = t_delta_varint;
+    json_object.array_count = array_count;
+    json_object.combined_params.is_array = true;
+    json_object.combined_params.free_array_after_print = copy;
+
+    if (copy) {
+        uint16_t *const copy_array = create_array_of<uint16_t>(array_count, "json_delta_varint_array");
+
+        if (copy_array != NULL) {
+            memcpy_fast_of<uint16_t>(copy_array, array, array_count);
             json_object.value.array_ptr.uint16_ = copy_array;    //store the copy
         } else {
             error_allocating_array(json_object);
@@ -1093,6 +1806,7 @@ void delete_array_for_value_type(value_type_t value_type, const array_ptr_union_
             break;
 
         case t_base64:
+        case t_delta_varint:
             delete_array(array_ptr.uint16_);
             break;
 
@@ -14,19 +14,84 @@
 #include "printf_json_types.h"
 
 
+//priority classes (most important first), the queue always prints the most important class first
+typedef enum {
+    print_class_error,      //any message where the first object is named "error"
+    print_class_event,      //targets, transitions, and command replies (the default)
+    print_class_telemetry,  //periodic messages
+    print_class_debug,      //tests and diagnostics
+    print_class_count
+} print_class_t;
+
+//a newer unsent message replaces an older unsent one with the same key (none is never replaced)
+static const uint16_t print_coalesce_readout_count = 32;
+typedef enum {
+    print_coalesce_none,
+    print_coalesce_queue_full,
+    print_coalesce_uptime,
+    print_coalesce_status_tic_toc,
+    print_coalesce_digital_in_values,
+    print_coalesce_analog_in_values,
+    print_coalesce_digital_out_values,
+    print_coalesce_input_readout,   //plus the input number (if less than the readout count)
+    print_coalesce_count = print_coalesce_input_readout + print_coalesce_readout_count
+} print_coalesce_t;
+
 typedef struct delayed_json_t {
     uint16_t object_count;
     json_object_t *objects;
 } delayed_json_t;
 
+//a message with a fixed shape, where the names, brackets, and string values are rendered once (when created)
+//when printed, only the other values are, so the objects must be the same shape as when it was created
+typedef struct json_template_t {
+    uint16_t object_count;
+    uint16_t value_count;       //objects that are printed each time
+    const char *text;           //the text before each value, then the closing text (each null terminated)
+    const uint16_t *starts;     //start of each in the text (value_count + 1)
+} json_template_t;
+
+typedef struct delayed_json_statistics_t {
+    uint16_t queue_length;
+    uint16_t queue_in_use;
+    uint16_t slot_count;
+    uint16_t slot_objects;      //max objects per slot
+    uint16_t slots_in_use;
+    uint16_t max_slots_in_use;  //high-water mark
+    uint32_t slot_failures;     //messages dropped because no slot was free
+    uint32_t heap_messages;     //messages too large for a slot
+    float32 print_max_us;       //longest time to render and copy one message
+    uint32_t class_drops[print_class_count];    //messages dropped because their class was out of room
+    uint32_t coalesced;         //messages replaced by a newer one before being sent
+} delayed_json_statistics_t;
+
 
 //delayed init and actual print
 bool init_delayed_json_object_queue();
 void printf_delayed_json_objects(bool print_all = false);
 
+//objects for a delayed_json_t (released once printed)
+json_object_t *create_delayed_json_objects(uint16_t object_count, print_class_t print_class = print_class_event);
+void release_delayed_json_objects(const json_object_t *const objects);
+delayed_json_statistics_t get_delayed_json_statistics(bool reset);
+uint16_t get_delayed_json_class_available(print_class_t print_class);
+
 //delay print json objects
 void delay_printf_json_objects(uint16_t object_count, ...);
 void delay_printf_json_objects(const delayed_json_t delayed_json_object);
+bool delay_printf_json_class_objects(print_class_t print_class, print_coalesce_t coalesce_key, uint16_t object_count, ...);   //false if it was dropped
+
+//while set, every message the command queues (outside of any interrupt) ends with an "id" object
+void set_delayed_json_request_id(uint32_t request_id);
+void clear_delayed_json_request_id();
+
+//while watching, any error message the command queues (outside of any interrupt) is noted, so a caller can tell it failed
+void watch_delayed_json_command_errors();
+bool end_watch_delayed_json_command_errors();   //true if the command queued an error
+
+//templates (create only from init or the main loop, and they are never freed)
+json_template_t *create_json_template(uint16_t object_count, ...);
+void delay_printf_json_template(const json_template_t *const json_template, print_class_t print_class, print_coalesce_t coalesce_key, uint16_t object_count, ...);
 
 //helper functions with pre-defined json_string
 void delay_printf_json_error(const char *const error_string);
@@ -38,6 +38,7 @@ typedef enum {
 
     //compressed types
     t_base64,
+    t_delta_varint,
 
     //timestamp
     t_timestamp,
@@ -133,6 +134,7 @@ json_object_t json_int64_array(const char *const parameter_name, uint16_t array_
 json_object_t json_float64_array(const char *const parameter_name, uint16_t array_count, const float64 *const array, bool copy = false, uint16_t float_precision = 15);
 json_object_t json_string_array(const char *const parameter_name, uint16_t array_count, const char **const array, bool copy = false);
 json_object_t json_base64_array(const char *const parameter_name, uint16_t array_count, const uint16_t *const array, bool copy = false, uint16_t bits = 16);
+json_object_t json_delta_varint_array(const char *const parameter_name, uint16_t array_count, const uint16_t *const array, bool copy = false);
 
 
 //helpers
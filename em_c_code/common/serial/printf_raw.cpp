@@ -13,66 +13,234 @@
 #include <printf_json_delayed.h>
 
 
+//largest formatted value ("0." + 31 zeros, or "0." + 31 shift zeros + 20 digits), and the terminator
+static const uint16_t format_buffer_length = 56;
+
+//two digits per lookup (the pair for a value is at value*2)
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+
+//writes the digits right to left (ending just before buffer_end), padded with zeros to min_digits
+//returns the digit count
 __attribute__((ramfunc))
-void print_all_int_except_uint64_value(int64_t value) {
-    //simple case is 0
-    if (value == 0) {
-        printf_char('0');
-        return;
+static uint16_t format_uint32(uint32_t value, char *const buffer_end, uint16_t min_digits) {
+    char *c = buffer_end;
+
+    //two digits at a time, with 32bit division until the value fits in 16bits
+    while (value > 0xFFFF) {
+        const uint32_t quotient = value / 100;
+        const uint16_t pair_i = static_cast<uint16_t>(value - quotient * 100) * 2;
+        value = quotient;
+        *(--c) = digit_pairs[pair_i + 1];
+        *(--c) = digit_pairs[pair_i];
+    }
+
+    uint16_t value16 = static_cast<uint16_t>(value);
+    while (value16 >= 100) {
+        const uint16_t quotient = value16 / 100;
+        const uint16_t pair_i = (value16 - quotient * 100) * 2;
+        value16 = quotient;
+        *(--c) = digit_pairs[pair_i + 1];
+        *(--c) = digit_pairs[pair_i];
+    }
+
+    if (value16 >= 10) {
+        *(--c) = digit_pairs[value16 * 2 + 1];
+        *(--c) = digit_pairs[value16 * 2];
+    } else {
+        *(--c) = '0' + static_cast<char>(value16);
     }
 
-    //print and remove the negative sign
-    bool is_LLONG_MIN = false;
-    if (value < 0) {
-        printf_char('-');
+    uint16_t count = buffer_end - c;
+    while (count < min_digits) {
+        *(--c) = '0';
+        count++;
+    }
+
+    return count;
+}
+
+//same as above, but with at most two 64bit divisions (each removes 9 digits)
+__attribute__((ramfunc))
+static uint16_t format_uint64(uint64_t value, char *const buffer_end) {
+    uint16_t count = 0;
+
+    while (value > 0xFFFFFFFF) {
+        const uint64_t quotient = value / 1000000000;
+        const uint32_t remainder = static_cast<uint32_t>(value - quotient * 1000000000);
+        value = quotient;
+        count += format_uint32(remainder, buffer_end - count, 9);
+    }
+
+    return count + format_uint32(static_cast<uint32_t>(value), buffer_end - count, 0);
+}
+
+//the last decimal digit (2^32 is 6 mod 10, so two 32bit remainders instead of a 64bit one)
+__attribute__((ramfunc))
+static uint16_t ones_digit(uint64_t value) {
+    if ((value >> 32) == 0) {
+        return static_cast<uint16_t>(static_cast<uint32_t>(value) % 10);
+    }
+
+    const uint16_t upper_digit = static_cast<uint16_t>(static_cast<uint32_t>(value >> 32) % 10);
+    const uint16_t lower_digit = static_cast<uint16_t>(static_cast<uint32_t>(value & 0xFFFFFFFF) % 10);
+    return (upper_digit * 6 + lower_digit) % 10;
+}
+
+//writes the first digit_count fraction digits of mantissa * 2^exponent, the same digits as multiplying the whole float by 10:
+//every step rounds back to the float's mantissa_bits (to nearest, ties to even), so 0.7f (0.69999998) still prints 0.7000
+//only integer multiplies and shifts, and the mantissa never needs more than mantissa_bits + 4 bits
+__attribute__((ramfunc))
+static void format_fraction(uint64_t mantissa, int16_t exponent, uint16_t mantissa_bits, char *const buffer, uint16_t digit_count) {
+    const uint64_t mantissa_limit = static_cast<uint64_t>(1) << mantissa_bits;
+
+    for (uint16_t i=0; i<digit_count; i++) {
+        mantissa *= 10;
+
+        //round off the (at most 4) bits past the float's precision
+        uint16_t extra_bits = 0;
+        while ((mantissa >> extra_bits) >= mantissa_limit) {
+            extra_bits++;
+        }
+        if (extra_bits > 0) {
+            const uint64_t dropped = mantissa & ((static_cast<uint64_t>(1) << extra_bits) - 1);
+            const uint64_t half = static_cast<uint64_t>(1) << (extra_bits - 1);
+            mantissa >>= extra_bits;
+            exponent += extra_bits;
+
+            if ((dropped > half) || ((dropped == half) && ((mantissa & 1) != 0))) {
+                mantissa++;
+                if (mantissa == mantissa_limit) {
+                    mantissa >>= 1;
+                    exponent++;
+                }
+            }
+        }
+
+        //the digit is the ones place of the integer part (the significant figures keep it below 10^15)
+        uint64_t i_part = 0;
+        if (exponent >= 0) {
+            i_part = mantissa << exponent;
+        } else if (exponent > -64) {
+            i_part = mantissa >> (-exponent);
+        }
+        buffer[i] = '0' + static_cast<char>(ones_digit(i_part));
+    }
+}
+
+//prints mantissa * 2^exponent (already positive and less than 2^64)
+//the integer part is always printed, and the fraction gets whatever is left of the significant figures
+__attribute__((ramfunc))
+static void print_fixed_value(bool is_negative, uint64_t mantissa, int16_t exponent, uint16_t mantissa_bits, uint16_t max_sig_figs, uint16_t precision) {
+    char buffer[format_buffer_length];
+    char *const integer_end = &buffer[22];
+    char *start = integer_end;
+
+    //the integer part
+    uint64_t i_part = 0;
+    if (exponent >= 0) {
+        i_part = mantissa << exponent;
+    } else if (exponent > -64) {
+        i_part = mantissa >> (-exponent);
+    }
+
+    //get the integer characters
+    if (i_part == 0) {
+        *(--start) = '0';
+    } else {
+        const uint16_t index = format_uint64(i_part, integer_end);
+        start -= index;
 
-        if (value != LLONG_MIN) {
-            value = -value;
+        if (index < max_sig_figs) {
+            max_sig_figs -= index;
         } else {
-            is_LLONG_MIN = true;
-            value = LLONG_MAX;
+            max_sig_figs = 0;
         }
     }
 
-    //get the characters
-    char buffer[19];
-    uint16_t index = 0;
-    while (value > 0) {
-        buffer[index] = '0' + static_cast<char>(value % 10);
-        value /= 10;
-        index++;
+    if (is_negative) {
+        *(--start) = '-';
     }
 
-    if (is_LLONG_MIN) {
-        buffer[0] = '8';
+    if (max_sig_figs > precision) {
+        max_sig_figs = precision;
     }
 
-    //reverse print
-    while ((index--) > 0) {
-        printf_char(static_cast<uint16_t>(buffer[index]));
+    //the fractional part
+    uint16_t end_i = integer_end - buffer;
+    if (max_sig_figs > 0) {
+        buffer[end_i] = '.';
+        end_i++;
+        format_fraction(mantissa, exponent, mantissa_bits, &buffer[end_i], max_sig_figs);
+        end_i += max_sig_figs;
     }
+
+    buffer[end_i] = '\0';
+    printf_string(start);
 }
 
+//zero is printed as 0.xxx (for both the floats and timestamps)
 __attribute__((ramfunc))
-void print_uint64_value(uint64_t value) {
+static void print_zero_value(uint16_t zero_count) {
+    char buffer[format_buffer_length];
+    buffer[0] = '0';
+    buffer[1] = '.';
+
+    uint16_t end_i = 2;
+    while ((zero_count > 0) && (end_i < (format_buffer_length - 1))) {
+        buffer[end_i] = '0';
+        end_i++;
+        zero_count--;
+    }
+
+    buffer[end_i] = '\0';
+    printf_string(buffer);
+}
+
+
+__attribute__((ramfunc))
+void print_all_int_except_uint64_value(int64_t value) {
     //simple case is 0
     if (value == 0) {
         printf_char('0');
         return;
     }
 
-    char buffer[20];
-    uint16_t index = 0;
-    while (value > 0) {
-        buffer[index] = '0' + static_cast<char>(value % 10);
-        value /= 10;
-        index++;
+    char buffer[21];
+    char *const buffer_end = &buffer[20];
+    *buffer_end = '\0';
+
+    //negating as unsigned also works for LLONG_MIN
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if (value < 0) {
+        magnitude = (~magnitude) + 1;
     }
 
-    //reverse print
-    while ((index--) > 0) {
-        printf_char(static_cast<uint16_t>(buffer[index]));
+    char *start = buffer_end - format_uint64(magnitude, buffer_end);
+    if (value < 0) {
+        *(--start) = '-';
     }
+
+    printf_string(start);
+}
+
+__attribute__((ramfunc))
+void print_uint64_value(uint64_t value) {
+    char buffer[21];
+    char *const buffer_end = &buffer[20];
+    *buffer_end = '\0';
+
+    printf_string(buffer_end - format_uint64(value, buffer_end));
 }
 
 __attribute__((ramfunc))
@@ -80,48 +248,42 @@ void print_uint64_timestamp(uint64_t timestamp, uint64_t ts_multiplier, uint16_t
 
     //simple case is 0 (just print 0.xxxx)
     if (timestamp == 0) {
-        printf_char('0');
-        printf_char('.');
-        for (uint16_t i=0; i<ts_shift; i++) {
-            printf_char('0');
-        }
+        print_zero_value(ts_shift);
         return;
     }
 
     //first step, multiply
     timestamp *= ts_multiplier;
 
-    char buffer[20];
-    uint16_t index = 0;
-    while (timestamp > 0) {
-        buffer[index] = '0' + static_cast<char>(timestamp % 10);
-        timestamp /= 10;
-        index++;
-    }
+    char digits[20];
+    const uint16_t index = format_uint64(timestamp, &digits[20]);
+    const char *digit = &digits[20 - index];
+
+    char buffer[format_buffer_length];
+    uint16_t buffer_i = 0;
 
     //if smaller than 0, print out the beginning
     uint16_t print_before_period = 0;
     if (index <= ts_shift) {
-        printf_char('0');
-        printf_char('.');
-        for (uint16_t i=index; i<ts_shift; i++) {
-            printf_char('0');
+        buffer[buffer_i++] = '0';
+        buffer[buffer_i++] = '.';
+        for (uint16_t i=index; (i<ts_shift) && (buffer_i < (format_buffer_length - 22)); i++) {
+            buffer[buffer_i++] = '0';
         }
     } else {
         print_before_period = index - ts_shift;
     }
 
-    uint16_t places_count = 0;
-    //reverse print
-    while (index > 0) {
-        index--;
-        printf_char(static_cast<uint16_t>(buffer[index]));
+    for (uint16_t places_count=1; places_count<=index; places_count++) {
+        buffer[buffer_i++] = *(digit++);
 
-        places_count++;
         if (places_count == print_before_period) {
-            printf_char('.');
+            buffer[buffer_i++] = '.';
         }
     }
+
+    buffer[buffer_i] = '\0';
+    printf_string(buffer);
 }
 
 
@@ -129,11 +291,7 @@ __attribute__((ramfunc))
 void print_float32_value(float32 value, uint16_t precision) {
     //simple case is 0
     if (value == 0.0) {
-        printf_string("0");
-        printf_char('.');
-        for (uint16_t i=0; i<precision; i++) {
-            printf_char('0');
-        }
+        print_zero_value(precision);
         return;
     }
 
@@ -149,77 +307,44 @@ void print_float32_value(float32 value, uint16_t precision) {
         return;
     }
 
-    //print and remove the negative sign
-    if (value < 0.0) {
-        printf_char('-');
+    //remove the negative sign
+    const bool is_negative = (value < 0.0);
+    if (is_negative) {
         value = -value;
     }
 
     //not really infinite, but too large to work with
-    if (value > static_cast<float32>(ULLONG_MAX)) {
+    if (value >= static_cast<float32>(ULLONG_MAX)) {
+        if (is_negative) {
+            printf_char('-');
+        }
         printf_string("inf");
         return;
     }
 
-    //get the integer characters
-    uint64_t i_part = static_cast<uint64_t>(floor(value));
-    uint16_t max_sig_figs = 7;
-
-    if (i_part == 0) {
-        printf_char('0');
-    } else {
-        char buffer[20];
-        uint16_t index = 0;
-
-        while (i_part > 0) {
-            buffer[index] = '0' + static_cast<char>(i_part % 10);
-            i_part /= 10;
-            index++;
-        }
-
-        if (index < max_sig_figs) {
-            max_sig_figs -= index;
-        } else {
-            max_sig_figs = 0;
-        }
-
-        //reverse print
-        while ((index--) > 0) {
-            printf_char(static_cast<uint16_t>(buffer[index]));
-        }
-    }
-
-    if (max_sig_figs > precision) {
-        max_sig_figs = precision;
-    }
+    //split the bits (the value is exactly mantissa * 2^exponent)
+    union {
+        float32 value;
+        uint32_t bits;
+    } float_bits;
+    float_bits.value = value;
 
-    if (max_sig_figs <= 0) {
-        return;
+    const uint16_t biased_exponent = static_cast<uint16_t>((float_bits.bits >> 23) & 0xFF);
+    uint64_t mantissa = float_bits.bits & 0x007FFFFF;
+    int16_t exponent = -149;
+    if (biased_exponent != 0) {
+        mantissa |= 0x00800000;
+        exponent = static_cast<int16_t>(biased_exponent) - 150;
     }
 
-    //print the fractional part
-    printf_char('.');
-
-    //remove the integer part
-    value -= static_cast<float32>(i_part);
-
-    for (uint16_t i=0; i<max_sig_figs; i++) {
-        value *= 10.0;
-        i_part = static_cast<uint64_t>(value);
-        i_part = i_part % 10;
-        printf_char(static_cast<uint16_t>('0') + static_cast<uint16_t>(i_part));
-    }
+    print_fixed_value(is_negative, mantissa, exponent, 24, 7, precision);
 }
 
 __attribute__((ramfunc))
 void print_float64_value(float64 value, uint16_t precision) {
     //simple case is 0
     if (value == 0.0) {
-        printf_string("0");
-        printf_char('.');
-        for (uint16_t i=0; i<precision; i++) {
-            printf_char('0');
-        }
+        print_zero_value(precision);
         return;
     }
 
@@ -235,68 +360,40 @@ void print_float64_value(float64 value, uint16_t precision) {
         return;
     }
 
-    //print and remove the negative sign
-    if (value < 0.0L) {
-        printf_char('-');
+    //remove the negative sign
+    const bool is_negative = (value < 0.0L);
+    if (is_negative) {
         value = -value;
     }
 
     //not really infinite, but too large to work with
-    if (value > static_cast<float64>(ULLONG_MAX)) {
+    if (value >= static_cast<float64>(ULLONG_MAX)) {
+        if (is_negative) {
+            printf_char('-');
+        }
         printf_string("inf");
         return;
     }
 
-    //get the integer characters
-    uint64_t i_part = static_cast<uint64_t>(floorl(value));
-    uint16_t max_sig_figs = 15;
-
-    if (i_part == 0) {
-        printf_char('0');
-    } else {
-        char buffer[20];
-        uint16_t index = 0;
-
-        while (i_part > 0) {
-            buffer[index] = '0' + static_cast<char>(i_part % 10);
-            i_part /= 10;
-            index++;
-        }
-
-        if (index < max_sig_figs) {
-            max_sig_figs -= index;
-        } else {
-            max_sig_figs = 0;
-        }
-
-        //reverse print
-        while ((index--) > 0) {
-            printf_char(static_cast<uint16_t>(buffer[index]));
-        }
-    }
+    //split the bits (the value is exactly mantissa * 2^exponent)
+    union {
+        float64 value;
+        uint64_t bits;
+    } float_bits;
+    float_bits.value = value;
 
-    if (max_sig_figs > precision) {
-        max_sig_figs = precision;
+    const uint16_t biased_exponent = static_cast<uint16_t>((float_bits.bits >> 52) & 0x7FF);
+    uint64_t mantissa = float_bits.bits & 0x000FFFFFFFFFFFFF;
+    int16_t exponent = -1074;
+    if (biased_exponent != 0) {
+        mantissa |= 0x0010000000000000;
+        exponent = static_cast<int16_t>(biased_exponent) - 1075;
     }
 
-    if (max_sig_figs <= 0) {
-        return;
-    }
-
-    //print the fractional part
-    printf_char('.');
-
-    //remove the integer part
-    value -= static_cast<float64>(i_part);
-
-    for (uint16_t i=0; i<max_sig_figs; i++) {
-        value *= 10.0L;
-        i_part = static_cast<uint64_t>(value);
-        i_part = i_part % 10;
-        printf_char(static_cast<uint16_t>('0') + static_cast<uint16_t>(i_part));
-    }
+    print_fixed_value(is_negative, mantissa, exponent, 53, 15, precision);
 }
 
+
 //keeping around for posterity
 void print_compress1_base(uint32_t value) {
 
@@ -434,7 +531,58 @@ void print_base64_array(const uint16_t *const array_ptr, uint16_t array_count, u
     }
 
     //padding
-    uint16_t pad_count = fmodf(4 - char_count_sent, 4);
+    const uint16_t pad_count = (4 - (char_count_sent & 0b11)) & 0b11;
+    for (uint16_t pad_i=0; pad_i<pad_count; pad_i++) {
+        printf_char('=');
+    }
+}
+
+__attribute__((ramfunc))
+void print_delta_varint_array(const uint16_t *const array_ptr, uint16_t array_count) {
+    //same header as base64, but with 0 for the bits
+    //then the first value (16 bits), and every other value as a zig-zag varint of the delta from the previous
+    //varints are 7 bits per byte (lowest first), with the high bit set when more bytes follow
+
+    if (array_count == 0) {
+        return;
+    }
+
+    uint32_t base64_buffer = 0;
+    uint16_t base64_buffer_len = 0;
+    uint16_t char_count_sent = 0;
+
+    //print the format and count as the first 4 chars
+    add_to_buffer(0, 8, &base64_buffer, &base64_buffer_len);
+    add_to_buffer(array_count, 16, &base64_buffer, &base64_buffer_len);
+    char_count_sent += remove_and_send_base64_char(base64_buffer, &base64_buffer_len);
+
+    //first value is raw
+    add_to_buffer(array_ptr[0], 16, &base64_buffer, &base64_buffer_len);
+    char_count_sent += remove_and_send_base64_char(base64_buffer, &base64_buffer_len);
+
+    for (uint16_t array_index=1; array_index<array_count; array_index++) {
+        const int32_t delta = static_cast<int32_t>(array_ptr[array_index]) - static_cast<int32_t>(array_ptr[array_index - 1]);
+        uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+
+        //at most 3 bytes, since the delta is at most 17 bits
+        while (zigzag > 0x7F) {
+            add_to_buffer((zigzag & 0x7F) | 0x80, 8, &base64_buffer, &base64_buffer_len);
+            char_count_sent += remove_and_send_base64_char(base64_buffer, &base64_buffer_len);
+            zigzag = zigzag >> 7;
+        }
+        add_to_buffer(zigzag, 8, &base64_buffer, &base64_buffer_len);
+        char_count_sent += remove_and_send_base64_char(base64_buffer, &base64_buffer_len);
+    }
+
+    //if any bits remain, it'll be fewer than 6
+    if (base64_buffer_len > 0) {
+        base64_buffer = (base64_buffer << (6 - base64_buffer_len));
+        base64_buffer_len = 6;
+        char_count_sent += remove_and_send_base64_char(base64_buffer, &base64_buffer_len);
+    }
+
+    //padding
+    const uint16_t pad_count = (4 - (char_count_sent & 0b11)) & 0b11;
     for (uint16_t pad_i=0; pad_i<pad_count; pad_i++) {
         printf_char('=');
     }
@@ -472,9 +620,10 @@ void test_base64() {
     array[23] =50001;
 
     for (uint16_t i = 1; i<24; i++) {
-        delay_printf_json_objects(1, json_uint16_array("uint16_array", i, array, true));
-        delay_printf_json_objects(1, json_base64_array("base64_array_16", i, array, true, 16));
-        delay_printf_json_objects(1, json_base64_array("base64_array_1", i, array, true, 1));
+        delay_printf_json_class_objects(print_class_debug, print_coalesce_none, 1, json_uint16_array("uint16_array", i, array, true));
+        delay_printf_json_class_objects(print_class_debug, print_coalesce_none, 1, json_base64_array("base64_array_16", i, array, true, 16));
+        delay_printf_json_class_objects(print_class_debug, print_coalesce_none, 1, json_base64_array("base64_array_1", i, array, true, 1));
+        delay_printf_json_class_objects(print_class_debug, print_coalesce_none, 1, json_delta_varint_array("delta_varint_array", i, array, true));
         printf_delayed_json_objects(true);
     }
 }
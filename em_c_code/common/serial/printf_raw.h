@@ -24,6 +24,7 @@ void print_float64_value(float64 value, uint16_t precision);
 void print_uint64_timestamp(uint64_t timestamp, uint64_t ts_multiplier, uint16_t ts_shift);
 
 void print_base64_array(const uint16_t *const array_ptr, uint16_t array_count, uint16_t precision);
+void print_delta_varint_array(const uint16_t *const array_ptr, uint16_t array_count);
 void test_base64();
 
 #endif
@@ -14,16 +14,26 @@
 #include "extract_json.h"
 #include "string.h"
 #include "arrays.h"
+#include "printf_binary.h"
+#include "json_stream.h"
 
 
 //internal variables
 static const uint16_t serial_json_pool_size = 256;         //max tokens
 static const uint16_t serial_max_rx_command_len = 1536;    //commands (some padding for event_code strings)
+static const uint16_t serial_max_rx_bytes_per_call = 64;   //bounds the time spent in each main loop
 static char *current_serial_command_string;
 static json_t *serial_json_pool;
+static json_stream_parser serial_json_parser;   //tokenizes each command as it arrives
 static bool has_initialized = false;
 static bool command_echo_on = false;   //default is off
 
+//command dispatch table (open addressed on the command hash, never more than half full)
+static const uint16_t serial_command_table_length = 128;    //power of two
+static serial_command_t *serial_command_table[serial_command_table_length];
+static uint16_t serial_command_count = 0;
+static bool serial_commands_frozen = false;
+
 //waiting code
 static uint16_t max_waiting_messages = 10;
 uint16_t waiting_count = 0;
@@ -31,13 +41,27 @@ uint16_t sec_until_waiting = 90;
 uint16_t sec_until_waiting_reload = 90;
 bool received_input = false;
 
+//time from the opening bracket until the command function returns
+static volatile tic_toc serial_command_timing;
+//time for each call to process_scia_buffer_for_commands
+static volatile tic_toc serial_process_timing;
+
 //internal functions
-void test_string_for_json_and_process(const char *const current_rx_command);
+void process_json_command(const json_t *const json_root);
 const json_t* test_and_point_to_command(const json_t *const json_root);
+const char *check_command_json(const json_t *const command_json);
+bool has_object_in_array(const json_t *const array_json);
+bool dispatch_json_command(const json_t *const command_json, bool is_batched, uint16_t batch_index = 0);
+void process_batch_commands(const json_t *const json_root);
+bool extract_request_id(const json_t *const command_json, bool &has_request_id, uint32_t &request_id);
 serial_command_t* get_command_from_json(const char *const json_cmd_value);
 void set_command_echo(const json_t *const json_root);
 void reset_command_validation();
 void set_waiting_delay(const json_t *const json_root);
+void print_serial_statistics(const json_t *const json_root);
+void print_print_queue_statistics(const json_t *const json_root);
+void print_element_arena_statistics(const json_t *const json_root);
+void set_output_binary_mode(const json_t *const json_root);
 
 //first command that all others will link to
 serial_command_t serial_command_list = {"get_commands", true, 0, print_all_serial_commands, NULL, NULL};
@@ -48,18 +72,64 @@ serial_command_t command_serial_config = {"get_serial_configuration", true, 0, N
 serial_command_t command_echo = {"set_command_echo", false, 0, set_command_echo, NULL, NULL};
 serial_command_t command_status = {"set_status_messages", false,  0, set_status_messages, NULL, NULL};
 serial_command_t command_waiting_delay = {"set_waiting_delay", false,  0, set_waiting_delay, NULL, NULL};
+serial_command_t command_serial_statistics = {"get_serial_statistics", true, 0, print_serial_statistics, NULL, NULL};
+serial_command_t command_print_queue_statistics = {"get_print_queue_statistics", true, 0, print_print_queue_statistics, NULL, NULL};
+serial_command_t command_binary_mode = {"set_binary_mode", true, 0, set_output_binary_mode, NULL, NULL};
+serial_command_t command_element_arena_statistics = {"get_element_arena_statistics", true, 0, print_element_arena_statistics, NULL, NULL};
+serial_command_t command_batch = {"batch", true, 0, process_batch_commands, NULL, NULL};
+
+
+bool insert_serial_command_into_table(serial_command_t *new_serial_command) {
+    if (serial_command_count >= (serial_command_table_length / 2)) {
+        delay_printf_json_objects(2, json_string("error", "serial command table is full"), json_string("command", new_serial_command->command_string));
+        return false;
+    }
+
+    //linear probe to the first open slot
+    uint16_t table_i = static_cast<uint16_t>(new_serial_command->command_hash) & (serial_command_table_length - 1);
+    while (serial_command_table[table_i] != NULL) {
+
+        //the same hash is either a duplicate, or two commands that would alias each other
+        if (serial_command_table[table_i]->command_hash == new_serial_command->command_hash) {
+            delay_printf_json_objects(3, json_string("error", "serial command hash collision"),
+                                         json_string("command", new_serial_command->command_string),
+                                         json_string("existing_command", serial_command_table[table_i]->command_string));
+            return false;
+        }
+
+        table_i = (table_i + 1) & (serial_command_table_length - 1);
+    }
 
+    serial_command_table[table_i] = new_serial_command;
+    serial_command_count++;
+    return true;
+}
 
 void add_serial_command(serial_command_t *new_serial_command) {
+    if (serial_commands_frozen) {
+        delay_printf_json_objects(2, json_string("error", "serial commands are frozen"), json_string("command", new_serial_command->command_string));
+        return;
+    }
+
+    //the root command is always the first in the table
+    if (serial_command_count == 0) {
+        serial_command_list.command_hash = djb2_hash(serial_command_list.command_string);
+        insert_serial_command_into_table(&serial_command_list);
+    }
+
     uint32_t new_command_hash = djb2_hash(new_serial_command->command_string);
 
     new_serial_command->command_hash = new_command_hash;
     new_serial_command->next_function = NULL;  //safety check
 
+    //only commands with a unique hash are added
+    if (!insert_serial_command_into_table(new_serial_command)) {
+        return;
+    }
+
+    //the list is kept (in order) for listing the commands
     serial_command_t *last_serial_command = &serial_command_list;
 
-    //FIXME: need to check that there are not hash collisions before appending
-//    delay_printf_json_status("add new command, print list first");
     while (true) {
 //        delay_printf_json_objects(1, json_string("command", last_serial_command->command_string));
 
@@ -101,8 +171,13 @@ void init_serial_link() {
         return;
     }
 
-    //calculate the root command hash
-    serial_command_list.command_hash = djb2_hash(serial_command_list.command_string);
+    //the parser compacts the tokens into the string buffer
+    serial_json_parser.init(current_serial_command_string, serial_max_rx_command_len, serial_json_pool, serial_json_pool_size);
+
+    //extracted values for each command
+    if (!init_json_element_arena()) {
+        return;
+    }
 
     //now, add the additional commands
     add_serial_command(&command_test_connection);
@@ -110,6 +185,11 @@ void init_serial_link() {
     add_serial_command(&command_status);
     add_serial_command(&command_echo);
     add_serial_command(&command_waiting_delay);
+    add_serial_command(&command_serial_statistics);
+    add_serial_command(&command_print_queue_statistics);
+    add_serial_command(&command_binary_mode);
+    add_serial_command(&command_element_arena_statistics);
+    add_serial_command(&command_batch);
 
     //print_serial_configuration();
 
@@ -124,13 +204,18 @@ __attribute__((ramfunc))
 void process_scia_buffer_for_commands() {
     if (!has_initialized) {return;}
 
-    //grab bytes, until buffer is empty, and if successful, continue
+    serial_process_timing.tic();
+
+    //grab bytes, until buffer is empty (or the limit for this call), and if successful, continue
     uint16_t incoming_byte;
-    while (scia_rx_buffer_read(incoming_byte)) {
+    uint16_t byte_count = 0;
+    while ((byte_count < serial_max_rx_bytes_per_call) && scia_rx_buffer_read(incoming_byte)) {
+        byte_count++;
 
         //for debugging purposes
         if ((!serial_command_is_being_validated) && (incoming_byte == '{')) {
             debug_timestamps.serial_s_bracket = CPU_TIMESTAMP;
+            serial_command_timing.tic();
         }
 
         //if length is 0 and first character is the start character, or if the command is being validated
@@ -138,9 +223,8 @@ void process_scia_buffer_for_commands() {
 
             if (command_echo_on) {printf_char(incoming_byte);}
 
-            //copy the command bytes
+            //count the command bytes
             serial_command_is_being_validated = true;
-            current_serial_command_string[current_serial_command_len] = static_cast<char>(incoming_byte);
             current_serial_command_len++;
 
 
@@ -152,10 +236,9 @@ void process_scia_buffer_for_commands() {
                 received_input = true;
 
                 if (current_serial_command_len > 6) {
-                    //null terminate the string, in preparation
-                    current_serial_command_string[current_serial_command_len] = 0;
-                    //try to process
-                    test_string_for_json_and_process(current_serial_command_string);
+                    //already tokenized, so just process (root is NULL if it was not valid)
+                    process_json_command(serial_json_parser.root());
+                    serial_command_timing.toc();
 
                 } else {
                     //otherwise, it was too short and don't bother
@@ -171,15 +254,22 @@ void process_scia_buffer_for_commands() {
                 printf_end_of_echo_valid_command(false);
                 delay_printf_json_error("no valid JSON string found");
                 reset_command_validation();
+
+            } else {
+                //tokenize as it arrives (any error is reported once the line ends)
+                serial_json_parser.add_char(static_cast<char>(incoming_byte));
             }
         }
     }
+
+    serial_process_timing.toc();
 }
 
 __attribute__((ramfunc))
 void reset_command_validation() {
     serial_command_is_being_validated = false;
     current_serial_command_len = 0;
+    serial_json_parser.reset();
     //serial_command_json_bracket_count = 0;
     //add two nulls to the start
     current_serial_command_string[0] = 0;
@@ -187,56 +277,34 @@ void reset_command_validation() {
 }
 
 __attribute__((ramfunc))
-void test_string_for_json_and_process(const char *const current_rx_command) {
-
-    //create/test the JSON string
-    const json_t *const json_root = json_create(const_cast<char *>(current_rx_command), serial_json_pool, serial_json_pool_size);
+void process_json_command(const json_t *const json_root) {
 
     //get the command root
     const json_t *const command_root = test_and_point_to_command(json_root);
 
     if (command_root != NULL) {
-        const char *const json_cmd_value = command_root->u.value;
-
-        //get the command_index from the string
-        serial_command_t *serial_command = get_command_from_json(json_cmd_value);
-
-        //if the command is valid
-        //if (serial_command_index < serial_commands_count) {
-        if (serial_command) {
-            //for echo, acknowledge valid command
-            printf_end_of_echo_valid_command(true);
-
-            debug_timestamps.serial_call_func = CPU_TIMESTAMP;
-
-            //if the json or void function exists
-            //if (serial_commands[serial_command_index].json_function != NULL) {
-            if (serial_command->json_function != NULL) {
-
-                //json function (pass on the command sibling, which is the first object)
-                //delay_printf_json_status("calling json function");
-                //serial_commands[serial_command_index].json_function(command_root->sibling);
-                serial_command->json_function(command_root->sibling);
-
-            //} else if (serial_commands[serial_command_index].void_function != NULL) {
-            } else if (serial_command->void_function != NULL) {
+        //with an id, everything the command prints gets the id, and then a final done
+        bool has_request_id;
+        uint32_t request_id;
+        if (!extract_request_id(command_root, has_request_id, request_id)) {
+            reset_json_element_arena();
+            return;
+        }
 
-                //void function
-                //delay_printf_json_status("calling void function");
-//                serial_commands[serial_command_index].void_function();
-                serial_command->void_function();
-            } else {
+        if (has_request_id) {
+            set_delayed_json_request_id(request_id);
+        }
 
-                //give error
-                delay_printf_json_objects(2, json_string("error", "command exists, but no function defined yet"), json_string("command", json_cmd_value));
-            }
+        dispatch_json_command(command_root, false);
 
-        } else {
-            //else, command doesn't exist
-            printf_end_of_echo_valid_command(false);
-            delay_printf_json_objects(2, json_string("error", "unrecognized command"), json_string("command", json_cmd_value));
+        if (has_request_id) {
+            delay_printf_json_objects(1, json_bool("done", true));
+            clear_delayed_json_request_id();
         }
     }
+
+    //nothing extracted from the command is used after it returns
+    reset_json_element_arena();
 }
 
 __attribute__((ramfunc))
@@ -248,62 +316,251 @@ const json_t* test_and_point_to_command(const json_t *const json_root) {
 
     }
 
-    //test to make sure that the first object is the command
-    const json_t *const command_json = json_root->u.child;    //this is because real root is just the whole object
-    if ((command_json->type != JSON_TEXT) || (strcmp(command_json->name, "command") != 0)) {
+    //this is because real root is just the whole object
+    const json_t *const command_json = json_root->u.child;
+    const char *const error_string = check_command_json(command_json);
+    if (error_string != NULL) {
         printf_end_of_echo_valid_command(false);
-        delay_printf_json_error("'command' was not the first parameter");
+        delay_printf_json_error(error_string);
         return NULL;
     }
 
+    printf_end_of_echo_valid_command(true);
+    //delay_printf_json_status("valid");
+    return command_json;
+}
+
+//returns why the command is invalid (or NULL if it is valid)
+__attribute__((ramfunc))
+const char *check_command_json(const json_t *const command_json) {
+    //test to make sure that the first object is the command
+    if ((command_json == NULL) || (command_json->type != JSON_TEXT) || (strcmp(command_json->name, "command") != 0)) {
+        return "'command' was not the first parameter";
+    }
+
+    //only a batch can have objects (its list of commands)
+    const bool is_batch = (strcmp(command_json->u.value, command_batch.command_string) == 0);
+
     //now, test that none of the siblings are objects
-    bool has_sibling_object = false;
     const json_t *current_json = command_json->sibling;
+    while (current_json != NULL) {
+        if ((current_json->type == JSON_OBJ) || ((!is_batch) && has_object_in_array(current_json))) {
+            return "no nested objects are allowed";
+        }
+        current_json = current_json->sibling;
+    }
+
+    return NULL;
+}
+
+__attribute__((ramfunc))
+bool has_object_in_array(const json_t *const array_json) {
+    if (array_json->type != JSON_ARRAY) {return false;}
+
+    const json_t *current_json = array_json->u.child;
     while (current_json != NULL) {
         if (current_json->type == JSON_OBJ) {
-            has_sibling_object = true;
+            return true;
         }
         current_json = current_json->sibling;
     }
 
-    if (has_sibling_object) {
-        printf_end_of_echo_valid_command(false);
-        delay_printf_json_error("no nested objects are allowed");
-        return NULL;
+    return false;
+}
+
+//calls the command's function, and returns false if it couldn't be
+__attribute__((ramfunc))
+bool dispatch_json_command(const json_t *const command_json, bool is_batched, uint16_t batch_index) {
+    const char *const json_cmd_value = command_json->u.value;
+
+    //get the command_index from the string
+    serial_command_t *serial_command = get_command_from_json(json_cmd_value);
+
+    //if the command is valid
+    //if (serial_command_index < serial_commands_count) {
+    if (serial_command) {
+        //for echo, acknowledge valid command (a batch is only acknowledged once)
+        if (!is_batched) {
+            printf_end_of_echo_valid_command(true);
+        }
+
+        debug_timestamps.serial_call_func = CPU_TIMESTAMP;
+
+        //if the json or void function exists
+        //if (serial_commands[serial_command_index].json_function != NULL) {
+        if (serial_command->json_function != NULL) {
+
+            //json function (pass on the command sibling, which is the first object)
+            //delay_printf_json_status("calling json function");
+            //serial_commands[serial_command_index].json_function(command_json->sibling);
+            serial_command->json_function(command_json->sibling);
+
+        //} else if (serial_commands[serial_command_index].void_function != NULL) {
+        } else if (serial_command->void_function != NULL) {
+
+            //void function
+            //delay_printf_json_status("calling void function");
+//                serial_commands[serial_command_index].void_function();
+            serial_command->void_function();
+        } else {
+
+            //give error
+            if (is_batched) {
+                delay_printf_json_objects(3, json_string("error", "command exists, but no function defined yet"), json_string("command", json_cmd_value),
+                                             json_uint16("batch_index", batch_index));
+            } else {
+                delay_printf_json_objects(2, json_string("error", "command exists, but no function defined yet"), json_string("command", json_cmd_value));
+            }
+            return false;
+        }
+
+    } else {
+        //else, command doesn't exist
+        if (!is_batched) {
+            printf_end_of_echo_valid_command(false);
+        }
+        if (is_batched) {
+            delay_printf_json_objects(3, json_string("error", "unrecognized command"), json_string("command", json_cmd_value),
+                                         json_uint16("batch_index", batch_index));
+        } else {
+            delay_printf_json_objects(2, json_string("error", "unrecognized command"), json_string("command", json_cmd_value));
+        }
+        return false;
     }
 
-    printf_end_of_echo_valid_command(true);
-    //delay_printf_json_status("valid");
-    return command_json;
+    return true;
+}
+
+//runs each command in the list, in order, and then acknowledges the whole batch
+void process_batch_commands(const json_t *const json_root) {
+    const json_t *const commands_json = get_json_property(json_root, "commands");
+    if ((commands_json == NULL) || (commands_json->type != JSON_ARRAY)) {
+        delay_printf_json_objects(3, json_string("error", "property missing"),
+                                     json_string("property", "commands"),
+                                     json_string("expected", "array of commands"));
+        return;
+    }
+
+    uint16_t command_count = 0;
+    uint16_t failed_count = 0;
+    const json_t *batched_json = commands_json->u.child;
+    while (batched_json != NULL) {
+        //each is an object, just like a single command line
+        const json_t *const command_json = (batched_json->type == JSON_OBJ) ? batched_json->u.child : NULL;
+        const char *error_string = check_command_json(command_json);
+        if ((error_string == NULL) && (strcmp(command_json->u.value, command_batch.command_string) == 0)) {
+            error_string = "a batch cannot contain another batch";
+        }
+
+        if (error_string != NULL) {
+            delay_printf_json_objects(2, json_string("error", error_string), json_uint16("batch_index", command_count));
+            failed_count++;
+        } else {
+            //a handler reports a failure by printing an error (it can't return one)
+            watch_delayed_json_command_errors();
+            const bool is_dispatched = dispatch_json_command(command_json, true, command_count);
+            const bool had_error = end_watch_delayed_json_command_errors();
+            if ((!is_dispatched) || had_error) {
+                failed_count++;
+            }
+        }
+
+        //nothing extracted from each command is used after it returns
+        reset_json_element_arena();
+
+        //send the replies so far (just like the main loop would between lines), so a long batch can't fill the queue
+        printf_delayed_json_objects(false);
+
+        command_count++;
+        batched_json = batched_json->sibling;
+    }
+
+    delay_printf_json_objects(3, json_parent("batch", 2),
+                                 json_uint16("command_count", command_count),
+                                 json_uint16("failed_count", failed_count));
 }
 
+//the optional id is removed from the command (so the command never sees it)
+__attribute__((ramfunc))
+bool extract_request_id(const json_t *const command_json, bool &has_request_id, uint32_t &request_id) {
+    has_request_id = false;
+
+    //the pool only holds this command, so it is safe to unlink
+    json_t *previous_json = const_cast<json_t *>(command_json);
+    json_t *id_json = previous_json->sibling;
+    while (id_json != NULL) {
+        if ((id_json->name != NULL) && (strcmp(id_json->name, "id") == 0)) {
+            previous_json->sibling = id_json->sibling;
+            break;
+        }
+        previous_json = id_json;
+        id_json = id_json->sibling;
+    }
+
+    if (id_json == NULL) {
+        return true;
+    }
+
+    if ((id_json->type != JSON_INTEGER) || (id_json->u.value[0] == '-')) {
+        delay_printf_json_error("'id' must be an unsigned integer");
+        return false;
+    }
+
+    //any conversion error is printed by the element
+    id_json->sibling = NULL;
+    json_element id_e("id", t_uint32);
+    if (!id_e.set_with_json(id_json, false)) {
+        return false;
+    }
+
+    has_request_id = true;
+    request_id = id_e.value().uint32_;
+    return true;
+}
+
+__attribute__((ramfunc))
 serial_command_t* get_command_from_json(const char *const json_cmd_value) {
     //calculate the hash
-    uint32_t current_command_hash = djb2_hash(const_cast<char *>(json_cmd_value));
-
-    serial_command_t *current_command = &serial_command_list;
-    serial_command_t *match_command = NULL;
+    const uint32_t current_command_hash = djb2_hash(json_cmd_value);
 
-//    delay_printf_json_objects(2, json_uint32("test hash", current_command_hash), json_string("test command", const_cast<char *>(json_cmd_value)));
+    //probe until an empty slot (there always is one, since the table is at most half full)
+    uint16_t table_i = static_cast<uint16_t>(current_command_hash) & (serial_command_table_length - 1);
+    while (serial_command_table[table_i] != NULL) {
+        serial_command_t *const current_command = serial_command_table[table_i];
 
-    while (true) {
-//        delay_printf_json_objects(1, json_uint32("command hash", current_command->command_hash));
+        //hashes are unique in the table, so confirm the string on the only possible match
         if (current_command->command_hash == current_command_hash) {
-//            delay_printf_json_status("match");
-            match_command = current_command;
-            break;
+            if (strcmp(current_command->command_string, json_cmd_value) == 0) {
+                return current_command;
+            }
+            return NULL;
         }
 
-        if (current_command->next_function) {
-//            delay_printf_json_status("go to next command");
-            current_command = current_command->next_function;
-        } else {
-//            delay_printf_json_status("no matches");
-            break;
+        table_i = (table_i + 1) & (serial_command_table_length - 1);
+    }
+
+    return NULL;
+}
+
+void freeze_serial_commands() {
+    serial_commands_frozen = true;
+
+    //longest probe from a command's home slot
+    uint16_t max_probe_length = 0;
+    for (uint16_t table_i=0; table_i<serial_command_table_length; table_i++) {
+        if (serial_command_table[table_i] != NULL) {
+            const uint16_t home_i = static_cast<uint16_t>(serial_command_table[table_i]->command_hash) & (serial_command_table_length - 1);
+            const uint16_t probe_length = (table_i - home_i) & (serial_command_table_length - 1);
+            if (probe_length > max_probe_length) {
+                max_probe_length = probe_length;
+            }
         }
     }
 
-    return match_command;
+    delay_printf_json_objects(4, json_parent("serial_command_table", 3),
+                                 json_uint16("command_count", serial_command_count),
+                                 json_uint16("table_length", serial_command_table_length),
+                                 json_uint16("max_probe_length", max_probe_length));
 }
 
 void print_connection_success() {
@@ -357,6 +614,66 @@ void print_serial_configuration() {
                             json_uint16("max_json_tokens", serial_json_pool_size));
 }
 
+void print_serial_statistics(const json_t *const json_root) {
+    json_element reset_e("reset", t_bool);
+    reset_e.set_with_json(json_root, false);
+    const bool reset = ((reset_e.count_found() > 0) && reset_e.value().bool_);
+
+    const scia_statistics_t statistics = get_scia_statistics(reset);
+    const float32 command_us = serial_command_timing.us();
+    const float32 command_max_us = serial_command_timing.max_us();
+    const float32 process_max_us = serial_process_timing.max_us();
+    if (reset) {
+        serial_command_timing.reset();
+        serial_process_timing.reset();
+    }
+
+    delay_printf_json_objects(10, json_parent("serial_statistics", 9),
+                            json_uint32("rx_bytes", statistics.rx_bytes),
+                            json_uint32("tx_bytes", statistics.tx_bytes),
+                            json_uint32("tx_full_waits", statistics.tx_full_waits),
+                            json_uint16("tx_max_in_use", statistics.tx_max_in_use),
+                            json_uint16("tx_buffer_length", statistics.tx_buffer_length),
+                            json_uint32("tx_staged_spans", statistics.tx_staged_spans),
+                            json_float32("command_us", command_us, 2),
+                            json_float32("command_max_us", command_max_us, 2),
+                            json_float32("process_max_us", process_max_us, 2));
+}
+
+void print_print_queue_statistics(const json_t *const json_root) {
+    json_element reset_e("reset", t_bool);
+    reset_e.set_with_json(json_root, false);
+    const bool reset = ((reset_e.count_found() > 0) && reset_e.value().bool_);
+
+    const delayed_json_statistics_t statistics = get_delayed_json_statistics(reset);
+
+    delay_printf_json_objects(12, json_parent("print_queue_statistics", 11),
+                            json_uint16("queue_length", statistics.queue_length),
+                            json_uint16("queue_in_use", statistics.queue_in_use),
+                            json_uint16("slot_count", statistics.slot_count),
+                            json_uint16("slot_objects", statistics.slot_objects),
+                            json_uint16("slots_in_use", statistics.slots_in_use),
+                            json_uint16("max_slots_in_use", statistics.max_slots_in_use),
+                            json_uint32("slot_failures", statistics.slot_failures),
+                            json_uint32("heap_messages", statistics.heap_messages),
+                            json_float32("print_max_us", statistics.print_max_us, 2),
+                            json_uint32_array("class_drops error, event, telemetry, debug", print_class_count, statistics.class_drops, true),
+                            json_uint32("coalesced", statistics.coalesced));
+}
+
+void print_element_arena_statistics(const json_t *const json_root) {
+    json_element reset_e("reset", t_bool);
+    reset_e.set_with_json(json_root, false);
+    const bool reset = ((reset_e.count_found() > 0) && reset_e.value().bool_);
+
+    const json_element_arena_statistics_t statistics = get_json_element_arena_statistics(reset);
+
+    delay_printf_json_objects(4, json_parent("element_arena_statistics", 3),
+                            json_uint16("length", statistics.length),
+                            json_uint16("max_used", statistics.max_used),
+                            json_uint32("failures", statistics.failures));
+}
+
 void print_all_serial_commands(const json_t *const json_root) {
 
 //    json_element include_hidden_e("include_hidden", t_bool);
@@ -415,6 +732,11 @@ void set_command_echo(const json_t *const json_root) {
     }
 
     if (enable_e.value().bool_) {
+        //raw echo would corrupt the binary frames
+        if (is_binary_mode()) {
+            delay_printf_json_error("echo is not available in binary mode");
+            return;
+        }
         delay_printf_json_status("enable echo");
         command_echo_on = true;
     } else {
@@ -422,3 +744,25 @@ void set_command_echo(const json_t *const json_root) {
         command_echo_on = false;
     }
 }
+
+void set_output_binary_mode(const json_t *const json_root) {
+    json_element enable_e("enable", t_bool, true);
+
+    if (!enable_e.set_with_json(json_root, true)) {
+        return;
+    }
+
+    //send what is already queued in the mode it was queued in (messages are framed when printed)
+    //so the stream changes mode once, here, instead of mixing the two
+    printf_delayed_json_objects(true);
+
+    //switch first, so that the reply is already in the new mode
+    if (enable_e.value().bool_) {
+        command_echo_on = false;
+        set_binary_mode(true);
+        delay_printf_json_status("enable binary mode");
+    } else {
+        set_binary_mode(false);
+        delay_printf_json_status("disable binary mode");
+    }
+}
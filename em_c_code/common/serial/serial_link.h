@@ -40,6 +40,7 @@ void print_all_siblings(const json_t *json_cmd_object);
 void check_if_waiting_for_input();
 
 void add_serial_command(serial_command_t *new_serial_command);
+void freeze_serial_commands();  //once all modules are initialized
 
 
 #endif
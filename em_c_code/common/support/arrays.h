@@ -9,6 +9,9 @@
 #define arrays_defined
 
 #include "misc.h"
+#include "fpu_vector.h"
+#include "limits.h"
+#include "string.h"
 
 //ignore all warnings for template
 #pragma diag_suppress 1463
@@ -60,6 +63,23 @@ T* create_array_of(uint16_t count, const char *const variable_name) {
     return ptr;
 }
 
+//memcpy_fast counts 16-bit words, so convert a count of T (exactly count*sizeof(T) on the c28x)
+template<typename T>
+inline uint16_t words_of(uint16_t count) {
+    return static_cast<uint16_t>(((static_cast<uint32_t>(count)*static_cast<uint32_t>(sizeof(T))) + sizeof(uint16_t) - 1) / sizeof(uint16_t));
+}
+
+//copy count of T (the host has 8-bit chars, so an odd count of bytes cannot be copied as words)
+template<typename T>
+__attribute__((ramfunc))
+void memcpy_fast_of(void *const dst, const void *const src, uint16_t count) {
+#if CHAR_BIT == 8
+    memcpy(dst, src, static_cast<size_t>(count)*sizeof(T));
+#else
+    memcpy_fast(dst, src, words_of<T>(count));
+#endif
+}
+
 template<typename T>
 __attribute__((ramfunc))
 void delete_array(const T* const ptr) {
@@ -0,0 +1,86 @@
+/*
+ * fixed_ring_buffer.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// same behavior as ring_buffer (thread-safe, overwrites the oldest value when full),
+// but with static storage sized at compile time, so no heap is used
+// both indices are free-running and masked, so N must be a power of two (and at most 2^15)
+
+#ifndef fixed_ring_buffer_defined
+#define fixed_ring_buffer_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//ignore all warnings for template
+#pragma diag_suppress 1463
+
+template<typename T, uint16_t N>
+class fixed_ring_buffer {
+    public:
+        fixed_ring_buffer() {
+            read_ = 0;
+            write_ = 0;
+        }
+
+        //empty in-place
+        __attribute__((ramfunc))
+        void reset() volatile {
+            const uint16_t interrupt_settings = __disable_interrupts();
+            read_ = 0;
+            write_ = 0;
+            __restore_interrupts(interrupt_settings);
+        }
+
+        __attribute__((ramfunc))
+        bool read(T &read_value) volatile {
+            const uint16_t interrupt_settings = __disable_interrupts();
+
+            const bool success = (read_ != write_);
+            if (success) {
+                read_value = const_cast<T &>(buffer_[read_ & mask_]);
+                read_++;
+            }
+
+            __restore_interrupts(interrupt_settings);
+            return success;
+        }
+
+        __attribute__((ramfunc))
+        bool write(const T &write_value) volatile {
+            const uint16_t interrupt_settings = __disable_interrupts();
+
+            //if full, then drop the oldest first
+            if (static_cast<uint16_t>(write_ - read_) == N) {
+                read_++;
+            }
+
+            const_cast<T &>(buffer_[write_ & mask_]) = write_value;
+            write_++;
+
+            __restore_interrupts(interrupt_settings);
+            return true;  //always possible to write
+        }
+
+        //status
+        bool is_full() volatile const {return in_use() == N;}
+        bool is_empty() volatile const {return read_ == write_;}
+        uint16_t in_use() volatile const {return static_cast<uint16_t>(write_ - read_);}
+        uint16_t available() volatile const {return N - in_use();}
+        uint16_t write_index() volatile const {return write_ & mask_;}  //used by delayprintf
+        uint16_t size() volatile const {return N;}
+
+    private:
+        //compile-time check that N is a power of two
+        typedef char size_must_be_a_power_of_two[((N > 0) && (N <= 32768) && ((N & (N - 1)) == 0)) ? 1 : -1];
+        static const uint16_t mask_ = N - 1;
+
+        uint16_t read_;     // free-running read index
+        uint16_t write_;    // free-running write index
+        T buffer_[N];       // the buffer
+};
+
+#pragma diag_default 1463
+
+#endif
@@ -76,7 +76,7 @@ void performance_test() {
                 cpu_hs_tic();
 #endif
 
-                memcpy_fast(destination_array, &source_array, lengths[i]);
+                memcpy_fast(destination_array, source_array, lengths[i]);
 
 #ifdef _LAUNCHXL_F28379D
                 const uint32_t delta_ts = CPU_TIMESTAMP - start_ts;
@@ -141,7 +141,7 @@ void lockup_cpu() {
     printf_delayed_json_objects(true);
     DELAY_US(500000);   //wait 0.5 sec to print any messages
 #pragma diag_suppress 1463
-    asm ("      ESTOP0");
+    ESTOP0;
 #pragma diag_default 1463
     for (;;) {
     }
@@ -198,11 +198,20 @@ bool is_power_of_two(uint64_t value) {
 __attribute__((ramfunc))
 void gpio_write_pin(volatile uint32_t *const pin_data_reg, uint32_t pin_mask, bool set_pin) {
 
+#ifdef _HOST_SIM
+    //the host registers are plain memory, so there is nothing to latch SET and CLEAR
+    if (set_pin) {
+        pin_data_reg[GPYDAT] |= pin_mask;
+    } else {
+        pin_data_reg[GPYDAT] &= ~pin_mask;
+    }
+#else
     if (set_pin) {
         pin_data_reg[GPYSET] = pin_mask;
     } else {
         pin_data_reg[GPYCLEAR] = pin_mask;
     }
+#endif
 }
 
 __attribute__((ramfunc))
@@ -85,6 +85,19 @@ void ring_buffer::dealloc_buffer() volatile {
     __restore_interrupts(interrupt_settings);
 }
 
+uint16_t *ring_buffer::swap_buffer(uint16_t *const buffer, uint16_t size) volatile {
+    uint16_t *const old_buffer = buffer_;
+
+    buffer_ = buffer;
+    size_ = (buffer != NULL) ? size : 0;
+    in_use_ = 0;
+    read_index_ = 0;
+    write_index_ = 0;
+    initialized_ = (buffer != NULL);
+
+    return old_buffer;
+}
+
 __attribute__((ramfunc))
 void ring_buffer::reset() volatile {
     //disable and store the interrupt state
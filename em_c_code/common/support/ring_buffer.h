@@ -22,6 +22,10 @@ class ring_buffer {
         ~ring_buffer();
         void dealloc_buffer() volatile;
 
+        //replace the buffer with one that was already allocated (NULL to remove it), and return the old one
+        //there is no heap work, so it can be done with interrupts disabled (the old one is freed later)
+        uint16_t *swap_buffer(uint16_t *const buffer, uint16_t size) volatile;
+
         //empty in-place
         void reset() volatile;
 
@@ -0,0 +1,139 @@
+/*
+ * spsc_ring_buffer.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// ring buffer for exactly one producer and one consumer (e.g. an isr and the main loop)
+// the producer only ever writes write_, and the consumer only ever writes read_,
+// so no interrupts need to be disabled (16-bit loads and stores are atomic on the c28x)
+// both indices are free-running and masked, so N must be a power of two (and at most 2^15)
+// unlike ring_buffer, writing to a full buffer fails instead of overwriting the oldest value
+// T must be a scalar type (each element is stored through a volatile access)
+
+#ifndef spsc_ring_buffer_defined
+#define spsc_ring_buffer_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fpu_vector.h"
+#include "arrays.h"
+
+//ignore all warnings for template
+#pragma diag_suppress 1463
+
+template<typename T, uint16_t N>
+class spsc_ring_buffer {
+    public:
+        spsc_ring_buffer() {
+            read_ = 0;
+            write_ = 0;
+        }
+
+        //empty in-place (only safe when neither side is in use)
+        void reset() volatile {
+            const uint16_t interrupt_settings = __disable_interrupts();
+            read_ = 0;
+            write_ = 0;
+            __restore_interrupts(interrupt_settings);
+        }
+
+        //consumer side
+        __attribute__((ramfunc))
+        bool read(T &read_value) volatile {
+            const uint16_t read_index = read_;
+            if (read_index == write_) {
+                return false;
+            }
+
+            read_value = buffer_[read_index & mask_];
+
+            //publish the new index only after the value has been read
+            read_ = read_index + 1;
+            return true;
+        }
+
+        __attribute__((ramfunc))
+        bool read(const uint16_t count, T *const array) volatile {
+            if (count > in_use()) {
+                return false;
+            } else if (count == 0) {
+                return true;
+            }
+
+            const uint16_t read_index = read_;
+            const uint16_t start = read_index & mask_;
+            const uint16_t count_till_end = N - start;
+
+            //if there must be a split
+            if (count > count_till_end) {
+                memcpy_fast_of<T>(array, const_cast<T *>(&buffer_[start]), count_till_end);
+                memcpy_fast_of<T>(&array[count_till_end], const_cast<T *>(&buffer_[0]), count - count_till_end);
+            } else {
+                memcpy_fast_of<T>(array, const_cast<T *>(&buffer_[start]), count);
+            }
+
+            //publish the new index only after the values have been copied
+            read_ = read_index + count;
+            return true;
+        }
+
+        //producer side
+        __attribute__((ramfunc))
+        bool write(const T write_value) volatile {
+            const uint16_t write_index = write_;
+            if (static_cast<uint16_t>(write_index - read_) == N) {
+                return false;
+            }
+
+            buffer_[write_index & mask_] = write_value;
+
+            //publish the new index only after the value has been written
+            write_ = write_index + 1;
+            return true;
+        }
+
+        __attribute__((ramfunc))
+        bool write(const uint16_t count, const T *const array) volatile {
+            if (count > available()) {
+                return false;
+            } else if (count == 0) {
+                return true;
+            }
+
+            const uint16_t write_index = write_;
+            const uint16_t start = write_index & mask_;
+            const uint16_t count_till_end = N - start;
+
+            //if there must be a split
+            if (count > count_till_end) {
+                memcpy_fast_of<T>(const_cast<T *>(&buffer_[start]), array, count_till_end);
+                memcpy_fast_of<T>(const_cast<T *>(&buffer_[0]), &array[count_till_end], count - count_till_end);
+            } else {
+                memcpy_fast_of<T>(const_cast<T *>(&buffer_[start]), array, count);
+            }
+
+            //publish the new index only after the values have been copied
+            write_ = write_index + count;
+            return true;
+        }
+
+        //status (a snapshot, since the other side can change it at any time)
+        bool is_full() volatile const {return in_use() == N;}
+        bool is_empty() volatile const {return read_ == write_;}
+        uint16_t in_use() volatile const {return static_cast<uint16_t>(write_ - read_);}
+        uint16_t available() volatile const {return N - in_use();}
+        uint16_t size() volatile const {return N;}
+
+    private:
+        //compile-time check that N is a power of two
+        typedef char size_must_be_a_power_of_two[((N > 0) && (N <= 32768) && ((N & (N - 1)) == 0)) ? 1 : -1];
+        static const uint16_t mask_ = N - 1;
+
+        uint16_t read_;     // only changed by the consumer
+        uint16_t write_;    // only changed by the producer
+        T buffer_[N];       // the buffer
+};
+
+#pragma diag_default 1463
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * bench_formatter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// printf_raw against the formatters it replaced (printf_raw_reference.h), on batches of typical values
+// each time is the fastest batch of many repeats (from the host clock, in 200MHz cycles), and the output must match
+// the host has 64bit division and a float unit, which the c28x does not (its float64 and 64bit division are library calls),
+// so the host cycles understate the gain; the print calls (one per character before, one per value now) carry over as is
+//
+// usage: bench_formatter [repeats]
+
+#include "host_test.h"
+#include "printf_raw_versions.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+static const uint32_t default_repeats = 200;
+static const uint16_t batch_length = 1024;
+static const double ns_per_cycle = 5.0;
+
+
+static uint64_t now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+//the same random values every run
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t random_uint64() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static double random_double(double range) {
+    return (static_cast<double>(random_uint64() >> 11) / 9007199254740992.0 * 2.0 - 1.0) * range;
+}
+
+
+//one kind of value, formatted by both versions
+typedef struct value_kind_t {
+    const char *name;
+    void (*print_current)(uint16_t value_i);
+    void (*print_reference)(uint16_t value_i);
+} value_kind_t;
+
+static int64_t int_values[batch_length];
+static uint64_t uint64_values[batch_length];
+static float32 float32_values[batch_length];
+static float64 float64_values[batch_length];
+
+static void current_uint16(uint16_t value_i) {current::print_all_int_except_uint64_value(int_values[value_i] & 0xFFFF);}
+static void reference_uint16(uint16_t value_i) {reference::print_all_int_except_uint64_value(int_values[value_i] & 0xFFFF);}
+static void current_int32(uint16_t value_i) {current::print_all_int_except_uint64_value(static_cast<int32_t>(int_values[value_i]));}
+static void reference_int32(uint16_t value_i) {reference::print_all_int_except_uint64_value(static_cast<int32_t>(int_values[value_i]));}
+static void current_uint64(uint16_t value_i) {current::print_uint64_value(uint64_values[value_i]);}
+static void reference_uint64(uint16_t value_i) {reference::print_uint64_value(uint64_values[value_i]);}
+static void current_timestamp(uint16_t value_i) {current::print_uint64_timestamp(uint64_values[value_i] >> 24, 10, 4);}
+static void reference_timestamp(uint16_t value_i) {reference::print_uint64_timestamp(uint64_values[value_i] >> 24, 10, 4);}
+static void current_float32(uint16_t value_i) {current::print_float32_value(float32_values[value_i], 4);}
+static void reference_float32(uint16_t value_i) {reference::print_float32_value(float32_values[value_i], 4);}
+static void current_float64(uint16_t value_i) {current::print_float64_value(float64_values[value_i], 10);}
+static void reference_float64(uint16_t value_i) {reference::print_float64_value(float64_values[value_i], 10);}
+
+static const value_kind_t value_kinds[] = {
+    {"uint16", current_uint16, reference_uint16},
+    {"int32", current_int32, reference_int32},
+    {"uint64", current_uint64, reference_uint64},
+    {"timestamp (x10, 4)", current_timestamp, reference_timestamp},
+    {"float32 (precision 4)", current_float32, reference_float32},
+    {"float64 (precision 10)", current_float64, reference_float64},
+};
+static const uint16_t value_kind_count = sizeof(value_kinds) / sizeof(value_kinds[0]);
+
+
+//results
+typedef struct result_t {
+    double cycles_per_value;
+    double calls_per_value;
+    std::string output;     //of the whole batch
+} result_t;
+
+static result_t measure_batch(void (*print_value)(uint16_t value_i), uint32_t repeats) {
+    result_t result;
+
+    //once for the output, and the calls it took
+    uint32_t call_count = 0;
+    for (uint16_t value_i=0; value_i<batch_length; value_i++) {
+        capture_clear();
+        print_value(value_i);
+        call_count += captured_calls;
+        result.output += capture_text();
+        result.output += ',';
+    }
+
+    //then timed (the capture holds one value at a time, so clearing it is all that is added)
+    uint64_t fastest_ns = 0xFFFFFFFFFFFFFFFFULL;
+    for (uint32_t repeat=0; repeat<repeats; repeat++) {
+        const uint64_t start_ns = now_ns();
+        for (uint16_t value_i=0; value_i<batch_length; value_i++) {
+            capture_clear();
+            print_value(value_i);
+        }
+        fastest_ns = std::min(fastest_ns, now_ns() - start_ns);
+    }
+
+    result.cycles_per_value = static_cast<double>(fastest_ns) / ns_per_cycle / batch_length;
+    result.calls_per_value = static_cast<double>(call_count) / batch_length;
+    return result;
+}
+
+
+int main(int argc, char **argv) {
+    uint32_t repeats = default_repeats;
+    if (argc > 1) {
+        repeats = static_cast<uint32_t>(strtoul(argv[1], NULL, 10));
+        if (repeats == 0) {
+            fprintf(stderr, "repeats must be > 0\n");
+            return 1;
+        }
+    }
+
+    for (uint16_t i=0; i<batch_length; i++) {
+        int_values[i] = static_cast<int64_t>(random_uint64());
+        uint64_values[i] = random_uint64();
+        float32_values[i] = static_cast<float32>(random_double(1000.0));
+        float64_values[i] = random_double(1000000.0);
+    }
+
+    printf("%-24s  %14s  %14s  %10s  %10s\n", "value", "old cycles", "new cycles", "old calls", "new calls");
+
+    for (uint16_t kind_i=0; kind_i<value_kind_count; kind_i++) {
+        const value_kind_t &kind = value_kinds[kind_i];
+        const result_t old_result = measure_batch(kind.print_reference, repeats);
+        const result_t new_result = measure_batch(kind.print_current, repeats);
+
+        printf("%-24s  %14.1f  %14.1f  %10.1f  %10.1f\n", kind.name, old_result.cycles_per_value, new_result.cycles_per_value,
+               old_result.calls_per_value, new_result.calls_per_value);
+
+        if (new_result.output != old_result.output) {
+            fprintf(stderr, "%s: the output differs from the old formatter\n", kind.name);
+        }
+        check(new_result.output == old_result.output, "same output as the old formatter");
+        check(new_result.calls_per_value == 1.0, "one print call per value");
+    }
+
+    return host_test_result("formatter");
+}
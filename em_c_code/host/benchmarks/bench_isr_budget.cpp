@@ -0,0 +1,335 @@
+/*
+ * bench_isr_budget.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// io_controller_main_loop (the timer0 isr) against its 100us budget, one configuration per run
+// every configuration is sent as commands, the same way the computer would, then the inputs are swept while it runs
+// the times are from the host clock (in 200MHz cycles), so they show how the cost scales, not the 79D's headroom
+// the inputs repeat every stimulus period, so the budget is checked against the fastest pass at each point in it
+// (a configuration that is too slow is slow on every pass, the host scheduler only on some)
+//
+// usage: bench_isr_budget <setup> [passes]
+//        bench_isr_budget --list
+
+#include "host_test.h"
+#include "cpu_timers.h"
+#include "io_controller.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+//db3: inputs 0-7 are digital, 8-15 are analog (8 outputs)
+static const uint16_t digital_input_count = 8;
+static const uint16_t analog_input_count = 8;
+static const uint16_t first_analog_input = digital_input_count;
+static const uint16_t output_count = 8;
+static const uint16_t digital_input_gpio[digital_input_count] = {63, 11, 64, 14, 26, 15, 27, 25};
+
+static const float64 cycles_per_us = 200.0;
+
+//every input repeats within this many ticks (a multiple of the 10 ticks between input reads)
+static const uint32_t stimulus_period_ticks = 400;
+static const uint32_t default_passes = 50;
+static const uint32_t warmup_passes = 2;
+
+//analog inputs swing around the targets (so they are met and left over and over)
+static const uint16_t analog_center = 32768;
+static const uint16_t analog_swing = 6000;
+static const uint32_t analog_lag_ticks = 5;
+
+
+//commands
+static std::string input_settings(uint16_t input_number, const std::string &fields) {
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "{\"command\":\"set_input_settings\",\"input_number\":%u,", input_number);
+    return std::string(prefix) + fields + "}";
+}
+
+static std::string output_settings(uint16_t output_number, const std::string &fields) {
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "{\"command\":\"set_output_settings\",\"output_number\":%u,", output_number);
+    return std::string(prefix) + fields + "}";
+}
+
+static std::string event_code_field(uint16_t input_number) {
+    char field[32];
+    snprintf(field, sizeof(field), "\"event_code_met\":%u", 200 + input_number);
+    return std::string(field);
+}
+
+static std::string analog_target_fields(const char *const target_type, uint16_t distance) {
+    char fields[128];
+    snprintf(fields, sizeof(fields), "\"target_type\":\"%s\",\"target_value\":%u,\"target_distance\":%u", target_type, analog_center, distance);
+    return std::string(fields);
+}
+
+static const std::string target_actions = "\"actions_enabled\":true,\"all_transitions\":true,\"send_to_computer\":true";
+
+
+//setups (each is a list of settings, committed together)
+typedef std::vector<std::string> settings_list_t;
+
+static void add_all_input_targets(settings_list_t &settings) {
+    for (uint16_t i=0; i<digital_input_count; i++) {
+        settings.push_back(input_settings(i, "\"target\":1," + target_actions + "," + event_code_field(i)));
+    }
+    for (uint16_t i=first_analog_input; i<(first_analog_input + analog_input_count); i++) {
+        settings.push_back(input_settings(i, "\"target_type\":\">\",\"target_value\":32768," + target_actions + "," + event_code_field(i)));
+    }
+}
+
+//the children are set first (bottom up), so each link has a target before it joins the chain
+static void add_chain(settings_list_t &settings, uint16_t length, const char *const target_type) {
+    for (uint16_t link=length; link>0; link--) {
+        const uint16_t input_number = first_analog_input + link - 1;
+        const uint16_t distance = 3000 + (500 * (link - 1));   //different per link, so an ellipse isn't a circle
+        std::string fields = analog_target_fields(target_type, distance);
+
+        if (link < length) {
+            char child_fields[64];
+            snprintf(child_fields, sizeof(child_fields), ",\"enable_child\":true,\"child_number\":%u", input_number + 1);
+            fields += child_fields;
+        }
+        if (link == 1) {
+            fields += "," + target_actions + "," + event_code_field(input_number);
+        }
+        settings.push_back(input_settings(input_number, fields));
+    }
+}
+
+static void add_history_with_thresholds(settings_list_t &settings) {
+    for (uint16_t i=0; i<(digital_input_count + analog_input_count); i++) {
+        const bool is_digital = (i < digital_input_count);
+        char fields[128];
+        snprintf(fields, sizeof(fields), "\"history_enabled\":true,\"history_length\":1024,\"threshold_enabled\":true,\"threshold_value\":%u", is_digital ? 1 : analog_center);
+        settings.push_back(input_settings(i, fields));
+    }
+}
+
+static void add_readout_every_tic(settings_list_t &settings) {
+    for (uint16_t i=0; i<(digital_input_count + analog_input_count); i++) {
+        settings.push_back(input_settings(i, "\"readout_enabled\":true,\"readout_tics\":1"));
+    }
+}
+
+static void add_outputs_cycling(settings_list_t &settings) {
+    for (uint16_t i=0; i<output_count; i++) {
+        settings.push_back(output_settings(i, "\"enabled\":true,\"is_continuous\":true,\"on_tics\":1,\"off_tics\":1,\"send_to_computer\":true,\"all_transitions\":true"));
+    }
+}
+
+typedef struct setup_t {
+    std::string name;
+    settings_list_t settings;
+    bool is_skipping;       //false evaluates every input every tic (the per-tic input state, without skipping hiding it)
+} setup_t;
+
+static std::vector<setup_t> all_setups() {
+    std::vector<setup_t> setups;
+    setup_t setup;
+    setup.is_skipping = true;
+
+    setup.name = "idle";
+    setup.settings.clear();
+    setups.push_back(setup);
+
+    setup.name = "all_inputs_with_targets";
+    setup.settings.clear();
+    add_all_input_targets(setup.settings);
+    setups.push_back(setup);
+
+    //the same, with min lengths and timeouts, and every input evaluated every tic
+    setup.name = "all_inputs_every_tic";
+    setup.settings.clear();
+    add_all_input_targets(setup.settings);
+    for (size_t i=0; i<setup.settings.size(); i++) {
+        setup.settings[i].insert(setup.settings[i].size() - 1, ",\"target_met_min_tics\":3,\"target_left_min_tics\":2,\"timeout_tics\":4");
+    }
+    setup.is_skipping = false;
+    setups.push_back(setup);
+    setup.is_skipping = true;
+
+    const char *const chain_types[2] = {"circular_distance", "elliptical_distance"};
+    for (uint16_t type_i=0; type_i<2; type_i++) {
+        for (uint16_t length=2; length<=analog_input_count; length++) {
+            char name[64];
+            snprintf(name, sizeof(name), "chain_%s_%u", (type_i == 0) ? "circular" : "elliptical", length);
+            setup.name = name;
+            setup.settings.clear();
+            add_chain(setup.settings, length, chain_types[type_i]);
+            setups.push_back(setup);
+        }
+    }
+
+    setup.name = "history_with_thresholds";
+    setup.settings.clear();
+    add_history_with_thresholds(setup.settings);
+    setups.push_back(setup);
+
+    setup.name = "readout_every_tic";
+    setup.settings.clear();
+    add_readout_every_tic(setup.settings);
+    setups.push_back(setup);
+
+    setup.name = "all_outputs_cycling";
+    setup.settings.clear();
+    add_outputs_cycling(setup.settings);
+    setups.push_back(setup);
+
+    //everything at once: the digital inputs with targets, an 8 link elliptical chain, history, and every output
+    setup.name = "worst_case";
+    setup.settings.clear();
+    for (uint16_t i=0; i<digital_input_count; i++) {
+        setup.settings.push_back(input_settings(i, "\"target\":1,\"history_enabled\":true,\"history_length\":1024,\"threshold_enabled\":true,\"threshold_value\":1," + target_actions + "," + event_code_field(i)));
+    }
+    add_chain(setup.settings, analog_input_count, "elliptical_distance");
+    for (uint16_t i=first_analog_input; i<(first_analog_input + analog_input_count); i++) {
+        setup.settings.push_back(input_settings(i, "\"history_enabled\":true,\"history_length\":1024,\"threshold_enabled\":true,\"threshold_value\":32768"));
+    }
+    add_outputs_cycling(setup.settings);
+    setups.push_back(setup);
+
+    return setups;
+}
+
+
+//configures through the staged commit, so every setting has to be valid
+static bool configure(const setup_t &setup) {
+    if (setup.settings.empty()) {return true;}
+
+    check(contains(run_command("{\"command\":\"begin_configuration\"}"), "configuration staging started"), "staging started");
+    for (size_t i=0; i<setup.settings.size(); i++) {
+        const std::string output = run_command(setup.settings[i]);
+        if (contains(output, "\"error\"") || (!contains(output, "\"staged_count\""))) {
+            fprintf(stderr, "%s: setting was not staged\n  %s\n  %s\n", setup.name.c_str(), setup.settings[i].c_str(), output.c_str());
+            return false;
+        }
+    }
+
+    //readout every tic never lets the line go idle, so only run long enough for the reply
+    sim_send_command("{\"command\":\"commit_configuration\"}");
+    sim_run(200, 2);
+    const std::string output = sim_serial_read();
+    if (!contains(output, "\"applied\":true")) {
+        fprintf(stderr, "%s: configuration was not applied\n  %s\n", setup.name.c_str(), output.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+//inputs (the same values at the same phase of every pass)
+static void set_inputs(uint32_t phase) {
+    for (uint16_t i=0; i<analog_input_count; i++) {
+        //a triangle wave, with each channel a little behind the one before it (close enough that a whole chain is met together)
+        const uint32_t channel_phase = (phase + (i * analog_lag_ticks)) % stimulus_period_ticks;
+        const uint32_t half_period = stimulus_period_ticks / 2;
+        const uint32_t ramp = (channel_phase < half_period) ? channel_phase : (stimulus_period_ticks - channel_phase);
+        const int32_t offset = (static_cast<int32_t>(ramp * 2 * analog_swing) / static_cast<int32_t>(half_period)) - analog_swing;
+        sim_set_analog_in(i, static_cast<uint16_t>(analog_center + offset));
+    }
+
+    //square waves of 50 to 400 ticks, in pairs that are out of step
+    for (uint16_t i=0; i<digital_input_count; i++) {
+        const uint32_t half_period = 25UL << (i / 2);
+        const uint32_t channel_phase = phase + ((i % 2) * (half_period / 2));
+        sim_set_gpio(digital_input_gpio[i], ((channel_phase / half_period) % 2) == 1);
+    }
+}
+
+
+//results
+static int run_setup(const setup_t &setup, uint32_t passes) {
+    sim_boot();
+    sim_serial_read();
+
+    if (!configure(setup)) {
+        return 1;
+    }
+    enable_input_skipping(setup.is_skipping);
+
+    //start every pass at the same point in the 10 tick input cycle
+    while ((sim_timer0_count() % 10) != 0) {
+        sim_run(1, 2);
+    }
+    for (uint32_t phase=0; phase<(warmup_passes * stimulus_period_ticks); phase++) {
+        set_inputs(phase % stimulus_period_ticks);
+        sim_run(1, 2);
+    }
+    sim_serial_read();
+    cpu_timer0.reset_cycle_stats();
+
+    const uint32_t ticks = passes * stimulus_period_ticks;
+    std::vector<uint32_t> cycles;
+    std::vector<uint32_t> fastest_cycles(stimulus_period_ticks, 0xFFFFFFFFUL);
+    cycles.reserve(ticks);
+    for (uint32_t pass=0; pass<passes; pass++) {
+        for (uint32_t phase=0; phase<stimulus_period_ticks; phase++) {
+            const uint64_t isr_count = cpu_timer0.count();
+            set_inputs(phase);
+            sim_run(1, 2);
+            check(cpu_timer0.count() == (isr_count + 1), "one isr per tick");
+
+            const uint32_t tick_cycles = cpu_timer0.cycle_tics();
+            cycles.push_back(tick_cycles);
+            fastest_cycles[phase] = std::min(fastest_cycles[phase], tick_cycles);
+            sim_serial_read();
+        }
+    }
+
+    std::sort(cycles.begin(), cycles.end());
+    uint64_t sum = 0;
+    for (size_t i=0; i<cycles.size(); i++) {
+        sum += cycles[i];
+    }
+    const uint32_t min_cycles = cycles.front();
+    const float64 mean_cycles = static_cast<float64>(sum) / static_cast<float64>(cycles.size());
+    const uint32_t p99_cycles = cycles[(cycles.size() * 99) / 100];
+    const uint32_t max_cycles = cycles.back();
+
+    const uint32_t worst_cycles = *std::max_element(fastest_cycles.begin(), fastest_cycles.end());
+
+    const float32 budget_us = cpu_timer0.cycle_stats().budget_us();
+    const uint32_t over_budget_count = cpu_timer0.cycle_stats().over_budget_count();
+
+    printf("%-32s ticks %6u  cycles min %6u  mean %8.1f  p99 %6u  max %6u  worst phase %6u  (%6.2fus of %.0fus, %u ticks over)\n",
+           setup.name.c_str(), ticks, min_cycles, mean_cycles, p99_cycles, max_cycles, worst_cycles,
+           worst_cycles / cycles_per_us, budget_us, over_budget_count);
+
+    check((worst_cycles / cycles_per_us) <= budget_us, "every tick is within the budget");
+    return host_test_result(setup.name.c_str());
+}
+
+
+int main(int argc, char **argv) {
+    const std::vector<setup_t> setups = all_setups();
+
+    if ((argc < 2) || (strcmp(argv[1], "--list") == 0)) {
+        for (size_t i=0; i<setups.size(); i++) {
+            printf("%s\n", setups[i].name.c_str());
+        }
+        return (argc < 2) ? 1 : 0;
+    }
+
+    uint32_t passes = default_passes;
+    if (argc > 2) {
+        passes = static_cast<uint32_t>(strtoul(argv[2], NULL, 10));
+        if (passes == 0) {
+            fprintf(stderr, "passes must be > 0\n");
+            return 1;
+        }
+    }
+
+    //the firmware only boots once, so each setup is its own run
+    for (size_t i=0; i<setups.size(); i++) {
+        if (setups[i].name == argv[1]) {
+            return run_setup(setups[i], passes);
+        }
+    }
+
+    fprintf(stderr, "unknown setup: %s (--list for the setups)\n", argv[1]);
+    return 1;
+}
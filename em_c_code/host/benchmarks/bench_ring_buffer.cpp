@@ -0,0 +1,186 @@
+/*
+ * bench_ring_buffer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the cost per value of spsc_ring_buffer (no interrupts disabled) against ring_buffer and fixed_ring_buffer (interrupts disabled around every call)
+// for the ways the firmware uses them: filling then draining, one write then one read (the isr and the main loop), and blocks
+// each time is the fastest of many repeats (from the host clock, in 200MHz cycles), and both must read back what was written
+// on the host, disabling interrupts takes a lock, so the gap is larger than on the device (where it is a few cycles per call)
+// (this replaces the device's run_ring_buffer_test command)
+//
+// usage: bench_ring_buffer [repeats]
+
+#include "host_test.h"
+#include "ring_buffer.h"
+#include "fixed_ring_buffer.h"
+#include "spsc_ring_buffer.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+
+static const uint16_t buffer_length = 256;
+static const uint16_t block_length = 16;
+static const uint16_t block_offset = 5;     //so some blocks are split at the end of the buffer
+
+static const uint32_t default_repeats = 2000;
+static const double ns_per_cycle = 5.0;
+
+
+static uint64_t now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+static double ns_in_cycles_per_value(uint64_t ns, uint32_t value_count) {
+    return static_cast<double>(ns) / ns_per_cycle / value_count;
+}
+
+
+//the patterns (each returns false if a value read back wasn't the one written)
+template<typename B>
+static bool fill_then_drain(volatile B &buffer, uint16_t *const read_values) {
+    for (uint16_t i=0; i<buffer_length; i++) {
+        buffer.write(i);
+    }
+    for (uint16_t i=0; i<buffer_length; i++) {
+        if (!buffer.read(read_values[i])) {return false;}
+    }
+    return true;
+}
+
+template<typename B>
+static bool write_then_read(volatile B &buffer, uint16_t *const read_values) {
+    for (uint16_t i=0; i<buffer_length; i++) {
+        buffer.write(i);
+        if (!buffer.read(read_values[i])) {return false;}
+    }
+    return true;
+}
+
+template<typename B>
+static bool blocks(volatile B &buffer, uint16_t *const read_values) {
+    static uint16_t write_values[buffer_length];
+    for (uint16_t i=0; i<buffer_length; i++) {
+        write_values[i] = i;
+    }
+
+    for (uint16_t i=0; i<buffer_length; i+=block_length) {
+        if (!buffer.write(block_length, &write_values[i])) {return false;}
+        if (!buffer.read(block_length, &read_values[i])) {return false;}
+    }
+    return true;
+}
+
+//fixed has no block read or write (so it is never measured)
+static bool blocks(volatile fixed_ring_buffer<uint16_t, buffer_length> &, uint16_t *const) {
+    return false;
+}
+
+typedef enum {
+    pattern_fill_then_drain,
+    pattern_write_then_read,
+    pattern_blocks,
+    pattern_count
+} pattern_t;
+
+static const char *const pattern_names[pattern_count] = {"fill then drain", "write then read", "blocks of 16"};
+
+template<typename B>
+static bool run_pattern(volatile B &buffer, pattern_t pattern, uint16_t *const read_values) {
+    switch (pattern) {
+        case pattern_fill_then_drain: return fill_then_drain(buffer, read_values);
+        case pattern_write_then_read: return write_then_read(buffer, read_values);
+        default: return blocks(buffer, read_values);
+    }
+}
+
+//the fastest of the repeats, in cycles per value (false if a value was wrong)
+template<typename B>
+static bool measure_pattern(volatile B &buffer, pattern_t pattern, uint32_t repeats, double &cycles_per_value) {
+    std::vector<uint16_t> read_values(buffer_length);
+    uint64_t fastest_ns = 0xFFFFFFFFFFFFFFFFULL;
+
+    for (uint32_t repeat=0; repeat<repeats; repeat++) {
+        //start part way in, so the indices wrap
+        buffer.reset();
+        uint16_t junk;
+        for (uint16_t i=0; i<block_offset; i++) {
+            buffer.write(0);
+            buffer.read(junk);
+        }
+
+        const uint64_t start_ns = now_ns();
+        const bool is_read_back = run_pattern(buffer, pattern, &read_values[0]);
+        fastest_ns = std::min(fastest_ns, now_ns() - start_ns);
+
+        if (!is_read_back) {return false;}
+        for (uint16_t i=0; i<buffer_length; i++) {
+            if (read_values[i] != i) {return false;}
+        }
+    }
+    cycles_per_value = ns_in_cycles_per_value(fastest_ns, buffer_length);
+    return true;
+}
+
+
+static volatile ring_buffer locked_buffer;
+static volatile fixed_ring_buffer<uint16_t, buffer_length> fixed_buffer;
+static volatile spsc_ring_buffer<uint16_t, buffer_length> spsc_buffer;
+
+
+int main(int argc, char **argv) {
+    uint32_t repeats = default_repeats;
+    if (argc > 1) {
+        repeats = static_cast<uint32_t>(strtoul(argv[1], NULL, 10));
+        if (repeats == 0) {
+            fprintf(stderr, "repeats must be > 0\n");
+            return 1;
+        }
+    }
+
+    if (!locked_buffer.init_alloc(buffer_length)) {
+        fprintf(stderr, "couldn't allocate the ring buffer\n");
+        return 1;
+    }
+
+    printf("%-18s  %18s  %18s  %18s  %8s\n", "pattern", "ring_buffer cyc/v", "fixed cyc/v", "spsc cyc/v", "speedup");
+
+    for (uint16_t pattern_i=0; pattern_i<pattern_count; pattern_i++) {
+        const pattern_t pattern = static_cast<pattern_t>(pattern_i);
+        double locked_cycles = 0.0;
+        double fixed_cycles = 0.0;
+        double spsc_cycles = 0.0;
+        check(measure_pattern(locked_buffer, pattern, repeats, locked_cycles), "ring_buffer reads back what was written");
+        if (pattern != pattern_blocks) {
+            check(measure_pattern(fixed_buffer, pattern, repeats, fixed_cycles), "fixed reads back what was written");
+        }
+        check(measure_pattern(spsc_buffer, pattern, repeats, spsc_cycles), "spsc reads back what was written");
+
+        char fixed_column[32] = "-";
+        if (pattern != pattern_blocks) {
+            snprintf(fixed_column, sizeof(fixed_column), "%.2f", fixed_cycles);
+        }
+        printf("%-18s  %18.2f  %18s  %18.2f  %7.2fx\n", pattern_names[pattern_i], locked_cycles, fixed_column, spsc_cycles,
+               (spsc_cycles > 0.0) ? (locked_cycles / spsc_cycles) : 0.0);
+    }
+
+    //when full, ring_buffer overwrites the oldest value, and spsc refuses the new one
+    uint16_t oldest = 0;
+    locked_buffer.reset();
+    spsc_buffer.reset();
+    for (uint16_t i=0; i<=buffer_length; i++) {
+        locked_buffer.write(i);
+        spsc_buffer.write(i);
+    }
+    check(locked_buffer.read(oldest) && (oldest == 1), "ring_buffer overwrote the oldest value");
+    check(spsc_buffer.read(oldest) && (oldest == 0), "spsc kept the oldest value");
+    const std::vector<uint16_t> block(block_length, 0);
+    check(!spsc_buffer.write(block_length, &block[0]) && (spsc_buffer.in_use() == (buffer_length - 1)), "spsc refuses a block that doesn't fit");
+
+    locked_buffer.dealloc_buffer();
+    return host_test_result("ring buffer");
+}
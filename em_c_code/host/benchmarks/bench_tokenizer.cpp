@@ -0,0 +1,211 @@
+/*
+ * bench_tokenizer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the cost the command tokenizer adds to one main loop iteration, streaming (json_stream) against all at once (json_create)
+// process_scia_buffer_for_commands reads at most 64 bytes per call, so streaming costs at most one 64 byte chunk,
+// while json_create used to parse the whole line in the iteration its newline arrived
+// each time is the fastest of many repeats (from the host clock, in 200MHz cycles), and the trees must match
+//
+// usage: bench_tokenizer [repeats]
+
+#include "host_test.h"
+#include "json_stream.h"
+#include "tiny_json.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+
+//the same limits as serial_link.cpp
+static const uint16_t max_command_length = 1536;
+static const uint16_t json_pool_size = 256;
+static const uint16_t max_bytes_per_call = 64;
+
+static const uint32_t default_repeats = 200;
+static const double ns_per_cycle = 5.0;
+
+
+static uint64_t now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+static uint32_t ns_in_cycles(uint64_t ns) {
+    return static_cast<uint32_t>(static_cast<double>(ns) / ns_per_cycle);
+}
+
+
+//commands
+static std::string input_settings_line(uint16_t input_number) {
+    char line[512];
+    snprintf(line, sizeof(line), "{\"command\":\"set_input_settings\",\"input_number\":%u,\"history_enabled\":true,\"history_length\":1024,"
+             "\"target_type\":\"circular_distance\",\"target_value\":32768,\"target_distance\":3000,\"actions_enabled\":true,"
+             "\"event_code_met\":%u,\"send_to_computer\":true,\"output_enabled\":true,\"output_number\":%u}", input_number, 200 + input_number, input_number % 8);
+    return std::string(line);
+}
+
+static std::string batch_line(uint16_t command_count) {
+    std::string line = "{\"command\":\"batch\",\"commands\":[";
+    for (uint16_t i=0; i<command_count; i++) {
+        if (i > 0) {line += ",";}
+        char command[128];
+        snprintf(command, sizeof(command), "{\"command\":\"set_output_settings\",\"output_number\":%u,\"on_tics\":%u,\"off_tics\":%u}", i % 8, 10 + i, 20 + i);
+        line += command;
+    }
+    return line + "]}";
+}
+
+static std::string simulation_line() {
+    std::string line = "{\"command\":\"set_input_simulation\",\"enable\":true,\"input_numbers\":[";
+    for (uint16_t i=0; i<16; i++) {
+        line += (i > 0) ? "," : "";
+        line += std::to_string(i);
+    }
+    line += "],\"values\":[";
+    for (uint16_t i=0; i<16; i++) {
+        line += (i > 0) ? "," : "";
+        line += std::to_string(30000 + (i * 397));
+    }
+    return line + "]}";
+}
+
+
+//trees
+static bool same_tree(const json_t *a, const json_t *b) {
+    while ((a != NULL) && (b != NULL)) {
+        if (a->type != b->type) {return false;}
+
+        const char *const a_name = (a->name != NULL) ? a->name : "";
+        const char *const b_name = (b->name != NULL) ? b->name : "";
+        if (strcmp(a_name, b_name) != 0) {return false;}
+
+        if ((a->type == JSON_OBJ) || (a->type == JSON_ARRAY)) {
+            if (!same_tree(a->u.child, b->u.child)) {return false;}
+        } else if (strcmp(a->u.value, b->u.value) != 0) {
+            return false;
+        }
+
+        a = a->sibling;
+        b = b->sibling;
+    }
+    return ((a == NULL) && (b == NULL));
+}
+
+
+//results
+typedef struct result_t {
+    uint32_t all_at_once_cycles;    //json_create over the whole line
+    uint32_t streamed_cycles;       //every character through json_stream
+    uint32_t worst_call_cycles;     //the longest 64 byte chunk
+    uint16_t call_count;
+} result_t;
+
+static bool measure_command(const std::string &line, uint32_t repeats, result_t &result) {
+    std::vector<char> stream_buffer(max_command_length);
+    std::vector<char> create_buffer(line.size() + 1);
+    std::vector<json_t> stream_pool(json_pool_size);
+    std::vector<json_t> create_pool(json_pool_size);
+
+    json_stream_parser parser;
+    parser.init(&stream_buffer[0], max_command_length, &stream_pool[0], json_pool_size);
+
+    const uint16_t call_count = static_cast<uint16_t>((line.size() + max_bytes_per_call - 1) / max_bytes_per_call);
+    std::vector<uint64_t> fastest_call_ns(call_count, 0xFFFFFFFFFFFFFFFFULL);
+    uint64_t fastest_stream_ns = 0xFFFFFFFFFFFFFFFFULL;
+    uint64_t fastest_create_ns = 0xFFFFFFFFFFFFFFFFULL;
+
+    const json_t *create_root = NULL;
+    for (uint32_t repeat=0; repeat<repeats; repeat++) {
+        //all at once (json_create changes the string, so it gets a fresh copy each time)
+        memcpy(&create_buffer[0], line.c_str(), line.size() + 1);
+        const uint64_t create_start_ns = now_ns();
+        create_root = json_create(&create_buffer[0], &create_pool[0], json_pool_size);
+        fastest_create_ns = std::min(fastest_create_ns, now_ns() - create_start_ns);
+
+        //streaming, one call's worth at a time
+        parser.reset();
+        uint64_t stream_ns = 0;
+        for (uint16_t call_i=0; call_i<call_count; call_i++) {
+            const size_t first = static_cast<size_t>(call_i) * max_bytes_per_call;
+            const size_t last = std::min(line.size(), first + max_bytes_per_call);
+
+            const uint64_t call_start_ns = now_ns();
+            for (size_t i=first; i<last; i++) {
+                parser.add_char(line[i]);
+            }
+            const uint64_t call_ns = now_ns() - call_start_ns;
+
+            fastest_call_ns[call_i] = std::min(fastest_call_ns[call_i], call_ns);
+            stream_ns += call_ns;
+        }
+        fastest_stream_ns = std::min(fastest_stream_ns, stream_ns);
+    }
+
+    if ((create_root == NULL) || (parser.root() == NULL) || (!same_tree(create_root, parser.root()))) {
+        return false;
+    }
+
+    result.all_at_once_cycles = ns_in_cycles(fastest_create_ns);
+    result.streamed_cycles = ns_in_cycles(fastest_stream_ns);
+    result.worst_call_cycles = ns_in_cycles(*std::max_element(fastest_call_ns.begin(), fastest_call_ns.end()));
+    result.call_count = call_count;
+    return true;
+}
+
+
+int main(int argc, char **argv) {
+    uint32_t repeats = default_repeats;
+    if (argc > 1) {
+        repeats = static_cast<uint32_t>(strtoul(argv[1], NULL, 10));
+        if (repeats == 0) {
+            fprintf(stderr, "repeats must be > 0\n");
+            return 1;
+        }
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::string> lines;
+    names.push_back("get_uptime");
+    lines.push_back("{\"command\":\"get_uptime\"}");
+    names.push_back("set_input_settings");
+    lines.push_back(input_settings_line(8));
+    names.push_back("set_input_simulation");
+    lines.push_back(simulation_line());
+    names.push_back("batch of 8");
+    lines.push_back(batch_line(8));
+    names.push_back("batch of 16");
+    lines.push_back(batch_line(16));
+
+    printf("%-22s %6s %6s  %12s  %12s  %16s\n", "command", "bytes", "calls", "json_create", "streamed", "worst 64B call");
+
+    uint32_t longest_all_at_once_cycles = 0;
+    uint32_t worst_call_cycles = 0;
+    for (size_t i=0; i<lines.size(); i++) {
+        check(lines[i].size() < max_command_length, "command fits the command buffer");
+
+        result_t result;
+        if (!measure_command(lines[i], repeats, result)) {
+            fprintf(stderr, "%s: json_stream and json_create trees differ\n", names[i].c_str());
+            check(false, "same tree");
+            continue;
+        }
+
+        printf("%-22s %6u %6u  %12u  %12u  %16u\n", names[i].c_str(), static_cast<unsigned int>(lines[i].size()),
+               result.call_count, result.all_at_once_cycles, result.streamed_cycles, result.worst_call_cycles);
+
+        longest_all_at_once_cycles = std::max(longest_all_at_once_cycles, result.all_at_once_cycles);
+        worst_call_cycles = std::max(worst_call_cycles, result.worst_call_cycles);
+    }
+
+    //the per-iteration bound is one chunk, however long the line is
+    printf("per-iteration tokenizing: at most %u cycles streamed, against %u cycles for the longest line all at once\n",
+           worst_call_cycles, longest_all_at_once_cycles);
+    check(worst_call_cycles < longest_all_at_once_cycles, "streaming bounds the per-iteration cost below the longest parse");
+
+    return host_test_result("tokenizer");
+}
@@ -0,0 +1,201 @@
+/*
+ * bench_tx_staging.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the main loop's cost of printing one delayed message, per byte: staged (rendered, then copied to the tx ring buffer at once)
+// against unstaged (each char written to the ring buffer as it is rendered, as before staging)
+// each message is queued, then printed by the main loop's print, and timed from the host clock (in 200MHz cycles, the fastest of the repeats)
+// the tx isr runs inline when it is kicked, as it would preempt on the device, so its cost is counted too
+// between prints the line is drained (the ring buffer never fills), and both ways must send the same bytes
+//
+// usage: bench_tx_staging [repeats]
+
+#include "host_test.h"
+#include "printf_json_delayed.h"
+#include "scia.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <time.h>
+
+
+static const uint32_t default_repeats = 2000;
+static const double ns_per_cycle = 5.0;
+static const uint32_t max_drain_ticks = 100;
+static const size_t staging_length = 256;   //the same as scia.cpp
+
+
+static uint64_t now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+
+//typical messages, as the firmware queues them
+static void queue_target() {
+    delay_printf_json_objects(5, json_parent("input_08", 4),
+                              json_string("reason", "external_event"),
+                              json_timestamp(123456),
+                              json_bool("target_met", true),
+                              json_bool("output_queued", false));
+}
+
+static void queue_readout() {
+    delay_printf_json_objects(3, json_parent("input_09", 2),
+                              json_string("reason", "get"),
+                              json_uint16("value", 40321));
+}
+
+static void queue_region() {
+    delay_printf_json_objects(6, json_parent("input_10", 5),
+                              json_string("reason", "external_event"),
+                              json_timestamp(123456),
+                              json_string("region", "center"),
+                              json_uint16("region_number", 3),
+                              json_bool("output_queued", true));
+}
+
+static void queue_output() {
+    delay_printf_json_objects(4, json_parent("output_03", 3),
+                              json_string("reason", "external_event"),
+                              json_timestamp(123456),
+                              json_bool("output_on", true));
+}
+
+static void queue_error() {
+    delay_printf_json_error("printf delay queue is full");
+}
+
+static void queue_settings() {
+    delay_printf_json_objects(12, json_parent("input_11", 11),
+                              json_string("reason", "get"),
+                              json_bool("history_enabled", true),
+                              json_uint16("history_length", 1024),
+                              json_bool("readout_enabled", false),
+                              json_uint64("readout_tics", 0),
+                              json_string("target_type", "rectangular_distance"),
+                              json_uint16("target_value", 32768),
+                              json_uint16("target_distance", 2000),
+                              json_uint64("target_met_min_tics", 25),
+                              json_uint64("target_left_min_tics", 10),
+                              json_float32("scale", 0.125, 4));
+}
+
+typedef struct message_kind_t {
+    const char *name;
+    void (*queue)();
+} message_kind_t;
+
+static const message_kind_t message_kinds[] = {
+    {"target", queue_target},
+    {"readout", queue_readout},
+    {"region", queue_region},
+    {"output", queue_output},
+    {"error", queue_error},
+    {"settings (12 objects)", queue_settings},
+};
+static const uint16_t message_kind_count = sizeof(message_kinds) / sizeof(message_kinds[0]);
+
+
+//runs only the timer (so nothing else is printed) until the message has been sent
+static std::string drain_line() {
+    std::string output;
+    for (uint32_t tick=0; tick<max_drain_ticks; tick++) {
+        sim_run(1, 0);
+        output += sim_serial_read();
+        if ((!output.empty()) && (output[output.size() - 1] == '\n')) {
+            break;
+        }
+    }
+    return output;
+}
+
+typedef struct result_t {
+    double cycles_per_byte;
+    uint32_t spans;         //staged copies to the ring buffer, over every timed print
+    std::string output;     //of one print
+} result_t;
+
+static result_t measure_message(const message_kind_t &kind, bool staged, uint32_t repeats) {
+    result_t result;
+    result.spans = 0;
+    scia_tx_enable_staging(staged);
+
+    uint64_t fastest_ns = 0xFFFFFFFFFFFFFFFFULL;
+    uint32_t timed_count = 0;
+    uint32_t other_count = 0;
+    while (timed_count < repeats) {
+        kind.queue();
+        const uint32_t spans_before = get_scia_statistics(false).tx_staged_spans;
+
+        const uint64_t start_ns = now_ns();
+        printf_delayed_json_objects(false);
+        const uint64_t print_ns = now_ns() - start_ns;
+
+        const std::string output = drain_line();
+        if (result.output.empty()) {
+            result.output = output;
+        }
+
+        //the isr can queue a message of its own (an over budget error, when the host is slow), which is then printed first
+        if (output != result.output) {
+            other_count++;
+            printf_delayed_json_objects(true);
+            while (!drain_line().empty()) {}
+            continue;
+        }
+
+        fastest_ns = std::min(fastest_ns, print_ns);
+        result.spans += get_scia_statistics(false).tx_staged_spans - spans_before;
+        timed_count++;
+    }
+    check(other_count < (repeats / 10), "few messages from the isr");
+
+    result.cycles_per_byte = static_cast<double>(fastest_ns) / ns_per_cycle / std::max<size_t>(result.output.size(), 1);
+    return result;
+}
+
+
+int main(int argc, char **argv) {
+    uint32_t repeats = default_repeats;
+    if (argc > 1) {
+        repeats = static_cast<uint32_t>(strtoul(argv[1], NULL, 10));
+        if (repeats == 0) {
+            fprintf(stderr, "repeats must be > 0\n");
+            return 1;
+        }
+    }
+
+    //boot, and send everything it printed
+    sim_boot();
+    sim_run(1000, 2);
+    sim_serial_read();
+
+    //a short line written as one span (without staging) still starts the tx isr
+    scia_tx_enable_staging(false);
+    printf_string("{\"short\":1}\r\n");
+    check(drain_line() == "{\"short\":1}\r\n", "a short span is sent");
+
+    printf("%-24s  %6s  %16s  %16s  %8s\n", "message", "bytes", "unstaged cyc/B", "staged cyc/B", "speedup");
+
+    for (uint16_t kind_i=0; kind_i<message_kind_count; kind_i++) {
+        const message_kind_t &kind = message_kinds[kind_i];
+        const result_t unstaged = measure_message(kind, false, repeats);
+        const result_t staged = measure_message(kind, true, repeats);
+
+        printf("%-24s  %6u  %16.2f  %16.2f  %7.2fx\n", kind.name, static_cast<unsigned int>(staged.output.size()),
+               unstaged.cycles_per_byte, staged.cycles_per_byte, unstaged.cycles_per_byte / staged.cycles_per_byte);
+
+        if (staged.output != unstaged.output) {
+            fprintf(stderr, "%s:\n  unstaged %s  staged   %s", kind.name, unstaged.output.c_str(), staged.output.c_str());
+        }
+        check(!staged.output.empty() && (staged.output[staged.output.size() - 1] == '\n'), "the whole message is sent");
+        check(staged.output == unstaged.output, "staged sends the same bytes");
+        const uint32_t spans_per_message = static_cast<uint32_t>((staged.output.size() + staging_length - 1) / staging_length);
+        check(staged.spans == (spans_per_message * repeats), "staged is one copy to the ring buffer per message (or per staging buffer)");
+        check(unstaged.spans == 0, "unstaged never stages");
+    }
+
+    return host_test_result("tx staging");
+}
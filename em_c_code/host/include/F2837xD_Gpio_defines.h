@@ -0,0 +1,36 @@
+/*
+ * F2837xD_Gpio_defines.h (host)
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the same values as the ti header, offsets are in 32-bit registers
+
+#ifndef F2837xD_GPIO_DEFINES_H
+#define F2837xD_GPIO_DEFINES_H
+
+//mux
+#define GPIO_MUX_CPU1       0x0
+#define GPIO_MUX_CPU1CLA    0x1
+#define GPIO_MUX_CPU2       0x2
+#define GPIO_MUX_CPU2CLA    0x3
+
+//options
+#define GPIO_INPUT          0
+#define GPIO_OUTPUT         1
+#define GPIO_PUSHPULL       0
+#define GPIO_PULLUP         (1 << 0)
+#define GPIO_INVERT         (1 << 1)
+#define GPIO_OPENDRAIN      (1 << 2)
+#define GPIO_SYNC           (0x0 << 4)
+#define GPIO_QUAL3          (0x1 << 4)
+#define GPIO_QUAL6          (0x2 << 4)
+#define GPIO_ASYNC          (0x3 << 4)
+
+//data registers
+#define GPY_DATA_OFFSET     (0x8/2)
+#define GPYDAT              (0x0/2)
+#define GPYSET              (0x2/2)
+#define GPYCLEAR            (0x4/2)
+#define GPYTOGGLE           (0x6/2)
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * F2837xD_device.h (host)
+ *
+ *  Created on: Oct 17, 2026
+ */
+// everything is in the host F28x_Project.h
+
+#ifndef F2837xD_DEVICE_H
+#define F2837xD_DEVICE_H
+
+#include "F28x_Project.h"
+
+#endif
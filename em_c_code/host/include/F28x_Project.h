@@ -0,0 +1,314 @@
+/*
+ * F28x_Project.h (host)
+ *
+ *  Created on: Oct 17, 2026
+ */
+// simulated register layer, so common/ can be built and run on a linux host
+// shadows the ti header of the same name (host/include is searched first)
+// only the registers (and fields) that common/ touches are here, most are plain memory
+// the sci fifo and the free-running counter are backed by the simulation (host/sim)
+
+#ifndef F28X_PROJECT_H
+#define F28X_PROJECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>     //the ti headers bring this in
+#include "F2837xD_Gpio_defines.h"
+
+
+//ti types (the c28x has no 8-bit type, so these are only as wide as their names)
+typedef int16_t     int16;
+typedef int32_t     int32;
+typedef int64_t     int64;
+typedef uint16_t    Uint16;
+typedef uint32_t    Uint32;
+typedef uint64_t    Uint64;
+typedef float       float32;
+typedef double      float64;
+
+//compiler extensions
+#define __interrupt
+#define EALLOW
+#define EDIS
+#define EINT        host_enable_interrupts()
+#define DINT        host_disable_interrupts()
+#define ESTOP0      host_estop0()
+
+//cpu interrupts
+#define M_INT1      0x0001
+#define M_INT9      0x0100
+#define M_INT13     0x1000
+#define M_INT14     0x2000
+
+extern volatile uint16_t IER;
+extern volatile uint16_t IFR;
+
+void host_enable_interrupts();
+void host_disable_interrupts();
+void host_estop0();
+
+//delay
+void host_delay_us(float64 us);
+#define DELAY_US(A) host_delay_us(A)
+
+//cla triggers
+#define CLA_TRIG_TINT0      68
+
+
+//pie
+typedef __interrupt void (*PINT)(void);
+
+struct PIE_VECT_TABLE {
+    PINT TIMER0_INT;
+    PINT TIMER1_INT;
+    PINT TIMER2_INT;
+    PINT XINT1_INT;
+    PINT SCIA_RX_INT;
+    PINT SCIA_TX_INT;
+    PINT CLA1_4_INT;
+};
+
+struct PIEIER_BITS {
+    uint16_t INTx1;
+    uint16_t INTx2;
+    uint16_t INTx3;
+    uint16_t INTx4;
+    uint16_t INTx5;
+    uint16_t INTx6;
+    uint16_t INTx7;
+    uint16_t INTx8;
+};
+union PIEIER_REG {
+    uint16_t all;
+    struct PIEIER_BITS bit;
+};
+
+struct PIEACK_BITS {
+    uint16_t ACK1;
+    uint16_t ACK9;
+};
+union PIEACK_REG {
+    uint16_t all;
+    struct PIEACK_BITS bit;
+};
+
+struct PIE_CTRL_REGS {
+    union PIEACK_REG PIEACK;
+    union PIEIER_REG PIEIER1;
+    union PIEIER_REG PIEIER9;
+};
+
+
+//system control (the clock enables are only stored)
+struct PCLKCR0_BITS {
+    uint16_t CPUTIMER0;
+    uint16_t CPUTIMER1;
+    uint16_t CPUTIMER2;
+    uint16_t TBCLKSYNC;
+};
+struct PCLKCR2_BITS {
+    uint16_t EPWM1;
+    uint16_t EPWM2;
+    uint16_t EPWM3;
+    uint16_t EPWM4;
+    uint16_t EPWM5;
+    uint16_t EPWM6;
+    uint16_t EPWM7;
+};
+struct PCLKCR7_BITS {
+    uint16_t SCI_A;
+};
+struct CPU_SYS_REGS {
+    struct {struct PCLKCR0_BITS bit;} PCLKCR0;
+    struct {struct PCLKCR2_BITS bit;} PCLKCR2;
+    struct {struct PCLKCR7_BITS bit;} PCLKCR7;
+};
+
+struct CLK_CFG_REGS {
+    struct {struct {uint16_t EPWMCLKDIV;} bit;} PERCLKDIVSEL;
+};
+
+
+//epwm (only used as timebases by tic_toc, so the counters do not run)
+#define TB_COUNT_UP     0x0
+#define TB_FREEZE       0x3
+#define TB_DISABLE      0x0
+
+struct TBCTL_BITS {
+    uint16_t CTRMODE;
+    uint16_t PHSEN;
+    uint16_t PRDLD;
+    uint16_t SYNCOSEL;
+    uint16_t SWFSYNC;
+    uint16_t HSPCLKDIV;
+    uint16_t CLKDIV;
+    uint16_t PHSDIR;
+    uint16_t FREE_SOFT;
+};
+struct EPWM_REGS {
+    struct {struct TBCTL_BITS bit;} TBCTL;
+    uint16_t TBCTR;
+    struct {struct {uint16_t TBPHS;} bit;} TBPHS;
+    uint16_t TBPRD;
+};
+
+
+//external interrupts and input xbar
+struct XINT_REGS {
+    struct {struct {uint16_t ENABLE; uint16_t POLARITY;} bit;} XINT1CR;
+};
+struct INPUT_XBAR_REGS {
+    uint16_t INPUT4SELECT;
+};
+
+
+//cpu timers (the simulation calls the isr while TSS is 0 and TIE is 1)
+struct TCR_BITS {
+    uint16_t TSS;
+    uint16_t TRB;
+    uint16_t SOFT;
+    uint16_t FREE;
+    uint16_t TIE;
+    uint16_t TIF;
+};
+struct CPUTIMER_REGS {
+    union {uint32_t all;} TIM;
+    union {uint32_t all;} PRD;
+    union {uint16_t all; struct TCR_BITS bit;} TCR;
+    union {uint16_t all;} TPR;
+    union {uint16_t all;} TPRH;
+};
+
+
+//sci (the fifo fields are read and written through the simulated peripheral)
+enum host_sci_field_t {
+    host_sci_txffst = 0,
+    host_sci_txffintclr,
+    host_sci_rxffst,
+    host_sci_rxffintclr,
+    host_sci_rxffovf,
+    host_sci_rxffovrclr,
+    host_sci_txfiforeset,
+    host_sci_rxfiforeset,
+    host_sci_txdt,
+    host_sci_sar
+};
+
+uint16_t host_sci_read(host_sci_field_t field);
+void host_sci_write(host_sci_field_t field, uint16_t value);
+
+template <host_sci_field_t field>
+class host_sci_register {
+    public:
+        operator uint16_t() const volatile {return host_sci_read(field);}
+        void operator=(uint16_t value) volatile {host_sci_write(field, value);}
+};
+
+struct SCICCR_BITS {
+    uint16_t SCICHAR;
+    uint16_t ADDRIDLE_MODE;
+    uint16_t LOOPBKENA;
+    uint16_t PARITYENA;
+    uint16_t PARITY;
+    uint16_t STOPBITS;
+};
+struct SCICTL1_BITS {
+    uint16_t RXERRINTENA;
+    uint16_t SWRESET;
+    uint16_t TXWAKE;
+    uint16_t SLEEP;
+    uint16_t TXENA;
+    uint16_t RXENA;
+};
+struct SCICTL2_BITS {
+    uint16_t TXINTENA;
+    uint16_t RXBKINTENA;
+};
+struct SCIFFTX_BITS {
+    uint16_t TXFFIL;
+    uint16_t TXFFIENA;
+    host_sci_register<host_sci_txffintclr> TXFFINTCLR;
+    host_sci_register<host_sci_txffst> TXFFST;
+    host_sci_register<host_sci_txfiforeset> TXFIFORESET;
+    uint16_t SCIFFENA;
+    uint16_t SCIRST;
+};
+struct SCIFFRX_BITS {
+    uint16_t RXFFIL;
+    uint16_t RXFFIENA;
+    host_sci_register<host_sci_rxffintclr> RXFFINTCLR;
+    host_sci_register<host_sci_rxffst> RXFFST;
+    host_sci_register<host_sci_rxfiforeset> RXFIFORESET;
+    host_sci_register<host_sci_rxffovrclr> RXFFOVRCLR;
+    host_sci_register<host_sci_rxffovf> RXFFOVF;
+};
+struct SCIFFCT_BITS {
+    uint16_t FFTXDLY;
+    uint16_t CDC;
+    uint16_t ABDCLR;
+    uint16_t ABD;
+};
+struct SCI_REGS {
+    struct {struct SCICCR_BITS bit;} SCICCR;
+    struct {struct SCICTL1_BITS bit;} SCICTL1;
+    union {uint16_t all;} SCIHBAUD;
+    union {uint16_t all;} SCILBAUD;
+    struct {struct SCICTL2_BITS bit;} SCICTL2;
+    struct {struct {host_sci_register<host_sci_sar> SAR;} bit;} SCIRXBUF;
+    struct {struct {host_sci_register<host_sci_txdt> TXDT;} bit;} SCITXBUF;
+    struct {struct SCIFFTX_BITS bit;} SCIFFTX;
+    struct {struct SCIFFRX_BITS bit;} SCIFFRX;
+    struct {struct SCIFFCT_BITS bit;} SCIFFCT;
+};
+
+
+//ipc (only the free-running counter, which counts 200MHz cycles of the host clock)
+uint32_t host_cpu_timestamp();
+
+class host_ipc_counter {
+    public:
+        operator uint32_t() const volatile {return host_cpu_timestamp();}
+};
+
+struct IPC_REGS_CPU1 {
+    host_ipc_counter IPCCOUNTERL;
+};
+
+
+//gpio data (4 32-bit registers per port: DAT, SET, CLEAR and TOGGLE)
+//these are plain memory, so gpio_write_pin applies SET and CLEAR to DAT itself on the host
+static const uint16_t host_gpio_port_count = 6;
+
+struct GPIO_DATA_REGS {
+    uint32_t port[host_gpio_port_count][GPY_DATA_OFFSET];
+};
+
+void GPIO_SetupPinMux(Uint16 gpioNumber, Uint16 cpu, Uint16 muxPosition);
+void GPIO_SetupPinOptions(Uint16 gpioNumber, Uint16 output, Uint16 flags);
+Uint16 GPIO_ReadPin(Uint16 gpioNumber);
+void GPIO_WritePin(Uint16 gpioNumber, Uint16 outVal);
+
+
+//register instances (defined in host/sim)
+extern volatile struct PIE_VECT_TABLE PieVectTable;
+extern volatile struct PIE_CTRL_REGS PieCtrlRegs;
+extern volatile struct CPU_SYS_REGS CpuSysRegs;
+extern volatile struct CLK_CFG_REGS ClkCfgRegs;
+extern volatile struct EPWM_REGS EPwm1Regs;
+extern volatile struct EPWM_REGS EPwm2Regs;
+extern volatile struct EPWM_REGS EPwm3Regs;
+extern volatile struct EPWM_REGS EPwm4Regs;
+extern volatile struct EPWM_REGS EPwm5Regs;
+extern volatile struct EPWM_REGS EPwm6Regs;
+extern volatile struct EPWM_REGS EPwm7Regs;
+extern volatile struct XINT_REGS XintRegs;
+extern volatile struct INPUT_XBAR_REGS InputXbarRegs;
+extern volatile struct CPUTIMER_REGS CpuTimer0Regs;
+extern volatile struct CPUTIMER_REGS CpuTimer1Regs;
+extern volatile struct CPUTIMER_REGS CpuTimer2Regs;
+extern volatile struct SCI_REGS SciaRegs;
+extern volatile struct IPC_REGS_CPU1 IpcRegs;
+extern volatile struct GPIO_DATA_REGS GpioDataRegs;
+
+#endif
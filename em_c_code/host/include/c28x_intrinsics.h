@@ -0,0 +1,19 @@
+/*
+ * c28x_intrinsics.h (host)
+ *
+ *  Created on: Oct 17, 2026
+ */
+// force-included into every host translation unit (-include)
+// stands in for what the ti compiler provides without any header
+
+#ifndef C28X_INTRINSICS_H
+#define C28X_INTRINSICS_H
+
+#include <stddef.h>     //NULL comes with the ti stdint.h
+#include <stdint.h>
+
+//interrupt intrinsics (returns/restores the previous INTM state)
+uint16_t __disable_interrupts();
+void __restore_interrupts(uint16_t interrupt_settings);
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * host_sim.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// runs the firmware in common/ as a simulated 79D with daughterboard 3
+// lockstep: the caller owns time, and every interrupt runs inline on the calling thread
+//  (whenever it would be allowed to preempt: register accesses, restoring interrupts, or a tick)
+// realtime: timer0 and the sci line run from the host clock, on their own interrupt thread
+
+#ifndef host_sim_defined
+#define host_sim_defined
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string>
+
+
+//line settings (matches init_scia in ti_launchpad)
+static const uint32_t sim_baud_rate = 921600;
+static const uint16_t sim_bits_per_byte = 10;   //8N1: start, 8 data, stop
+
+//timer0 period (the io_controller main loop runs at 10kHz)
+static const uint32_t sim_timer0_hz = 10000;
+
+
+//boot (the same sequence as the device main), then start the main loop timer
+//the tx bytes printed while booting are left in the tx output
+void sim_boot();
+bool sim_is_booted();
+
+//lockstep
+void sim_main_loop_once();
+void sim_timer0_tick();     //one timer0 period of time (also moves rx bytes at the baud rate)
+void sim_run(uint32_t ticks, uint16_t main_loops_per_tick);
+
+//realtime (the calling thread becomes the device main loop, until sim_stop is called)
+void sim_run_realtime();
+void sim_stop();
+
+//serial line (from the point of view of the host)
+//rx bytes are queued on the line, tx bytes are collected as they leave the fifo
+void sim_serial_write(const std::string &bytes);
+std::string sim_serial_read();
+size_t sim_serial_rx_pending();
+void sim_serial_set_tx_sink(void (*sink)(const uint16_t *bytes, size_t count));
+
+//the command line (json, with the trailing newline added)
+void sim_send_command(const std::string &json_line);
+
+//pty (a virtual com port for host clients, set up before running realtime)
+//the tx bytes go to the pty instead of the tx output, and what the client writes is queued on the line
+typedef struct sim_pty_stats_t {
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t tx_dropped_bytes;  //no room in the pty (nobody reading)
+} sim_pty_stats_t;
+
+bool sim_pty_open(std::string &slave_path);
+void sim_pty_close();
+sim_pty_stats_t sim_pty_stats();
+
+//flash (the sector kept for the saved profile), erased until a file is set
+//the file is read now (a missing one is an erased sector), and written each time the firmware changes the sector
+bool sim_flash_set_file(const std::string &path);
+void sim_flash_erase();
+
+//hardware
+void sim_set_analog_in(uint16_t channel, uint16_t raw_value);
+void sim_set_gpio(uint16_t gpio_number, bool value);
+bool sim_get_gpio(uint16_t gpio_number);
+
+//counts
+uint64_t sim_timer0_count();
+uint64_t sim_isr_count();
+
+#endif
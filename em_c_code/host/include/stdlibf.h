@@ -0,0 +1,15 @@
+/*
+ * stdlibf.h (host)
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the ti rts heap query, answered by the simulation
+
+#ifndef STDLIBF_H
+#define STDLIBF_H
+
+#include <stddef.h>
+
+size_t __TI_heap_total_available();
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * analog_adcs.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// host stand-in for the ADS8688 and internal adcs
+// there is no spi or adc, so cla_analog_in_voltages is written by sim_set_analog_in instead of a cla task
+
+#include "ADS8688_adc.h"
+#include "internal_adc.h"
+#include "analog_input_cla.h"
+#include "printf_json_delayed.h"
+#include "daughterboard.h"
+#include "sim_internal.h"
+
+
+//internal variables
+static const uint16_t ADS8688_channels = 8;
+static volatile bool ads_adc_initialized = false;
+
+
+bool init_ADS8688_adc(const analog_in_spi_t analog_in_spi_settings) {
+    (void)analog_in_spi_settings;
+
+    if (db_board.is_not_enabled()) {
+        delay_printf_json_error("cannot initialize analog in without daughterboard");
+        return false;
+    }
+
+    if (ads_adc_initialized) {return true;}
+
+    if (cla_analog_in_count != ADS8688_channels) {
+        delay_printf_json_error("count does not match ADS8688 count");
+        return false;
+    }
+
+    //every channel starts at 0V
+    for (uint16_t i=0; i<ADS8688_channels; i++) {
+        cla_analog_in_voltages[i] = 32768;
+    }
+
+    ads_adc_initialized = true;
+    delay_printf_json_status("initialized ADS8688 analog in");
+    return true;
+}
+
+float32 ADS8688_adc_cla_task_length_in_us() {
+    return 0.0;
+}
+
+void change_ADS8688_range(uint16_t range_id) {
+    //where 0 is normal(+/-10.24V), 1 is half, and 2 is quarter
+    switch (range_id) {
+        case 0:
+            set_voltage_conversion_factor(3200);
+            break;
+        case 1:
+            set_voltage_conversion_factor(6400);
+            break;
+        case 2:
+            set_voltage_conversion_factor(12800);
+            break;
+    }
+}
+
+//daughterboard 3 uses the ADS8688, so the internal adc is never initialized
+bool init_internal_adc(const analog_in_ti_t analog_in_settings) {
+    (void)analog_in_settings;
+    delay_printf_json_error("internal adc is not simulated");
+    return false;
+}
+
+float32 internal_adc_cla_task_length_in_us() {
+    return 0.0;
+}
+
+
+//hardware
+void sim_set_analog_in(uint16_t channel, uint16_t raw_value) {
+    if (channel >= ADS8688_channels) {return;}
+    cla_analog_in_voltages[channel] = raw_value;
+}
@@ -0,0 +1,118 @@
+/*
+ * sim_device.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// boots the firmware, and owns time (lockstep: the caller, realtime: the host clock)
+
+#include "sim_internal.h"
+#include "em_main.h"
+#include <atomic>
+#include <thread>
+
+
+//bytes that cross the line in one timer0 period
+static const float64 bytes_per_tick = static_cast<float64>(sim_baud_rate) / static_cast<float64>(sim_bits_per_byte) / static_cast<float64>(sim_timer0_hz);
+static const uint64_t ns_per_tick = 1000000000ULL / sim_timer0_hz;
+
+static bool is_booted = false;
+static uint64_t timer0_count = 0;
+static std::atomic<bool> keep_running(false);
+
+
+//boot
+void sim_boot() {
+    sim_set_realtime(false);
+    sim_reset_interrupts();
+    sim_sci_reset();
+    sim_sci_set_unthrottled_tx(true);
+    sim_gpio_reset();
+    timer0_count = 0;
+
+    startup_experimental_monitor();
+    start_experimental_monitor_main_loop();
+    is_booted = true;
+}
+
+bool sim_is_booted() {
+    return is_booted;
+}
+
+
+//lockstep
+void sim_main_loop_once() {
+    run_experimental_monitor_main_loop_once();
+    sim_service_interrupts();
+}
+
+void sim_timer0_tick() {
+    sim_sci_add_rx_credit(bytes_per_tick);
+    sim_request_timer0();
+    timer0_count++;
+    sim_service_interrupts();
+}
+
+void sim_run(uint32_t ticks, uint16_t main_loops_per_tick) {
+    for (uint32_t i=0; i<ticks; i++) {
+        sim_timer0_tick();
+        for (uint16_t j=0; j<main_loops_per_tick; j++) {
+            sim_main_loop_once();
+        }
+    }
+}
+
+
+//realtime
+static void run_interrupt_thread() {
+    uint64_t next_tick_ns = sim_host_ns() + ns_per_tick;
+
+    while (keep_running) {
+        const uint64_t now_ns = sim_host_ns();
+
+        //catch up on any missed ticks (each one only moves a tick worth of bytes, and gets its own isrs)
+        while (now_ns >= next_tick_ns) {
+            sim_sci_add_rx_credit(bytes_per_tick);
+            sim_sci_add_tx_credit(bytes_per_tick);
+            sim_request_timer0();
+            timer0_count++;
+            next_tick_ns += ns_per_tick;
+            sim_run_interrupts();
+        }
+
+        sim_run_interrupts();
+        std::this_thread::yield();
+    }
+}
+
+void sim_run_realtime() {
+    if (!is_booted) {return;}
+
+    sim_sci_set_unthrottled_tx(false);
+    sim_set_realtime(true);
+    keep_running = true;
+
+    std::thread interrupt_thread(run_interrupt_thread);
+    while (keep_running) {
+        run_experimental_monitor_main_loop_once();
+    }
+    interrupt_thread.join();
+
+    sim_set_realtime(false);
+    sim_sci_set_unthrottled_tx(true);
+}
+
+void sim_stop() {
+    keep_running = false;
+}
+
+
+//serial line
+void sim_send_command(const std::string &json_line) {
+    sim_serial_write(json_line + "\n");
+}
+
+
+//counts
+uint64_t sim_timer0_count() {
+    return timer0_count;
+}
@@ -0,0 +1,110 @@
+/*
+ * sim_flash.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// sector N in memory, and optionally in a file (so what is saved is still there the next time the sim boots)
+// programming only clears bits, and each 128-bit block can only be programmed once per erase (like the ecc'd flash)
+
+#include "sim_internal.h"
+#include "flash_sector.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+
+static const uint16_t sector_word_count = 0x2000;
+static std::vector<uint16_t> sector(sector_word_count, 0xFFFF);
+static std::vector<bool> programmed_blocks(sector_word_count / flash_sector_align_words, false);
+static std::string file_path;
+
+
+//internal functions
+static bool save_file();
+
+
+bool sim_flash_set_file(const std::string &path) {
+    file_path = path;
+    sim_flash_erase();
+    if (path.empty()) {return true;}
+
+    //a missing file is an erased sector
+    FILE *const file = fopen(path.c_str(), "rb");
+    if (file == NULL) {return true;}
+
+    uint8_t bytes[2];
+    for (uint16_t i=0; (i<sector_word_count) && (fread(bytes, 1, 2, file) == 2); i++) {
+        sector[i] = static_cast<uint16_t>(bytes[0] | (static_cast<uint16_t>(bytes[1]) << 8));
+    }
+    fclose(file);
+
+    //whatever was programmed can't be programmed again
+    for (uint16_t block_i=0; block_i<programmed_blocks.size(); block_i++) {
+        for (uint16_t i=0; i<flash_sector_align_words; i++) {
+            if (sector[(block_i * flash_sector_align_words) + i] != 0xFFFF) {
+                programmed_blocks[block_i] = true;
+            }
+        }
+    }
+    return true;
+}
+
+void sim_flash_erase() {
+    std::fill(sector.begin(), sector.end(), 0xFFFF);
+    std::fill(programmed_blocks.begin(), programmed_blocks.end(), false);
+}
+
+
+//the firmware side (flash_sector.h)
+uint16_t flash_sector_word_count() {
+    return sector_word_count;
+}
+
+bool flash_sector_erase() {
+    sim_flash_erase();
+    return save_file();
+}
+
+bool flash_sector_write(uint16_t word_offset, const void *const words, uint16_t word_count) {
+    if ((word_offset % flash_sector_align_words) != 0) {return false;}
+    if ((word_offset > sector_word_count) || (word_count > (sector_word_count - word_offset))) {return false;}
+    if (word_count == 0) {return true;}
+
+    //every block it touches must still be erased
+    const uint16_t last_block_i = (word_offset + word_count - 1) / flash_sector_align_words;
+    for (uint16_t block_i=(word_offset / flash_sector_align_words); block_i<=last_block_i; block_i++) {
+        if (programmed_blocks[block_i]) {return false;}
+    }
+
+    const uint16_t *const words_ptr = reinterpret_cast<const uint16_t *>(words);
+    for (uint16_t i=0; i<word_count; i++) {
+        sector[word_offset + i] &= words_ptr[i];
+        programmed_blocks[(word_offset + i) / flash_sector_align_words] = true;
+    }
+    return save_file();
+}
+
+bool flash_sector_read(uint16_t word_offset, void *const words, uint16_t word_count) {
+    if ((word_offset > sector_word_count) || (word_count > (sector_word_count - word_offset))) {return false;}
+
+    memcpy(words, &sector[word_offset], static_cast<size_t>(word_count) * sizeof(uint16_t));
+    return true;
+}
+
+
+//the whole sector each time (it is only 16kB)
+static bool save_file() {
+    if (file_path.empty()) {return true;}
+
+    FILE *const file = fopen(file_path.c_str(), "wb");
+    if (file == NULL) {return false;}
+
+    bool is_saved = true;
+    for (uint16_t i=0; (i<sector_word_count) && is_saved; i++) {
+        const uint8_t bytes[2] = {static_cast<uint8_t>(sector[i] & 0xFF), static_cast<uint8_t>(sector[i] >> 8)};
+        is_saved = (fwrite(bytes, 1, 2, file) == 2);
+    }
+
+    return (fclose(file) == 0) && is_saved;
+}
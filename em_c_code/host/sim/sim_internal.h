@@ -0,0 +1,38 @@
+/*
+ * sim_internal.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// shared between the simulation files only
+
+#ifndef sim_internal_defined
+#define sim_internal_defined
+
+#include "F28x_Project.h"
+#include "host_sim.h"
+
+
+//interrupts
+bool sim_is_realtime();
+void sim_set_realtime(bool realtime);
+void sim_service_interrupts();      //a point where a pending interrupt could preempt (lockstep only)
+void sim_run_interrupts();          //runs every pending interrupt (the caller must be allowed to)
+void sim_request_timer0();
+void sim_run_cla_tasks(uint16_t trigger);
+void sim_reset_interrupts();
+
+//sci
+void sim_sci_reset();
+void sim_sci_add_rx_credit(float64 bytes);
+void sim_sci_add_tx_credit(float64 bytes);
+void sim_sci_set_unthrottled_tx(bool unthrottled);
+void sim_sci_transfer();
+PINT sim_sci_pending_isr();
+
+//gpio
+void sim_gpio_reset();
+
+//time
+uint64_t sim_host_ns();
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * sim_interrupts.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// INTM, the interrupt intrinsics, and dispatching the isrs
+// an isr always runs to completion with INTM set, and never while a thread has interrupts disabled
+// lockstep: pending isrs run inline on the thread that reaches a service point with INTM clear
+// realtime: only the interrupt thread runs isrs, so the main thread just waits on the same lock
+
+#include "sim_internal.h"
+#include "cla.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+
+//cpu registers
+volatile uint16_t IER = 0;
+volatile uint16_t IFR = 0;
+
+//INTM
+static std::recursive_mutex interrupt_lock;     //held whenever INTM is set on any thread
+static thread_local uint16_t thread_intm = 0;   //1 while this thread has interrupts disabled (or is in an isr)
+static volatile bool global_interrupts_enabled = false;     //EINT/DINT (the device starts with INTM set)
+static volatile bool is_realtime = false;
+static volatile bool is_running_interrupts = false;
+static volatile uint64_t isr_count = 0;
+static std::atomic<bool> interrupt_waiting(false);  //realtime: the interrupt thread wants INTM (a real isr would preempt)
+
+//timer0
+static volatile bool timer0_pending = false;
+
+//cla tasks (only the tasks triggered by timer0 are simulated)
+static const uint16_t cla_task_count = 8;
+static cla_task_function_ptr cla_tasks[cla_task_count];
+static uint16_t cla_task_triggers[cla_task_count];
+
+
+//intrinsics
+uint16_t __disable_interrupts() {
+    const uint16_t previous = thread_intm;
+    if (previous == 0) {
+        //a waiting interrupt goes first, otherwise the main loop could keep taking INTM back before it gets in
+        while (is_realtime && interrupt_waiting) {
+            std::this_thread::yield();
+        }
+        interrupt_lock.lock();
+        thread_intm = 1;
+    }
+    return previous;
+}
+
+void __restore_interrupts(uint16_t interrupt_settings) {
+    if ((interrupt_settings == 0) && (thread_intm == 1)) {
+        thread_intm = 0;
+        interrupt_lock.unlock();
+        sim_service_interrupts();
+    }
+}
+
+void host_enable_interrupts() {
+    global_interrupts_enabled = true;
+    sim_service_interrupts();
+}
+
+void host_disable_interrupts() {
+    global_interrupts_enabled = false;
+}
+
+
+//mode
+bool sim_is_realtime() {
+    return is_realtime;
+}
+
+void sim_set_realtime(bool realtime) {
+    is_realtime = realtime;
+}
+
+void sim_reset_interrupts() {
+    IER = 0;
+    IFR = 0;
+    global_interrupts_enabled = false;
+    timer0_pending = false;
+    isr_count = 0;
+    for (uint16_t i=0; i<cla_task_count; i++) {
+        cla_tasks[i] = NULL;
+        cla_task_triggers[i] = 0;
+    }
+}
+
+
+//dispatch
+static PINT next_pending_isr() {
+    if (!global_interrupts_enabled) {return NULL;}
+
+    //group 1 (timer0) is higher priority than group 9 (sci)
+    if (timer0_pending) {
+        timer0_pending = false;
+        const bool enabled = ((IER & M_INT1) != 0) && (PieCtrlRegs.PIEIER1.bit.INTx7 != 0);
+        if (enabled && (PieVectTable.TIMER0_INT != NULL)) {
+            return PieVectTable.TIMER0_INT;
+        }
+    }
+
+    if ((IER & M_INT9) != 0) {
+        return sim_sci_pending_isr();
+    }
+
+    return NULL;
+}
+
+void sim_run_interrupts() {
+    if (is_running_interrupts) {return;}
+
+    interrupt_waiting = is_realtime;
+    interrupt_lock.lock();
+    interrupt_waiting = false;
+    const uint16_t previous_intm = thread_intm;
+    thread_intm = 1;
+    is_running_interrupts = true;
+
+    while (true) {
+        sim_sci_transfer();
+
+        const PINT isr = next_pending_isr();
+        if (isr == NULL) {break;}
+
+        isr();
+        isr_count++;
+    }
+
+    is_running_interrupts = false;
+    thread_intm = previous_intm;
+    interrupt_lock.unlock();
+}
+
+void sim_service_interrupts() {
+    if (is_realtime || (thread_intm != 0)) {return;}
+    sim_run_interrupts();
+}
+
+
+uint64_t sim_isr_count() {
+    return isr_count;
+}
+
+
+//timer0 (the cla tasks on the same trigger finish before the cpu isr reads their results)
+void sim_request_timer0() {
+    if ((CpuTimer0Regs.TCR.bit.TSS != 0) || (CpuTimer0Regs.TCR.bit.TIE == 0)) {return;}
+
+    sim_run_cla_tasks(CLA_TRIG_TINT0);
+    timer0_pending = true;
+}
+
+void sim_run_cla_tasks(uint16_t trigger) {
+    for (uint16_t i=0; i<cla_task_count; i++) {
+        if ((cla_tasks[i] != NULL) && (cla_task_triggers[i] == trigger)) {
+            cla_tasks[i]();
+        }
+    }
+}
+
+
+//cla stand-in (the tasks run on the cpu, when their trigger happens)
+void init_cla(void) {
+    for (uint16_t i=0; i<cla_task_count; i++) {
+        cla_tasks[i] = NULL;
+    }
+}
+
+void enable_cla_task(uint16_t task_number, cla_task_function_ptr cla_function, uint16_t trigger) {
+    if ((task_number == 0) || (task_number > cla_task_count)) {return;}
+    cla_tasks[task_number - 1] = cla_function;
+    cla_task_triggers[task_number - 1] = trigger;
+}
+
+void disable_cla_task(uint16_t task_number) {
+    if ((task_number == 0) || (task_number > cla_task_count)) {return;}
+    cla_tasks[task_number - 1] = NULL;
+}
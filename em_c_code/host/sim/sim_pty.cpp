@@ -0,0 +1,158 @@
+/*
+ * sim_pty.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the simulated line as a linux pseudo-terminal, so a host client can open it like the FTDI port
+// the pty itself is not throttled, the sim moves the bytes at the baud rate (8N1) on both sides of the line
+// like the FTDI, the device is never held up by the host: tx bytes with nowhere to go are dropped
+
+#include "sim_internal.h"
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+
+static int master_fd = -1;
+static int slave_fd = -1;      //held open, so the master doesn't hang up between clients
+static std::thread reader_thread;
+static std::atomic<bool> keep_reading(false);
+
+//counts
+static std::atomic<uint64_t> rx_byte_count(0);
+static std::atomic<uint64_t> tx_byte_count(0);
+static std::atomic<uint64_t> tx_dropped_count(0);
+
+
+//internal functions
+static bool set_raw_line(int fd);
+static void write_to_pty(const uint16_t *bytes, size_t count);
+static void read_from_pty();
+
+
+bool sim_pty_open(std::string &slave_path) {
+    if (master_fd >= 0) {return false;}
+
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0) {return false;}
+
+    char path[128];
+    if ((grantpt(master_fd) != 0) || (unlockpt(master_fd) != 0) || (ptsname_r(master_fd, path, sizeof(path)) != 0)) {
+        sim_pty_close();
+        return false;
+    }
+
+    slave_fd = open(path, O_RDWR | O_NOCTTY);
+    if ((slave_fd < 0) || (!set_raw_line(slave_fd))) {
+        sim_pty_close();
+        return false;
+    }
+
+    //writes never block the interrupt thread
+    fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+
+    rx_byte_count = 0;
+    tx_byte_count = 0;
+    tx_dropped_count = 0;
+
+    keep_reading = true;
+    reader_thread = std::thread(read_from_pty);
+    sim_serial_set_tx_sink(write_to_pty);
+
+    slave_path = path;
+    return true;
+}
+
+void sim_pty_close() {
+    sim_serial_set_tx_sink(NULL);
+
+    keep_reading = false;
+    if (reader_thread.joinable()) {
+        reader_thread.join();
+    }
+
+    if (slave_fd >= 0) {
+        close(slave_fd);
+        slave_fd = -1;
+    }
+    if (master_fd >= 0) {
+        close(master_fd);
+        master_fd = -1;
+    }
+}
+
+sim_pty_stats_t sim_pty_stats() {
+    sim_pty_stats_t stats;
+    stats.rx_bytes = rx_byte_count;
+    stats.tx_bytes = tx_byte_count;
+    stats.tx_dropped_bytes = tx_dropped_count;
+    return stats;
+}
+
+
+//raw 8N1 at the device baud (a client that sets its own line settings still works)
+static bool set_raw_line(int fd) {
+    struct termios settings;
+    if (tcgetattr(fd, &settings) != 0) {return false;}
+
+    cfmakeraw(&settings);
+    settings.c_cflag &= ~(CSTOPB | PARENB | CSIZE);
+    settings.c_cflag |= (CS8 | CLOCAL | CREAD);
+    cfsetispeed(&settings, B921600);
+    cfsetospeed(&settings, B921600);
+    return (tcsetattr(fd, TCSANOW, &settings) == 0);
+}
+
+//the tx sink (called from the interrupt thread, as the bytes leave the fifo)
+static void write_to_pty(const uint16_t *bytes, size_t count) {
+    uint8_t buffer[64];
+    size_t sent = 0;
+
+    while (sent < count) {
+        size_t length = 0;
+        while ((length < sizeof(buffer)) && ((sent + length) < count)) {
+            buffer[length] = static_cast<uint8_t>(bytes[sent + length]);
+            length++;
+        }
+
+        const ssize_t written = write(master_fd, buffer, length);
+        if (written < 0) {
+            if (errno == EINTR) {continue;}
+
+            //the pty is full (nobody is reading), so the rest is lost
+            tx_dropped_count += (count - sent);
+            return;
+        }
+
+        tx_byte_count += static_cast<uint64_t>(written);
+        sent += static_cast<size_t>(written);
+    }
+}
+
+//everything the client writes is queued on the line, which the sim then moves at the baud rate
+static void read_from_pty() {
+    char buffer[256];
+
+    while (keep_reading) {
+        struct pollfd poll_settings;
+        poll_settings.fd = master_fd;
+        poll_settings.events = POLLIN;
+        poll_settings.revents = 0;
+
+        if (poll(&poll_settings, 1, 50) <= 0) {continue;}
+
+        const ssize_t length = read(master_fd, buffer, sizeof(buffer));
+        if (length > 0) {
+            rx_byte_count += static_cast<uint64_t>(length);
+            sim_serial_write(std::string(buffer, static_cast<size_t>(length)));
+        } else {
+            //no client (or it just closed)
+            usleep(10000);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * sim_registers.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// register instances, gpio ports, the free-running counter, and the ti rts/asm stand-ins
+
+#include "sim_internal.h"
+#include "stdlibf.h"
+#include "fpu_vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+//registers
+volatile struct PIE_VECT_TABLE PieVectTable;
+volatile struct PIE_CTRL_REGS PieCtrlRegs;
+volatile struct CPU_SYS_REGS CpuSysRegs;
+volatile struct CLK_CFG_REGS ClkCfgRegs;
+volatile struct EPWM_REGS EPwm1Regs;
+volatile struct EPWM_REGS EPwm2Regs;
+volatile struct EPWM_REGS EPwm3Regs;
+volatile struct EPWM_REGS EPwm4Regs;
+volatile struct EPWM_REGS EPwm5Regs;
+volatile struct EPWM_REGS EPwm6Regs;
+volatile struct EPWM_REGS EPwm7Regs;
+volatile struct XINT_REGS XintRegs;
+volatile struct INPUT_XBAR_REGS InputXbarRegs;
+volatile struct CPUTIMER_REGS CpuTimer0Regs;
+volatile struct CPUTIMER_REGS CpuTimer1Regs;
+volatile struct CPUTIMER_REGS CpuTimer2Regs;
+volatile struct SCI_REGS SciaRegs;
+volatile struct IPC_REGS_CPU1 IpcRegs;
+volatile struct GPIO_DATA_REGS GpioDataRegs;
+
+//the heap is not limited on the host, so the device heap size is always reported
+static const size_t device_heap_size = 0xFC00;
+
+//gpio
+static const uint16_t gpio_count = host_gpio_port_count * 32;
+static bool gpio_is_output[gpio_count];
+
+//daughterboard 3 on a 79D pulls both sense pins high
+static const uint16_t db3_sense_gpio[] = {32, 19};
+
+
+//time
+uint64_t sim_host_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(now.tv_nsec);
+}
+
+//200MHz, so 5ns per count (wraps like the lower 32bits of the real counter)
+uint32_t host_cpu_timestamp() {
+    return static_cast<uint32_t>(sim_host_ns() / 5);
+}
+
+void host_delay_us(float64 us) {
+    if (us <= 0.0) {return;}
+    const uint64_t end_ns = sim_host_ns() + static_cast<uint64_t>(us * 1000.0);
+    while (sim_host_ns() < end_ns) {
+    }
+}
+
+void host_estop0() {
+    fprintf(stderr, "ESTOP0: the firmware locked up the cpu\n");
+    abort();
+}
+
+size_t __TI_heap_total_available() {
+    return device_heap_size;
+}
+
+
+//gpio
+void sim_gpio_reset() {
+    memset(const_cast<GPIO_DATA_REGS *>(&GpioDataRegs), 0, sizeof(GpioDataRegs));
+    memset(gpio_is_output, 0, sizeof(gpio_is_output));
+
+    for (uint16_t i=0; i<(sizeof(db3_sense_gpio)/sizeof(db3_sense_gpio[0])); i++) {
+        sim_set_gpio(db3_sense_gpio[i], true);
+    }
+}
+
+void sim_set_gpio(uint16_t gpio_number, bool value) {
+    if (gpio_number >= gpio_count) {return;}
+
+    volatile uint32_t *const regs = GpioDataRegs.port[gpio_number / 32];
+    const uint32_t mask = (1UL << (gpio_number % 32));
+    if (value) {
+        regs[GPYDAT] |= mask;
+    } else {
+        regs[GPYDAT] &= ~mask;
+    }
+}
+
+bool sim_get_gpio(uint16_t gpio_number) {
+    if (gpio_number >= gpio_count) {return false;}
+
+    return ((GpioDataRegs.port[gpio_number / 32][GPYDAT] >> (gpio_number % 32)) & 0x1) != 0;
+}
+
+void GPIO_SetupPinMux(Uint16 gpioNumber, Uint16 cpu, Uint16 muxPosition) {
+    (void)gpioNumber;
+    (void)cpu;
+    (void)muxPosition;
+}
+
+void GPIO_SetupPinOptions(Uint16 gpioNumber, Uint16 output, Uint16 flags) {
+    (void)flags;
+    if (gpioNumber >= gpio_count) {return;}
+    gpio_is_output[gpioNumber] = (output == GPIO_OUTPUT);
+}
+
+Uint16 GPIO_ReadPin(Uint16 gpioNumber) {
+    return sim_get_gpio(gpioNumber) ? 1 : 0;
+}
+
+void GPIO_WritePin(Uint16 gpioNumber, Uint16 outVal) {
+    sim_set_gpio(gpioNumber, (outVal != 0));
+}
+
+
+//fpu library (N is always in 16-bit words)
+extern "C" void memcpy_fast(void *dst, const void *src, uint16_t N) {
+    memmove(dst, src, static_cast<size_t>(N) * sizeof(uint16_t));
+}
+
+extern "C" void memcpy_fast_far(volatile void *dst, volatile const void *src, uint16_t N) {
+    memmove(const_cast<void *>(dst), const_cast<const void *>(src), static_cast<size_t>(N) * sizeof(uint16_t));
+}
+
+extern "C" void memset_fast(volatile void *dst, int16_t value, uint16_t N) {
+    volatile uint16_t *const words = static_cast<volatile uint16_t *>(dst);
+    for (uint16_t i=0; i<N; i++) {
+        words[i] = static_cast<uint16_t>(value);
+    }
+}
@@ -0,0 +1,269 @@
+/*
+ * sim_sci.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// sci-a peripheral: the 16 byte rx/tx fifos, their interrupt flags, and the line on either side
+// bytes cross the line at the baud rate (8N1), using credits added by whoever owns time
+// scia.cpp runs unchanged on top of this, so its ring buffers and isrs are the real ones
+
+#include "sim_internal.h"
+#include <deque>
+#include <mutex>
+#include <string>
+
+
+//everything here is shared between the device, its isrs, and the host side of the line
+static std::mutex sci_lock;
+
+//fifos
+static const uint16_t fifo_length = 16;
+static std::deque<uint16_t> rx_fifo;
+static std::deque<uint16_t> tx_fifo;
+static bool rx_fifo_overflow = false;
+static bool rx_fifo_in_reset = true;
+static bool tx_fifo_in_reset = true;
+static bool rx_int_flag = false;
+static bool tx_int_flag = false;
+
+//line
+static std::deque<uint16_t> rx_line;
+static std::string tx_output;
+static void (*tx_sink)(const uint16_t *bytes, size_t count) = NULL;
+
+//credits, in bytes
+static float64 rx_credit = 0.0;
+static float64 tx_credit = 0.0;
+static bool unthrottled_tx = true;
+
+
+void sim_sci_reset() {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    rx_fifo.clear();
+    tx_fifo.clear();
+    rx_fifo_overflow = false;
+    rx_fifo_in_reset = true;
+    tx_fifo_in_reset = true;
+    rx_int_flag = false;
+    tx_int_flag = false;
+    rx_credit = 0.0;
+    tx_credit = 0.0;
+    rx_line.clear();
+    tx_output.clear();
+}
+
+
+//internal functions
+static void write_locked(host_sci_field_t field, uint16_t value);
+
+
+//registers
+uint16_t host_sci_read(host_sci_field_t field) {
+    //polled by the main loop while waiting for the line
+    if (field == host_sci_txffst) {
+        sim_service_interrupts();
+    }
+
+    std::lock_guard<std::mutex> guard(sci_lock);
+    switch (field) {
+        case host_sci_txffst:
+            return static_cast<uint16_t>(tx_fifo.size());
+
+        case host_sci_rxffst:
+            return static_cast<uint16_t>(rx_fifo.size());
+
+        case host_sci_rxffovf:
+            return rx_fifo_overflow ? 1 : 0;
+
+        case host_sci_sar: {
+            if (rx_fifo.empty()) {return 0;}
+            const uint16_t byte = rx_fifo.front();
+            rx_fifo.pop_front();
+            return byte;
+        }
+
+        case host_sci_txfiforeset:
+            return tx_fifo_in_reset ? 0 : 1;
+
+        case host_sci_rxfiforeset:
+            return rx_fifo_in_reset ? 0 : 1;
+
+        default:
+            return 0;
+    }
+}
+
+void host_sci_write(host_sci_field_t field, uint16_t value) {
+    {
+        std::lock_guard<std::mutex> guard(sci_lock);
+        write_locked(field, value);
+    }
+
+    //clearing a flag lets a pending interrupt in right away
+    if (((field == host_sci_txffintclr) || (field == host_sci_rxffintclr)) && (value != 0)) {
+        sim_service_interrupts();
+    }
+}
+
+static void write_locked(host_sci_field_t field, uint16_t value) {
+    switch (field) {
+        case host_sci_txffintclr:
+            if (value != 0) {
+                tx_int_flag = false;
+            }
+            break;
+
+        case host_sci_rxffintclr:
+            if (value != 0) {
+                rx_int_flag = false;
+            }
+            break;
+
+        case host_sci_rxffovrclr:
+            if (value != 0) {
+                rx_fifo_overflow = false;
+            }
+            break;
+
+        case host_sci_txfiforeset:
+            //0 holds the fifo in reset (and empties it)
+            tx_fifo_in_reset = (value == 0);
+            if (tx_fifo_in_reset) {
+                tx_fifo.clear();
+            }
+            break;
+
+        case host_sci_rxfiforeset:
+            rx_fifo_in_reset = (value == 0);
+            if (rx_fifo_in_reset) {
+                rx_fifo.clear();
+            }
+            break;
+
+        case host_sci_txdt:
+            //a write to a full fifo is lost
+            if ((!tx_fifo_in_reset) && (tx_fifo.size() < fifo_length)) {
+                tx_fifo.push_back(value & 0xFF);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+//interrupts (a flag is raised once, then must be cleared before it can be raised again)
+PINT sim_sci_pending_isr() {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    const bool rx_enabled = (SciaRegs.SCIFFRX.bit.RXFFIENA != 0) && (PieCtrlRegs.PIEIER9.bit.INTx1 != 0) && (PieVectTable.SCIA_RX_INT != NULL);
+    const bool tx_enabled = (SciaRegs.SCIFFTX.bit.TXFFIENA != 0) && (PieCtrlRegs.PIEIER9.bit.INTx2 != 0) && (PieVectTable.SCIA_TX_INT != NULL);
+
+    if (rx_enabled && (!rx_int_flag) && (!rx_fifo_in_reset) && (rx_fifo.size() >= SciaRegs.SCIFFRX.bit.RXFFIL)) {
+        rx_int_flag = true;
+        return PieVectTable.SCIA_RX_INT;
+    }
+
+    if (tx_enabled && (!tx_int_flag) && (!tx_fifo_in_reset) && (tx_fifo.size() <= SciaRegs.SCIFFTX.bit.TXFFIL)) {
+        tx_int_flag = true;
+        return PieVectTable.SCIA_TX_INT;
+    }
+
+    return NULL;
+}
+
+
+//line
+void sim_sci_add_rx_credit(float64 bytes) {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    rx_credit += bytes;
+}
+
+void sim_sci_add_tx_credit(float64 bytes) {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    tx_credit += bytes;
+}
+
+void sim_sci_set_unthrottled_tx(bool unthrottled) {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    unthrottled_tx = unthrottled;
+}
+
+void sim_sci_transfer() {
+    uint16_t sent[fifo_length];
+    size_t sent_count = 0;
+    void (*sink)(const uint16_t *bytes, size_t count) = NULL;
+
+    std::unique_lock<std::mutex> guard(sci_lock);
+
+    //rx: a byte that arrives with the fifo full is lost, and flags the overflow
+    while ((!rx_line.empty()) && (rx_credit >= 1.0)) {
+        if (!rx_fifo_in_reset) {
+            if (rx_fifo.size() < fifo_length) {
+                rx_fifo.push_back(rx_line.front());
+            } else {
+                rx_fifo_overflow = true;
+            }
+        }
+        rx_line.pop_front();
+        rx_credit -= 1.0;
+    }
+
+    //tx
+    while ((!tx_fifo.empty()) && (unthrottled_tx || (tx_credit >= 1.0))) {
+        sent[sent_count] = tx_fifo.front();
+        sent_count++;
+        tx_fifo.pop_front();
+        if (!unthrottled_tx) {
+            tx_credit -= 1.0;
+        }
+    }
+
+    //an idle line does not save up time
+    if (rx_line.empty() && (rx_credit > 1.0)) {
+        rx_credit = 1.0;
+    }
+    if (tx_fifo.empty() && (tx_credit > 1.0)) {
+        tx_credit = 1.0;
+    }
+
+    if (sent_count == 0) {return;}
+
+    if (tx_sink == NULL) {
+        for (size_t i=0; i<sent_count; i++) {
+            tx_output.push_back(static_cast<char>(sent[i]));
+        }
+        return;
+    }
+
+    //the sink writes to the pty, so the host side of the line is not held up by it
+    sink = tx_sink;
+    guard.unlock();
+    sink(sent, sent_count);
+}
+
+
+//host side
+void sim_serial_write(const std::string &bytes) {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    for (size_t i=0; i<bytes.size(); i++) {
+        rx_line.push_back(static_cast<uint8_t>(bytes[i]));
+    }
+}
+
+std::string sim_serial_read() {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    std::string output;
+    output.swap(tx_output);
+    return output;
+}
+
+size_t sim_serial_rx_pending() {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    return rx_line.size();
+}
+
+void sim_serial_set_tx_sink(void (*sink)(const uint16_t *bytes, size_t count)) {
+    std::lock_guard<std::mutex> guard(sci_lock);
+    tx_sink = sink;
+}
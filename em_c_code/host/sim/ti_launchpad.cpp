@@ -0,0 +1,184 @@
+/*
+ * ti_launchpad.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// host stand-in for common/ti_launchpad.cpp (a calibrated 79D, with nothing to copy or configure)
+// the startup order, prints, and commands match the device, except for the FTDI wait and the watchdog
+
+#include "ti_launchpad.h"
+#include "cla.h"
+#include "misc.h"
+#include "tic_toc.h"
+#include "version.h"
+#include "printf_json_delayed.h"
+#include "printf_json.h"
+#include "scia.h"
+#include "serial_link.h"
+#include "sim_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//singleton
+ti_launchpad ti_board;
+
+serial_command_t command_ti_config = {"get_ti_configuration", true, 0, NULL, print_ti_configuration, NULL};
+serial_command_t command_clock_scale = {"get_clock_scale", true, 0, NULL, print_clock_scale, NULL};
+
+//the simulated board is always a known, perfect, 79D
+static const uint32_t sim_ti_uid = 0x53494D00;  //"SIM"
+static struct sci_gpio_t sim_sci_settings = {42, 15, 43, 15};
+static const char *code_location = "HOST";
+
+
+ti_launchpad::ti_launchpad() {
+    version_str_ = "F28379D";
+    scia_gpio_ = sim_sci_settings;
+    chip_part_number_ = 0xF9;
+    chip_family_ = 3;
+    board_type_ = 79;
+    red_led_gpio = 34;
+    blue_led_gpio = 31;
+
+    clock_freq_ = 200000000;
+    clock_ppb_deviation_ = 0;
+    clock_scale_ = 1.0L;
+    xtal_osc_freq_ = 10000000;
+
+    peripheral_clock_divider_ = 1;
+    launchpad_label_ = "SIM";
+    launchpad_rev_ = "HOST";
+    board_id_ = 0;
+    initialized_ = false;
+}
+
+bool ti_launchpad::startup() {
+    red_led = ti_led(red_led_gpio);
+    blue_led = ti_led(blue_led_gpio);
+    red_led.on();
+
+    this->update_specific_board_settings();
+    this->enable_global_interrupts();
+
+    //the pty does not need the FTDI wait
+    const bool scia_success = init_scia(sim_baud_rate, this->get_scia_gpio());
+    if (!scia_success) {
+        return false;
+    }
+
+    printf_json_objects(2, json_string("status","booting from HOST"), json_string("software_version", experimental_monitor_version_str));
+
+    init_cla();
+    init_tic_toc();
+    performance_test();
+
+    add_serial_command(&command_ti_config);
+    add_serial_command(&command_clock_scale);
+
+    red_led.off();
+    initialized_ = true;
+    return true;
+}
+
+uint16_t ti_launchpad::get_board_type() const {
+    if (board_id_ > 0) {
+        return board_type_;
+    } else {
+        return 0;
+    }
+}
+
+void ti_launchpad::update_specific_board_settings() {
+    board_id_ = sim_ti_uid;
+}
+
+void ti_launchpad::enable_pullups(uint16_t pullup_count, const uint16_t *const gpio_array) {
+    for (uint16_t i=0; i<pullup_count; i++) {
+        GPIO_SetupPinOptions(gpio_array[i], GPIO_INPUT, GPIO_PULLUP);
+    }
+}
+
+void ti_launchpad::set_clock_deviation(int32_t ppb_deviation, bool print_message) {
+    const float64 setting_clock_scale = 1.0L + (static_cast<float64>(ppb_deviation)/1e9L);
+
+    if (setting_clock_scale > 1.01) {
+        delay_printf_json_error("clock scale cannot be more than 1.01");
+    } else if (setting_clock_scale < 0.99) {
+        delay_printf_json_error("clock scale cannot be less than 0.99");
+    } else {
+        clock_ppb_deviation_ = ppb_deviation;
+        clock_scale_ = setting_clock_scale;
+        if (print_message) {
+            delay_printf_json_objects(2, json_int32("deviation",clock_ppb_deviation_), json_float64("scale",clock_scale_));
+        }
+    }
+}
+
+void print_clock_scale() {
+    const float64 temp_value = ti_board.get_clock_scale();
+    delay_printf_json_objects(1, json_float64("clock_scale", temp_value));
+}
+
+//the uid is the board id (there is no otp to read)
+void ti_launchpad::print_configuration() const {
+    delay_printf_json_objects(12, json_parent("ti_configuration", 11),
+                        json_string("code_location", code_location),
+                        json_string("ti_launchpad", version_str_),
+                        json_string("launchpad_label", launchpad_label_),
+                        json_string("launchpad_rev", launchpad_rev_),
+                        json_uint32("hardware_id", board_id_),
+                        json_uint32("clock_freq", clock_freq_),
+                        json_int32("clock_ppb_deviation", clock_ppb_deviation_),
+                        json_uint32("main_freq", main_frequency),
+                        json_string("software_version", experimental_monitor_version_str),
+                        json_string("compiled_date", compile_date_str),
+                        json_string("compiled_time", compile_time_str));
+}
+
+//there is no watchdog
+void ti_launchpad::disable_watchdog() {
+}
+
+void ti_launchpad::enable_watchdog() {
+}
+
+uint16_t ti_launchpad::kick_watchdog() {
+    return 0;
+}
+
+//the device waits for the watchdog, the host just exits
+void ti_launchpad::reboot() {
+    printf_json_status("rebooting");
+    wait_until_scia_tx_buffer_is_empty();
+    fprintf(stderr, "the firmware rebooted the device\n");
+    exit(0);
+}
+
+void print_ti_configuration() {
+    ti_board.print_configuration();
+}
+
+void ti_reboot() {
+    printf_delayed_json_objects(true);
+    ti_board.reboot();
+}
+
+void ti_launchpad::verify_expected_chip() const {
+}
+
+void ti_launchpad::enable_global_interrupts() const {
+    EINT;
+}
+
+void ti_launchpad::set_peripheral_clock_divider() const {
+}
+
+sci_gpio_t ti_launchpad::get_scia_gpio() const {
+    return scia_gpio_;
+}
+
+void ti_launchpad::init_sys_control() const {
+}
+
+void ti_launchpad::disable_all_peripheral_clocks() const {
+}
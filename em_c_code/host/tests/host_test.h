@@ -0,0 +1,57 @@
+/*
+ * host_test.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// shared by the host tests: checks, and sending a command through the simulated line
+
+#ifndef host_test_defined
+#define host_test_defined
+
+#include "host_sim.h"
+#include <stdio.h>
+#include <string>
+
+
+static int host_test_failures = 0;
+
+static void check(bool condition, const char *const message) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s\n", message);
+        host_test_failures++;
+    }
+}
+
+static bool contains(const std::string &haystack, const char *const needle) {
+    return haystack.find(needle) != std::string::npos;
+}
+
+//sends the command, then runs until the line has been idle for a while (every reply is printed by then)
+static std::string run_command(const std::string &json_line) {
+    sim_send_command(json_line);
+
+    std::string output;
+    uint16_t idle_ticks = 0;
+    while (idle_ticks < 100) {
+        sim_run(1, 2);
+        const std::string new_output = sim_serial_read();
+        if (new_output.empty() && (sim_serial_rx_pending() == 0)) {
+            idle_ticks++;
+        } else {
+            idle_ticks = 0;
+            output += new_output;
+        }
+    }
+    return output;
+}
+
+static int host_test_result(const char *const name) {
+    if (host_test_failures > 0) {
+        fprintf(stderr, "%s: %d failed\n", name, host_test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#endif
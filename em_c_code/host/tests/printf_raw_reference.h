@@ -0,0 +1,292 @@
+/*
+ * printf_raw_reference.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the number formatters from printf_raw.cpp as they were before the buffered integer-only rewrite (46824d3), unchanged
+// only included by printf_raw_versions.h, inside a namespace, so the tests and benchmarks can compare the two
+
+
+__attribute__((ramfunc))
+void print_all_int_except_uint64_value(int64_t value) {
+    //simple case is 0
+    if (value == 0) {
+        printf_char('0');
+        return;
+    }
+
+    //print and remove the negative sign
+    bool is_LLONG_MIN = false;
+    if (value < 0) {
+        printf_char('-');
+
+        if (value != LLONG_MIN) {
+            value = -value;
+        } else {
+            is_LLONG_MIN = true;
+            value = LLONG_MAX;
+        }
+    }
+
+    //get the characters
+    char buffer[19];
+    uint16_t index = 0;
+    while (value > 0) {
+        buffer[index] = '0' + static_cast<char>(value % 10);
+        value /= 10;
+        index++;
+    }
+
+    if (is_LLONG_MIN) {
+        buffer[0] = '8';
+    }
+
+    //reverse print
+    while ((index--) > 0) {
+        printf_char(static_cast<uint16_t>(buffer[index]));
+    }
+}
+
+__attribute__((ramfunc))
+void print_uint64_value(uint64_t value) {
+    //simple case is 0
+    if (value == 0) {
+        printf_char('0');
+        return;
+    }
+
+    char buffer[20];
+    uint16_t index = 0;
+    while (value > 0) {
+        buffer[index] = '0' + static_cast<char>(value % 10);
+        value /= 10;
+        index++;
+    }
+
+    //reverse print
+    while ((index--) > 0) {
+        printf_char(static_cast<uint16_t>(buffer[index]));
+    }
+}
+
+__attribute__((ramfunc))
+void print_uint64_timestamp(uint64_t timestamp, uint64_t ts_multiplier, uint16_t ts_shift) {
+
+    //simple case is 0 (just print 0.xxxx)
+    if (timestamp == 0) {
+        printf_char('0');
+        printf_char('.');
+        for (uint16_t i=0; i<ts_shift; i++) {
+            printf_char('0');
+        }
+        return;
+    }
+
+    //first step, multiply
+    timestamp *= ts_multiplier;
+
+    char buffer[20];
+    uint16_t index = 0;
+    while (timestamp > 0) {
+        buffer[index] = '0' + static_cast<char>(timestamp % 10);
+        timestamp /= 10;
+        index++;
+    }
+
+    //if smaller than 0, print out the beginning
+    uint16_t print_before_period = 0;
+    if (index <= ts_shift) {
+        printf_char('0');
+        printf_char('.');
+        for (uint16_t i=index; i<ts_shift; i++) {
+            printf_char('0');
+        }
+    } else {
+        print_before_period = index - ts_shift;
+    }
+
+    uint16_t places_count = 0;
+    //reverse print
+    while (index > 0) {
+        index--;
+        printf_char(static_cast<uint16_t>(buffer[index]));
+
+        places_count++;
+        if (places_count == print_before_period) {
+            printf_char('.');
+        }
+    }
+}
+
+
+__attribute__((ramfunc))
+void print_float32_value(float32 value, uint16_t precision) {
+    //simple case is 0
+    if (value == 0.0) {
+        printf_string("0");
+        printf_char('.');
+        for (uint16_t i=0; i<precision; i++) {
+            printf_char('0');
+        }
+        return;
+    }
+
+    if (isinf(value)) {
+        if (value < 0) {
+            printf_char('-');
+        }
+        printf_string("inf");
+        return;
+    }
+    if (isnan(value)) {
+        printf_string("nan");
+        return;
+    }
+
+    //print and remove the negative sign
+    if (value < 0.0) {
+        printf_char('-');
+        value = -value;
+    }
+
+    //not really infinite, but too large to work with
+    if (value > static_cast<float32>(ULLONG_MAX)) {
+        printf_string("inf");
+        return;
+    }
+
+    //get the integer characters
+    uint64_t i_part = static_cast<uint64_t>(floor(value));
+    uint16_t max_sig_figs = 7;
+
+    if (i_part == 0) {
+        printf_char('0');
+    } else {
+        char buffer[20];
+        uint16_t index = 0;
+
+        while (i_part > 0) {
+            buffer[index] = '0' + static_cast<char>(i_part % 10);
+            i_part /= 10;
+            index++;
+        }
+
+        if (index < max_sig_figs) {
+            max_sig_figs -= index;
+        } else {
+            max_sig_figs = 0;
+        }
+
+        //reverse print
+        while ((index--) > 0) {
+            printf_char(static_cast<uint16_t>(buffer[index]));
+        }
+    }
+
+    if (max_sig_figs > precision) {
+        max_sig_figs = precision;
+    }
+
+    if (max_sig_figs <= 0) {
+        return;
+    }
+
+    //print the fractional part
+    printf_char('.');
+
+    //remove the integer part
+    value -= static_cast<float32>(i_part);
+
+    for (uint16_t i=0; i<max_sig_figs; i++) {
+        value *= 10.0;
+        i_part = static_cast<uint64_t>(value);
+        i_part = i_part % 10;
+        printf_char(static_cast<uint16_t>('0') + static_cast<uint16_t>(i_part));
+    }
+}
+
+__attribute__((ramfunc))
+void print_float64_value(float64 value, uint16_t precision) {
+    //simple case is 0
+    if (value == 0.0) {
+        printf_string("0");
+        printf_char('.');
+        for (uint16_t i=0; i<precision; i++) {
+            printf_char('0');
+        }
+        return;
+    }
+
+    if (isinf(value)) {
+        if (value < 0) {
+            printf_char('-');
+        }
+        printf_string("inf");
+        return;
+    }
+    if (isnan(value)) {
+        printf_string("nan");
+        return;
+    }
+
+    //print and remove the negative sign
+    if (value < 0.0L) {
+        printf_char('-');
+        value = -value;
+    }
+
+    //not really infinite, but too large to work with
+    if (value > static_cast<float64>(ULLONG_MAX)) {
+        printf_string("inf");
+        return;
+    }
+
+    //get the integer characters
+    uint64_t i_part = static_cast<uint64_t>(floorl(value));
+    uint16_t max_sig_figs = 15;
+
+    if (i_part == 0) {
+        printf_char('0');
+    } else {
+        char buffer[20];
+        uint16_t index = 0;
+
+        while (i_part > 0) {
+            buffer[index] = '0' + static_cast<char>(i_part % 10);
+            i_part /= 10;
+            index++;
+        }
+
+        if (index < max_sig_figs) {
+            max_sig_figs -= index;
+        } else {
+            max_sig_figs = 0;
+        }
+
+        //reverse print
+        while ((index--) > 0) {
+            printf_char(static_cast<uint16_t>(buffer[index]));
+        }
+    }
+
+    if (max_sig_figs > precision) {
+        max_sig_figs = precision;
+    }
+
+    if (max_sig_figs <= 0) {
+        return;
+    }
+
+    //print the fractional part
+    printf_char('.');
+
+    //remove the integer part
+    value -= static_cast<float64>(i_part);
+
+    for (uint16_t i=0; i<max_sig_figs; i++) {
+        value *= 10.0L;
+        i_part = static_cast<uint64_t>(value);
+        i_part = i_part % 10;
+        printf_char(static_cast<uint16_t>('0') + static_cast<uint16_t>(i_part));
+    }
+}
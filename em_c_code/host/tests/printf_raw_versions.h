@@ -0,0 +1,69 @@
+/*
+ * printf_raw_versions.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the current printf_raw.cpp and the formatters it replaced, side by side, printing into a capture buffer instead of tx
+//  current::    printf_raw.cpp, compiled again from the firmware source
+//  reference::  the formatters before the rewrite (printf_raw_reference.h)
+// printf_char and printf_string are looked up in the namespace first, so both versions print through the capture
+
+#ifndef printf_raw_versions_defined
+#define printf_raw_versions_defined
+
+//everything printf_raw.cpp includes, so its includes do nothing inside the namespace
+#include "printf_raw.h"
+#include "limits.h"
+#include "scia.h"
+#include "math.h"
+#include <printf_json.h>
+#include <printf_json_delayed.h>
+#include <string>
+
+
+//what was printed (cleared by the caller), and how many print calls it took
+static char captured_text[4096];
+static size_t captured_length = 0;
+static uint32_t captured_calls = 0;
+
+static void capture_clear() {
+    captured_length = 0;
+    captured_calls = 0;
+}
+
+static std::string capture_text() {
+    return std::string(captured_text, captured_length);
+}
+
+static void capture_char(uint16_t c) {
+    captured_calls++;
+    if (captured_length < sizeof(captured_text)) {
+        captured_text[captured_length] = static_cast<char>(c);
+        captured_length++;
+    }
+}
+
+static void capture_string(const char *const string) {
+    captured_calls++;
+    for (const char *c = string; (*c != '\0') && (captured_length < sizeof(captured_text)); c++) {
+        captured_text[captured_length] = *c;
+        captured_length++;
+    }
+}
+
+
+namespace current {
+static void printf_char(uint16_t c) {capture_char(c);}
+static void printf_string(const char *const string) {capture_string(string);}
+
+#include "printf_raw.cpp"
+}
+
+namespace reference {
+static void printf_char(uint16_t c) {capture_char(c);}
+static void printf_string(const char *const string) {capture_string(string);}
+
+#include "printf_raw_reference.h"
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * test_analog_region.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the integer circular and elliptical tests (analog_region.h) against a long double reference, along each boundary
+// long double can't tell points within its rounding of the edge, so those are decided exactly in 128-bit integers (up to 3 terms)
+
+#include "host_test.h"
+#include "analog_region.h"
+#include <math.h>
+
+
+static const long double reference_margin = 1e-15L;
+
+//a few pairs of distances, small to the largest (and the pair that used to accept a point just outside)
+static const uint16_t distance_pairs[][2] = {
+    {1, 1}, {3, 7}, {100, 100}, {1000, 250}, {32767, 32768}, {40000, 65535}, {45690, 58021}, {65535, 65535}, {65535, 2}
+};
+static const uint16_t distance_pair_count = sizeof(distance_pairs) / sizeof(distance_pairs[0]);
+
+static uint32_t checked_count = 0;
+
+
+//exact: sum(offset^2 / distance^2) <= 1, cross multiplied
+static bool exact_ellipse_is_inside(const uint16_t *const offsets, const uint16_t *const distances, uint16_t count) {
+    unsigned __int128 product = 1;
+    for (uint16_t i=0; i<count; i++) {
+        product *= static_cast<uint64_t>(distances[i]) * distances[i];
+    }
+
+    unsigned __int128 sum = 0;
+    for (uint16_t i=0; i<count; i++) {
+        const uint64_t distance_squared = static_cast<uint64_t>(distances[i]) * distances[i];
+        sum += (product / distance_squared) * (static_cast<uint64_t>(offsets[i]) * offsets[i]);
+    }
+    return (sum <= product);
+}
+
+static bool reference_ellipse_is_inside(const uint16_t *const offsets, const uint16_t *const distances, uint16_t count) {
+    long double sum = 0.0L;
+    for (uint16_t i=0; i<count; i++) {
+        const long double ratio = static_cast<long double>(offsets[i]) / static_cast<long double>(distances[i]);
+        sum += ratio * ratio;
+    }
+
+    if (fabsl(sum - 1.0L) > reference_margin) {
+        return (sum <= 1.0L);
+    }
+    return exact_ellipse_is_inside(offsets, distances, count);
+}
+
+static bool ellipse_is_inside(const uint16_t *const offsets, const uint16_t *const distances, uint16_t count) {
+    region_ellipse_sum_t sum;
+    region_ellipse_sum_clear(sum);
+
+    for (uint16_t i=0; i<count; i++) {
+        const uint32_t distance_squared = region_distance_squared(distances[i]);
+        if (!region_add_elliptical_term(sum, region_offset_squared(offsets[i], 0), distance_squared, region_ellipse_coefficient(distance_squared))) {
+            return false;
+        }
+    }
+    return region_ellipse_sum_is_inside(sum);
+}
+
+//circular uses one distance for every term (the parent's)
+static bool circle_is_inside(const uint16_t *const offsets, uint16_t distance, uint16_t count) {
+    uint64_t sum = 0;
+    for (uint16_t i=0; i<count; i++) {
+        if (!region_add_circular_term(sum, region_offset_squared(0, offsets[i]), region_distance_squared(distance))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool reference_circle_is_inside(const uint16_t *const offsets, uint16_t distance, uint16_t count) {
+    //every square is below 2^32, so the long double sum is exact
+    long double sum = 0.0L;
+    for (uint16_t i=0; i<count; i++) {
+        sum += static_cast<long double>(offsets[i]) * static_cast<long double>(offsets[i]);
+    }
+    return (sum <= (static_cast<long double>(distance) * static_cast<long double>(distance)));
+}
+
+static void check_point(const uint16_t *const offsets, const uint16_t *const distances, uint16_t count) {
+    checked_count++;
+
+    const bool is_inside = ellipse_is_inside(offsets, distances, count);
+    if (is_inside != reference_ellipse_is_inside(offsets, distances, count)) {
+        fprintf(stderr, "ellipse:");
+        for (uint16_t i=0; i<count; i++) {
+            fprintf(stderr, " %u/%u", offsets[i], distances[i]);
+        }
+        fprintf(stderr, " is %s\n", is_inside ? "inside" : "outside");
+        check(false, "elliptical matches the reference");
+    }
+
+    if (circle_is_inside(offsets, distances[0], count) != reference_circle_is_inside(offsets, distances[0], count)) {
+        fprintf(stderr, "circle: %u %u (distance %u)\n", offsets[0], (count > 1) ? offsets[1] : 0, distances[0]);
+        check(false, "circular matches the reference");
+    }
+}
+
+//the offsets on either side of the edge, for each first offset (and a second term of 0 at the ends)
+static void sweep_boundary(uint16_t distance_0, uint16_t distance_1) {
+    const uint16_t distances[2] = {distance_0, distance_1};
+    const uint32_t step = (distance_0 > 2000) ? (distance_0 / 1000) : 1;
+
+    for (uint32_t offset_0=0; offset_0<=distance_0; offset_0+=step) {
+        const long double ratio = static_cast<long double>(offset_0) / distance_0;
+        const long double edge = distance_1 * sqrtl(1.0L - (ratio * ratio));
+        const int64_t edge_offset = static_cast<int64_t>(floorl(edge));
+
+        for (int64_t offset_1=(edge_offset - 2); offset_1<=(edge_offset + 2); offset_1++) {
+            if ((offset_1 < 0) || (offset_1 > 65535)) {continue;}
+            const uint16_t offsets[2] = {static_cast<uint16_t>(offset_0), static_cast<uint16_t>(offset_1)};
+            check_point(offsets, distances, 2);
+        }
+    }
+
+    //and the far end exactly
+    const uint16_t end_offsets[2] = {distance_0, 0};
+    check_point(end_offsets, distances, 2);
+    const uint16_t past_offsets[2] = {distance_0, 1};
+    check_point(past_offsets, distances, 2);
+}
+
+
+int main() {
+    //the point that was accepted: 1 + 1/58021^2 is just over 1
+    const uint16_t reported_offsets[2] = {45690, 1};
+    const uint16_t reported_distances[2] = {45690, 58021};
+    check(!ellipse_is_inside(reported_offsets, reported_distances, 2), "45690/58021 with offsets 45690, 1 is outside");
+    check_point(reported_offsets, reported_distances, 2);
+
+    for (uint16_t pair_i=0; pair_i<distance_pair_count; pair_i++) {
+        sweep_boundary(distance_pairs[pair_i][0], distance_pairs[pair_i][1]);
+        sweep_boundary(distance_pairs[pair_i][1], distance_pairs[pair_i][0]);
+    }
+
+    //three terms, near the edge of the largest ellipse (long double can't tell these apart)
+    const uint16_t large_distances[3] = {65535, 65534, 65533};
+    for (uint32_t offset_0=0; offset_0<=65535; offset_0+=4369) {
+        for (uint32_t offset_1=0; offset_1<=65534; offset_1+=4369) {
+            const long double left = 1.0L - powl(static_cast<long double>(offset_0) / 65535.0L, 2) - powl(static_cast<long double>(offset_1) / 65534.0L, 2);
+            if (left < 0.0L) {continue;}
+            const int64_t edge_offset = static_cast<int64_t>(floorl(65533.0L * sqrtl(left)));
+
+            for (int64_t offset_2=(edge_offset - 1); offset_2<=(edge_offset + 1); offset_2++) {
+                if ((offset_2 < 0) || (offset_2 > 65535)) {continue;}
+                const uint16_t offsets[3] = {static_cast<uint16_t>(offset_0), static_cast<uint16_t>(offset_1), static_cast<uint16_t>(offset_2)};
+                check_point(offsets, large_distances, 3);
+            }
+        }
+    }
+
+    //no distance is never inside
+    const uint16_t zero_offsets[2] = {0, 0};
+    const uint16_t zero_distances[2] = {0, 10};
+    check(!ellipse_is_inside(zero_offsets, zero_distances, 2), "no distance is outside (elliptical)");
+    check(!circle_is_inside(zero_offsets, 0, 2), "no distance is outside (circular)");
+
+    printf("points checked: %u\n", static_cast<unsigned int>(checked_count));
+    return host_test_result("analog region");
+}
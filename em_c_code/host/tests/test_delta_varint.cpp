@@ -0,0 +1,205 @@
+/*
+ * test_delta_varint.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// print_delta_varint_array read back with the rules of decode_delta_varint.m: every array decodes to the values that were printed,
+// across the 1 to 2 and 2 to 3 byte varint lengths, and analog histories are only sent this way when get_input_history asks for it
+
+#include "host_test.h"
+#include "printf_raw_versions.h"
+#include <string.h>
+#include <vector>
+
+
+//the largest array whose every delta takes 3 bytes still fits in the capture buffer
+static const uint16_t max_array_count = 1000;
+
+
+static bool base64_decode(const std::string &text, std::vector<uint8_t> &bytes) {
+    static const char *const alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    bytes.clear();
+    if ((text.size() % 4) != 0) {return false;}
+
+    uint32_t buffer = 0;
+    uint16_t buffer_length = 0;
+    for (size_t i=0; i<text.size(); i++) {
+        if (text[i] == '=') {
+            //only padding after the first
+            return (text.find_first_not_of('=', i) == std::string::npos) && ((text.size() - i) <= 2);
+        }
+        const char *const found = strchr(alphabet, text[i]);
+        if ((found == NULL) || (*found == '\0')) {return false;}
+
+        buffer = (buffer << 6) | static_cast<uint32_t>(found - alphabet);
+        buffer_length += 6;
+        if (buffer_length >= 8) {
+            buffer_length -= 8;
+            bytes.push_back(static_cast<uint8_t>(buffer >> buffer_length));
+        }
+    }
+    return true;
+}
+
+//the same steps as decode_delta_varint.m (the format byte, the count, the first value, then zig-zag varints of each delta)
+//and every byte must be used
+static bool decode_delta_varint(const std::string &text, std::vector<uint16_t> &values) {
+    values.clear();
+    std::vector<uint8_t> bytes;
+    if (!base64_decode(text, bytes) || (bytes.size() < 5) || (bytes[0] != 0)) {return false;}
+
+    const uint16_t count = static_cast<uint16_t>((bytes[1] << 8) | bytes[2]);
+    int64_t value = (bytes[3] << 8) | bytes[4];
+    values.push_back(static_cast<uint16_t>(value));
+    size_t byte_i = 5;
+
+    for (uint16_t i=1; i<count; i++) {
+        uint64_t zigzag = 0;
+        uint64_t shift = 1;
+        while (true) {
+            if (byte_i >= bytes.size()) {return false;}
+            const uint8_t byte = bytes[byte_i];
+            byte_i++;
+            zigzag += (byte & 0x7F) * shift;
+            shift *= 128;
+            if (byte < 128) {break;}
+        }
+
+        const int64_t delta = ((zigzag % 2) == 0) ? static_cast<int64_t>(zigzag / 2) : -static_cast<int64_t>((zigzag + 1) / 2);
+        value += delta;
+        if ((value < 0) || (value > 65535)) {return false;}
+        values.push_back(static_cast<uint16_t>(value));
+    }
+    return (byte_i == bytes.size());
+}
+
+//16bit base64 (the history without delta_varint): the precision, the count, then each value
+static bool decode_base64_16(const std::string &text, std::vector<uint16_t> &values) {
+    values.clear();
+    std::vector<uint8_t> bytes;
+    if (!base64_decode(text, bytes) || (bytes.size() < 3) || (bytes[0] != 16)) {return false;}
+
+    const uint16_t count = static_cast<uint16_t>((bytes[1] << 8) | bytes[2]);
+    if (bytes.size() != (3 + (2 * static_cast<size_t>(count)))) {return false;}
+    for (uint16_t i=0; i<count; i++) {
+        values.push_back(static_cast<uint16_t>((bytes[3 + (2 * i)] << 8) | bytes[4 + (2 * i)]));
+    }
+    return true;
+}
+
+
+//prints the array, checks that it decodes to the same values, and returns the printed length
+static size_t check_round_trip(const std::vector<uint16_t> &values, const char *const name) {
+    capture_clear();
+    current::print_delta_varint_array(&values[0], static_cast<uint16_t>(values.size()));
+    const std::string text = capture_text();
+
+    std::vector<uint16_t> decoded;
+    const bool is_decoded = decode_delta_varint(text, decoded);
+    if (!is_decoded || (decoded != values)) {
+        fprintf(stderr, "%s (%u values): %s\n  %s\n", name, static_cast<unsigned int>(values.size()),
+                is_decoded ? "decoded to other values" : "didn't decode", text.c_str());
+    }
+    check(is_decoded, "the array decodes");
+    check(decoded == values, "the array decodes to the values that were printed");
+    return text.size();
+}
+
+//the base64 characters for the header, the first value, and one byte per later value
+static size_t one_byte_length(size_t count) {
+    return 4 * (((5 + (count - 1)) + 2) / 3);
+}
+
+//the quoted history string from a reply (empty if there isn't one)
+static std::string history_text(const std::string &output) {
+    const size_t start = output.find("\"history\":\"");
+    if (start == std::string::npos) {return "";}
+    const size_t text_start = start + strlen("\"history\":\"");
+    const size_t end = output.find('\"', text_start);
+    return (end == std::string::npos) ? "" : output.substr(text_start, end - text_start);
+}
+
+
+int main() {
+    //one value, at either end
+    check_round_trip(std::vector<uint16_t>(1, 0), "zero");
+    check_round_trip(std::vector<uint16_t>(1, 65535), "65535");
+    check_round_trip(std::vector<uint16_t>(max_array_count, 32768), "constant");
+
+    //the largest deltas, both ways (3 bytes each)
+    std::vector<uint16_t> extremes;
+    for (uint16_t i=0; i<max_array_count; i++) {
+        extremes.push_back((i % 2) ? 65535 : 0);
+    }
+    check_round_trip(extremes, "0 and 65535");
+
+    //either side of each varint length (zig-zag 127 and 128 for 1 to 2 bytes, 16383 and 16384 for 2 to 3)
+    const int32_t boundary_deltas[] = {63, 64, -64, -65, 8191, 8192, -8192, -8193, 1, -1, 0};
+    for (size_t delta_i=0; delta_i<(sizeof(boundary_deltas) / sizeof(boundary_deltas[0])); delta_i++) {
+        const int32_t delta = boundary_deltas[delta_i];
+        std::vector<uint16_t> values;
+        values.push_back(static_cast<uint16_t>(30000 - (delta * 3)));
+        for (uint16_t i=1; i<7; i++) {
+            values.push_back(static_cast<uint16_t>(values[i - 1] + delta));
+        }
+        check_round_trip(values, "a boundary delta");
+    }
+
+    //small steps take one byte each
+    std::vector<uint16_t> walk;
+    uint32_t state = 1;
+    walk.push_back(20000);
+    for (uint16_t i=1; i<max_array_count; i++) {
+        state = (state * 1103515245u) + 12345u;
+        walk.push_back(static_cast<uint16_t>(walk[i - 1] + static_cast<int32_t>((state >> 16) % 127) - 63));
+    }
+    check(check_round_trip(walk, "small steps") == one_byte_length(walk.size()), "small steps are one byte each");
+
+    //any values
+    std::vector<uint16_t> any_values;
+    for (uint16_t i=0; i<max_array_count; i++) {
+        state = (state * 1103515245u) + 12345u;
+        any_values.push_back(static_cast<uint16_t>(state >> 16));
+    }
+    check_round_trip(any_values, "any values");
+
+    //every length of test_base64's array (the padding takes each of its lengths)
+    const uint16_t test_base64_values[] = {1000, 0, 100, 101, 10001, 10000, 65535, 65535, 50000, 501, 500, 50001};
+    std::vector<uint16_t> test_base64_array;
+    for (uint16_t i=0; i<24; i++) {
+        test_base64_array.push_back(test_base64_values[i % 12]);
+        check_round_trip(test_base64_array, "test_base64's array");
+    }
+
+    //nothing for no values
+    capture_clear();
+    current::print_delta_varint_array(&walk[0], 0);
+    check(capture_text().empty(), "no values prints nothing");
+
+
+    //analog histories: 16bit base64 unless delta_varint is asked for
+    sim_boot();
+    sim_run(1000, 2);
+    sim_serial_read();
+    sim_set_analog_in(0, 20000);
+    std::string output = run_command("{\"command\":\"set_input_settings\",\"input_number\":8,\"history_enabled\":true,\"history_length\":64}");
+    check(!contains(output, "\"error\""), "history enabled");
+    sim_run(1000, 2);
+    sim_serial_read();
+
+    output = run_command("{\"command\":\"get_input_history\",\"input_numbers\":[8],\"count\":16}");
+    std::vector<uint16_t> base64_history;
+    check(decode_base64_16(history_text(output), base64_history) && (base64_history.size() == 16), "the history is 16bit base64 by default");
+
+    output = run_command("{\"command\":\"get_input_history\",\"input_numbers\":[8],\"count\":16,\"delta_varint\":true}");
+    std::vector<uint16_t> delta_history;
+    check(decode_delta_varint(history_text(output), delta_history) && (delta_history.size() == 16), "the history is a delta varint when asked for");
+    check(delta_history == base64_history, "both are the same values");
+    check(!base64_history.empty() && (base64_history == std::vector<uint16_t>(16, base64_history[0])), "of the held analog value");
+
+    output = run_command("{\"command\":\"get_input_history\",\"input_numbers\":[8],\"count\":16}");
+    check(decode_base64_16(history_text(output), base64_history), "asking for it once doesn't change the next request");
+
+    return host_test_result("delta varint");
+}
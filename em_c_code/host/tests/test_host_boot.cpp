@@ -0,0 +1,34 @@
+/*
+ * test_host_boot.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// boots the simulated device, runs the main loop for a while, and checks a command round trip
+
+#include "host_test.h"
+
+
+int main() {
+    sim_boot();
+    const std::string boot_output = sim_serial_read();
+    check(sim_is_booted(), "booted");
+    check(contains(boot_output, "\"booting from HOST\""), "boot message");
+    check(contains(boot_output, "\"ready\""), "ready message");
+
+    //one simulated second
+    sim_run(sim_timer0_hz, 2);
+    check(sim_timer0_count() == sim_timer0_hz, "timer0 ticks");
+    check(sim_isr_count() >= sim_timer0_hz, "timer0 isrs ran");
+    sim_serial_read();
+
+    const std::string uptime_output = run_command("{\"command\":\"get_uptime\"}");
+    check(sim_serial_rx_pending() == 0, "command crossed the line");
+    check(contains(uptime_output, "uptime"), "uptime reply");
+
+    check(contains(run_command("{\"command\":\"not_a_command\"}"), "\"unrecognized command\""), "unrecognized command reply");
+
+    if (host_test_failures > 0) {
+        fprintf(stderr, "boot output:\n%s\n", boot_output.c_str());
+    }
+    return host_test_result("host boot");
+}
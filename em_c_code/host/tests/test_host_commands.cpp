@@ -0,0 +1,112 @@
+/*
+ * test_host_commands.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// every real command is registered at boot (the same modules as the device), and the frozen table finds each one
+// nothing is run, only looked up, so commands like reboot are safe to include
+
+#include "host_test.h"
+#include "serial_link.h"
+#include "misc.h"
+#include <string.h>
+#include <vector>
+
+
+//internal to the serial link (not in serial_link.h)
+extern serial_command_t serial_command_list;
+serial_command_t* get_command_from_json(const char *const json_cmd_value);
+
+//every command in common/ (add new commands here, so a module that forgets to register them is caught)
+static const char *const real_commands[] = {
+    "batch", "begin_configuration", "calibrate_clock_with_sync", "clear_input_regions",
+    "commit_configuration", "get_analog_conversion", "get_analog_input_values", "get_clock_scale",
+    "get_commands", "get_daughterboard_configuration", "get_digital_input_values", "get_digital_output_values",
+    "get_element_arena_statistics", "get_event_code_queue_available", "get_experiment_timestamp", "get_input_history",
+    "get_input_regions", "get_input_settings", "get_main_loop_timing", "get_output_settings",
+    "get_print_queue_statistics", "get_profile", "get_serial_configuration", "get_serial_statistics",
+    "get_ti_configuration", "get_uptime", "load_profile", "reset_experiment_clock",
+    "save_profile", "send_event_codes", "set_analog_multiplier",
+    "set_binary_mode", "set_command_echo", "set_dsp_testing_mode", "set_event_code_queue_notification",
+    "set_input_actions", "set_input_region", "set_input_settings", "set_input_simulation",
+    "set_input_stream", "set_output_actions", "set_output_settings", "set_status_messages",
+    "set_waiting_delay", "test_connection", "twiddle_leds"
+};
+static const size_t real_command_count = sizeof(real_commands) / sizeof(real_commands[0]);
+
+
+int main() {
+    sim_boot();
+    const std::string boot_output = sim_serial_read();
+
+    check(!contains(boot_output, "serial command hash collision"), "no hash collisions");
+    check(!contains(boot_output, "serial command table is full"), "table has room");
+    check(!contains(boot_output, "serial commands are frozen"), "nothing registered after the freeze");
+
+    char count_string[64];
+    snprintf(count_string, sizeof(count_string), "\"command_count\":%u", static_cast<unsigned int>(real_command_count));
+    check(contains(boot_output, count_string), "every real command is in the table");
+
+    //the list holds what was registered, in order
+    std::vector<const serial_command_t *> registered;
+    for (const serial_command_t *command = &serial_command_list; command != NULL; command = command->next_function) {
+        registered.push_back(command);
+    }
+    check(registered.size() == real_command_count, "every real command is in the list");
+
+    for (size_t i=0; i<real_command_count; i++) {
+        const serial_command_t *const command = get_command_from_json(real_commands[i]);
+        if ((command == NULL) || (strcmp(command->command_string, real_commands[i]) != 0)) {
+            fprintf(stderr, "not registered: %s\n", real_commands[i]);
+            check(false, "real command is found");
+            continue;
+        }
+        check(command->command_hash == djb2_hash(real_commands[i]), "hash matches the string");
+        check((command->json_function != NULL) || (command->void_function != NULL), "command has a function");
+    }
+
+    //every registered command is a real one, with a hash no other command has
+    for (size_t i=0; i<registered.size(); i++) {
+        bool is_real = false;
+        for (size_t j=0; j<real_command_count; j++) {
+            is_real = (is_real || (strcmp(registered[i]->command_string, real_commands[j]) == 0));
+        }
+        if (!is_real) {
+            fprintf(stderr, "not in the list of real commands: %s\n", registered[i]->command_string);
+        }
+        check(is_real, "registered command is a real one");
+        check(get_command_from_json(registered[i]->command_string) == registered[i], "lookup finds the registered command");
+
+        for (size_t j=i+1; j<registered.size(); j++) {
+            check(registered[i]->command_hash != registered[j]->command_hash, "hashes are unique");
+        }
+    }
+
+    //near misses never alias a real command
+    for (size_t i=0; i<real_command_count; i++) {
+        const std::string name = real_commands[i];
+        std::string upper = name;
+        upper[0] = static_cast<char>(upper[0] - 'a' + 'A');
+
+        check(get_command_from_json((name + "s").c_str()) == NULL, "longer name is not found");
+        check(get_command_from_json(name.substr(0, name.size() - 1).c_str()) == NULL, "shorter name is not found");
+        check(get_command_from_json(upper.c_str()) == NULL, "different case is not found");
+    }
+    check(get_command_from_json("") == NULL, "empty name is not found");
+
+    //and through the line, a command still runs
+    check(contains(run_command("{\"command\":\"test_connection\"}"), "\"connection\":\"success\""), "command runs");
+
+    //a batch counts a command as failed if it is unknown, or if its handler printed an error
+    const std::string batch_output = run_command("{\"command\":\"batch\",\"commands\":[{\"command\":\"test_connection\"},{\"command\":\"not_a_command\"},"
+                                                 "{\"command\":\"set_input_settings\",\"input_number\":0,\"not_a_setting\":1}]}");
+    check(contains(batch_output, "\"connection\":\"success\""), "batched command runs");
+    check(contains(batch_output, "\"command\":\"not_a_command\",\"batch_index\":1"), "unrecognized command has its batch index");
+    check(contains(batch_output, "\"command_count\":3"), "batch ran every command");
+    check(contains(batch_output, "\"failed_count\":2"), "handler error counts as a failure");
+
+    if (host_test_failures > 0) {
+        fprintf(stderr, "boot output:\n%s\n", boot_output.c_str());
+    }
+    return host_test_result("host commands");
+}
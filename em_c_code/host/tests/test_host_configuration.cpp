@@ -0,0 +1,69 @@
+/*
+ * test_host_configuration.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// staged configurations: any error rejects the setting, and a commit applies everything at once
+
+#include "host_test.h"
+
+
+int main() {
+    sim_boot();
+    sim_serial_read();
+
+    check(contains(run_command("{\"command\":\"begin_configuration\"}"), "configuration staging started"), "staging started");
+
+    //valid
+    std::string output = run_command("{\"command\":\"set_input_settings\",\"input_number\":0,\"history_enabled\":true,\"history_length\":64}");
+    check(contains(output, "\"staged_count\":1"), "valid input setting is staged");
+
+    //one bad field rejects the whole setting
+    output = run_command("{\"command\":\"set_input_settings\",\"input_number\":1,\"history_enabled\":true,\"history_length\":32,\"event_code_met\":5}");
+    check(contains(output, "\"error\""), "bad event code is an error");
+    check(!contains(output, "\"staged_count\""), "setting with an error is not staged");
+
+    output = run_command("{\"command\":\"set_output_settings\",\"output_number\":0,\"on_tics\":0}");
+    check(!contains(output, "\"staged_count\""), "output setting with an error is not staged");
+
+    output = run_command("{\"command\":\"set_output_settings\",\"output_number\":0,\"on_tics\":10,\"off_tics\":10}");
+    check(contains(output, "\"staged_count\":2"), "valid output setting is staged");
+
+    //nothing changes before the commit
+    output = run_command("{\"command\":\"get_input_settings\",\"input_number\":0}");
+    check(contains(output, "\"history_enabled\":false"), "history is not enabled before the commit");
+
+    output = run_command("{\"command\":\"commit_configuration\"}");
+    check(contains(output, "\"applied\":true"), "commit applied");
+    check(contains(output, "\"settings_count\":2"), "commit applied both settings");
+
+    output = run_command("{\"command\":\"get_input_settings\",\"input_number\":0}");
+    check(contains(output, "\"history_enabled\":true"), "history is enabled after the commit");
+    check(contains(output, "\"history_length\":64"), "history length after the commit");
+    output = run_command("{\"command\":\"get_input_settings\",\"input_number\":1}");
+    check(contains(output, "\"history_enabled\":false"), "rejected setting was never applied");
+
+    //changing the length swaps the buffer, and disabling frees it
+    run_command("{\"command\":\"begin_configuration\"}");
+    run_command("{\"command\":\"set_input_settings\",\"input_number\":0,\"history_enabled\":true,\"history_length\":128}");
+    run_command("{\"command\":\"set_input_settings\",\"input_number\":2,\"history_enabled\":true,\"history_length\":16,\"threshold_enabled\":true,\"threshold_value\":4}");
+    check(contains(run_command("{\"command\":\"commit_configuration\"}"), "\"applied\":true"), "second commit applied");
+    output = run_command("{\"command\":\"get_input_settings\",\"input_number\":0}");
+    check(contains(output, "\"history_length\":128"), "history length was swapped");
+
+    run_command("{\"command\":\"begin_configuration\"}");
+    run_command("{\"command\":\"set_input_settings\",\"input_number\":0,\"history_enabled\":false}");
+    run_command("{\"command\":\"set_input_settings\",\"input_number\":2,\"history_enabled\":false}");
+    check(contains(run_command("{\"command\":\"commit_configuration\"}"), "\"applied\":true"), "third commit applied");
+    output = run_command("{\"command\":\"get_input_settings\",\"input_number\":0}");
+    check(contains(output, "\"history_enabled\":false"), "history was disabled");
+
+    //discard
+    run_command("{\"command\":\"begin_configuration\"}");
+    run_command("{\"command\":\"set_input_settings\",\"input_number\":3,\"history_enabled\":true,\"history_length\":8}");
+    check(contains(run_command("{\"command\":\"commit_configuration\",\"discard\":true}"), "\"applied\":false"), "discarded commit");
+    output = run_command("{\"command\":\"get_input_settings\",\"input_number\":3}");
+    check(contains(output, "\"history_enabled\":false"), "discarded setting was never applied");
+
+    return host_test_result("host configuration");
+}
@@ -0,0 +1,107 @@
+/*
+ * test_host_print_queue.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the delayed print queue: every message the isr sends fits in a slab slot (so none of them use the heap)
+// and a burst of telemetry can't take the slots (or entries) held back for events and errors
+
+#include "host_test.h"
+#include "printf_json_delayed.h"
+#include <vector>
+
+
+//db3: inputs 0-7 are digital, 8-15 are analog (8 outputs)
+static const uint16_t digital_input_count = 8;
+static const uint16_t digital_input_gpio[digital_input_count] = {63, 11, 64, 14, 26, 15, 27, 25};
+static const uint16_t output_count = 8;
+
+
+int main() {
+    sim_boot();
+    sim_serial_read();
+
+    //every kind of isr message: targets (met and left), readouts, regions, and outputs
+    std::vector<std::string> settings;
+    for (uint16_t i=0; i<digital_input_count; i++) {
+        char line[256];
+        snprintf(line, sizeof(line), "{\"command\":\"set_input_settings\",\"input_number\":%u,\"target\":1,\"actions_enabled\":true,\"all_transitions\":true,"
+                                     "\"send_to_computer\":true,\"timeout_tics\":5,\"output_number\":%u}", i, i);
+        settings.push_back(line);
+    }
+    settings.push_back("{\"command\":\"set_input_settings\",\"input_number\":8,\"actions_enabled\":true,\"send_to_computer\":true}");
+    settings.push_back("{\"command\":\"set_input_region\",\"input_number\":8,\"region_number\":0,\"region_name\":\"high\",\"region_type\":\"rectangular_distance\","
+                       "\"region_values\":[50000],\"region_distances\":[5000],\"output_number\":0}");
+    settings.push_back("{\"command\":\"set_input_settings\",\"input_number\":9,\"readout_enabled\":true,\"readout_tics\":50}");
+    for (uint16_t i=0; i<output_count; i++) {
+        char line[192];
+        snprintf(line, sizeof(line), "{\"command\":\"set_output_settings\",\"output_number\":%u,\"enabled\":true,\"on_tics\":3,\"off_tics\":3,"
+                                     "\"send_to_computer\":true,\"all_transitions\":true}", i);
+        settings.push_back(line);
+    }
+    for (size_t i=0; i<settings.size(); i++) {
+        const std::string output = run_command(settings[i]);
+        if (contains(output, "\"error\"")) {
+            fprintf(stderr, "%s\n  %s\n", settings[i].c_str(), output.c_str());
+        }
+        check(!contains(output, "\"error\""), "setting applied");
+    }
+
+    //from here on, only the isr (and the main loop sending what it queued) prints anything
+    get_delayed_json_statistics(true);
+
+    std::string output;
+    for (uint32_t tick=0; tick<2000; tick++) {
+        for (uint16_t i=0; i<digital_input_count; i++) {
+            sim_set_gpio(digital_input_gpio[i], ((tick / (20 + (i * 10))) % 2) == 1);
+        }
+        sim_set_analog_in(0, (((tick / 100) % 2) == 1) ? 50000 : 30000);
+        sim_run(1, 2);
+        output += sim_serial_read();
+    }
+
+    const delayed_json_statistics_t statistics = get_delayed_json_statistics(false);
+    check(statistics.heap_messages == 0, "every isr message fits in a slot");
+    check(statistics.slot_count == statistics.queue_length, "a slot for every queue entry");
+
+    //and they were all sent
+    check(contains(output, "\"reason\":\"external_event\""), "target messages");
+    check(contains(output, "\"region\":\"high\",\"region_number\":0"), "region messages");
+    check(contains(output, "\"target_met\":false"), "target left messages");
+    check(contains(output, "\"value\":"), "readout messages");
+    check(contains(output, "\"output_on\":false"), "output messages");
+
+    //telemetry can only take the slots above its reserve, and its drops are counted
+    get_delayed_json_statistics(true);
+    std::vector<json_object_t *> held_slots;
+    for (uint16_t i=0; i<statistics.slot_count; i++) {
+        json_object_t *const objects = create_delayed_json_objects(1, print_class_telemetry);
+        if (objects == NULL) {break;}
+        held_slots.push_back(objects);
+    }
+    check(held_slots.size() == (statistics.slot_count - 64u), "telemetry stops at its reserve of slots");
+    check(get_delayed_json_statistics(false).class_drops[print_class_telemetry] == 1, "the slot it couldn't get is a telemetry drop");
+
+    //the same for the queue entries, while the slots are still held
+    for (uint16_t i=0; i<statistics.queue_length; i++) {
+        delay_printf_json_class_objects(print_class_telemetry, print_coalesce_none, 1, json_uint16("burst", i));
+    }
+
+    //so an error still gets a slot and an entry
+    delay_printf_json_error("after the burst");
+    const delayed_json_statistics_t burst_statistics = get_delayed_json_statistics(false);
+    check(burst_statistics.class_drops[print_class_telemetry] > 1, "the burst was dropped");
+    check(burst_statistics.class_drops[print_class_error] == 0, "no error was dropped");
+    for (size_t i=0; i<held_slots.size(); i++) {
+        release_delayed_json_objects(held_slots[i]);
+    }
+
+    sim_run(200, 2);
+    check(contains(sim_serial_read(), "\"error\":\"after the burst\""), "error sent after the burst");
+
+    if (host_test_failures > 0) {
+        fprintf(stderr, "heap messages: %u\n", static_cast<unsigned int>(statistics.heap_messages));
+        fprintf(stderr, "held slots: %u\n", static_cast<unsigned int>(held_slots.size()));
+    }
+    return host_test_result("host print queue");
+}
@@ -0,0 +1,148 @@
+/*
+ * test_host_profile.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// the saved profile: its hash ignores what the isr changes while running, and it is loaded from flash at the next boot
+// the region tables are part of it (and of its hash)
+// the firmware boots once per process, so each boot runs in a child process (sharing the flash file)
+
+#include "host_test.h"
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+//db3: input 8 is the first analog input (channel 0)
+static const uint16_t analog_channel = 0;
+
+static const std::string set_input = "{\"command\":\"set_input_settings\",\"input_number\":8,\"target_type\":\">\",\"target_value\":32768,"
+                                     "\"actions_enabled\":true,\"actions_disabled_after_met\":true,"
+                                     "\"output_enabled\":true,\"output_disabled_after_met\":true,\"output_number\":0}";
+static const std::string set_region = "{\"command\":\"set_input_region\",\"input_number\":10,\"region_number\":2,\"region_name\":\"high\","
+                                      "\"region_type\":\"rectangular_distance\",\"region_values\":[50000],\"region_distances\":[5000],\"output_number\":1}";
+static const std::string set_output = "{\"command\":\"set_output_settings\",\"output_number\":0,\"enabled\":true,\"is_continuous\":true}";
+
+
+//the value after "name": (up to the next , or })
+static std::string json_value(const std::string &output, const char *const name) {
+    const std::string key = std::string("\"") + name + "\":";
+    const size_t start = output.find(key);
+    if (start == std::string::npos) {return "";}
+
+    const size_t value_start = start + key.size();
+    const size_t value_end = output.find_first_of(",}", value_start);
+    return output.substr(value_start, value_end - value_start);
+}
+
+//runs a boot in a child (0 if every check in it passed), and passes its hash back
+static int run_boot(int (*boot)(std::string &hash), std::string &hash) {
+    int hash_pipe[2];
+    if (pipe(hash_pipe) != 0) {return 1;}
+
+    const pid_t child = fork();
+    if (child == 0) {
+        close(hash_pipe[0]);
+        const int result = boot(hash);
+        if (write(hash_pipe[1], hash.c_str(), hash.size()) < 0) {_exit(1);}
+        _exit(result);
+    }
+    close(hash_pipe[1]);
+
+    char buffer[32] = {0};
+    const ssize_t length = read(hash_pipe[0], buffer, sizeof(buffer) - 1);
+    close(hash_pipe[0]);
+    hash = (length > 0) ? std::string(buffer, static_cast<size_t>(length)) : "";
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    return (WIFEXITED(status) && (WEXITSTATUS(status) == 0)) ? 0 : 1;
+}
+
+static std::string flash_path;
+
+
+//first boot: nothing saved, then configure and save it
+static int save_boot(std::string &hash) {
+    sim_flash_set_file(flash_path);
+    sim_boot();
+    const std::string boot_output = sim_serial_read();
+    check(!contains(boot_output, "\"loaded\""), "nothing to load from an erased sector");
+
+    check(!contains(run_command(set_output), "\"error\""), "output set");
+    check(!contains(run_command(set_input), "\"error\""), "input set");
+    check(!contains(run_command(set_region), "\"error\""), "region set");
+
+    const std::string saved = run_command("{\"command\":\"save_profile\"}");
+    check(contains(saved, "\"saved\":true"), "profile saved");
+    check(contains(saved, "\"stored\":true"), "profile stored in flash");
+    check(contains(saved, "\"region_count\":1"), "region saved");
+    hash = json_value(saved, "hash");
+
+    //the target is met once, so the isr disables the actions and the output, and turns the output on
+    sim_set_analog_in(analog_channel, 40000);
+    sim_run(100, 2);
+    sim_serial_read();
+    const std::string settings = run_command("{\"command\":\"get_input_settings\",\"input_number\":8}");
+    check(contains(settings, "\"output_enabled\":false"), "isr disabled the output");
+
+    const std::string profile = run_command("{\"command\":\"get_profile\"}");
+    check(json_value(profile, "current_hash") == hash, "the isr's changes are not part of the hash");
+
+    return host_test_failures;
+}
+
+//second boot: the same profile, straight from flash
+static int load_boot(std::string &hash) {
+    sim_flash_set_file(flash_path);
+    sim_boot();
+    const std::string boot_output = sim_serial_read();
+    check(contains(boot_output, "\"loaded\":true"), "profile loaded at boot");
+    check(contains(boot_output, "\"from\":\"flash\""), "profile loaded from flash");
+
+    const std::string profile = run_command("{\"command\":\"get_profile\"}");
+    check(contains(profile, "\"saved\":true"), "profile is saved after the boot");
+    check(json_value(profile, "current_hash") == json_value(profile, "hash"), "configuration is the profile");
+    hash = json_value(profile, "hash");
+
+    const std::string settings = run_command("{\"command\":\"get_input_settings\",\"input_number\":8}");
+    check(contains(settings, "\"output_enabled\":true"), "output enabled as configured");
+
+    const std::string regions = run_command("{\"command\":\"get_input_regions\",\"input_number\":10}");
+    check(contains(regions, "\"region_number\":2,\"region_name\":\"high\""), "region loaded");
+    check(contains(regions, "\"region_values\":[50000]"), "region values loaded");
+
+    //and without the region, it is not the profile
+    run_command("{\"command\":\"clear_input_regions\",\"input_number\":10}");
+    const std::string cleared_profile = run_command("{\"command\":\"get_profile\"}");
+    check(json_value(cleared_profile, "current_hash") != hash, "the regions are part of the hash");
+
+    if (host_test_failures > 0) {
+        fprintf(stderr, "boot output:\n%s\n", boot_output.c_str());
+    }
+    return host_test_failures;
+}
+
+
+int main() {
+    char path[] = "/tmp/em_profile_XXXXXX";
+    const int file = mkstemp(path);
+    if (file < 0) {
+        perror("could not make the flash file");
+        return 1;
+    }
+    close(file);
+    unlink(path);   //a missing file is an erased sector
+    flash_path = path;
+
+    std::string saved_hash;
+    check(run_boot(save_boot, saved_hash) == 0, "first boot");
+    check(!saved_hash.empty(), "hash from the first boot");
+
+    std::string loaded_hash;
+    check(run_boot(load_boot, loaded_hash) == 0, "boot with the saved profile");
+    check(loaded_hash == saved_hash, "same hash after the reboot");
+
+    unlink(path);
+    return host_test_result("host profile");
+}
@@ -0,0 +1,124 @@
+/*
+ * test_host_pty.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// a client on the pty, with the device running in realtime: a command gets its reply, and tx is held to the baud rate
+
+#include "host_test.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+
+static uint64_t now_us() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000ULL) + (static_cast<uint64_t>(now.tv_nsec) / 1000ULL);
+}
+
+//reads whatever arrives within the timeout
+static std::string read_for(int fd, uint64_t timeout_us) {
+    std::string output;
+    const uint64_t end_us = now_us() + timeout_us;
+
+    while (now_us() < end_us) {
+        struct pollfd poll_settings;
+        poll_settings.fd = fd;
+        poll_settings.events = POLLIN;
+        poll_settings.revents = 0;
+        if (poll(&poll_settings, 1, 10) <= 0) {continue;}
+
+        char buffer[4096];
+        const ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length > 0) {
+            output.append(buffer, static_cast<size_t>(length));
+        }
+    }
+    return output;
+}
+
+//the time from the last byte written until the reply is complete (or 0)
+static uint64_t command_latency_us(int fd, const std::string &json_line, const char *const reply) {
+    const std::string line = json_line + "\n";
+    if (write(fd, line.c_str(), line.size()) != static_cast<ssize_t>(line.size())) {
+        return 0;
+    }
+    tcdrain(fd);
+    const uint64_t start_us = now_us();
+
+    std::string output;
+    while ((now_us() - start_us) < 2000000) {
+        output += read_for(fd, 1000);
+        const size_t found = output.find(reply);
+        if ((found != std::string::npos) && (output.find('\n', found) != std::string::npos)) {
+            return now_us() - start_us;
+        }
+    }
+    return 0;
+}
+
+
+int main() {
+    std::string pty_path;
+    check(sim_pty_open(pty_path), "pty opened");
+    if (pty_path.empty()) {
+        return host_test_result("host pty");
+    }
+
+    sim_boot();
+    std::thread device_thread(sim_run_realtime);
+
+    //a client, the way a serial library opens the port
+    const int client_fd = open(pty_path.c_str(), O_RDWR | O_NOCTTY);
+    check(client_fd >= 0, "client opened the pty");
+
+    struct termios settings;
+    tcgetattr(client_fd, &settings);
+    cfmakeraw(&settings);
+    cfsetispeed(&settings, B921600);
+    cfsetospeed(&settings, B921600);
+    tcsetattr(client_fd, TCSANOW, &settings);
+
+    //the boot messages were already waiting
+    check(contains(read_for(client_fd, 200000), "booting from HOST"), "boot messages on the pty");
+
+    //command to reply
+    uint64_t worst_latency_us = 0;
+    for (uint16_t i=0; i<10; i++) {
+        const uint64_t latency_us = command_latency_us(client_fd, "{\"command\":\"get_uptime\"}", "uptime");
+        check(latency_us > 0, "get_uptime replied");
+        if (latency_us > worst_latency_us) {
+            worst_latency_us = latency_us;
+        }
+    }
+    printf("get_uptime: worst command-to-reply latency %lluus\n", static_cast<unsigned long long>(worst_latency_us));
+
+    //saturate tx: 8 inputs reading out every tic is far more than the line can carry
+    for (uint16_t i=8; i<16; i++) {
+        char command[128];
+        snprintf(command, sizeof(command), "{\"command\":\"set_input_settings\",\"input_number\":%u,\"readout_enabled\":true,\"readout_tics\":1}\n", i);
+        check(write(client_fd, command, strlen(command)) > 0, "readout command written");
+    }
+    read_for(client_fd, 200000);
+
+    const uint64_t start_us = now_us();
+    const std::string saturated_output = read_for(client_fd, 1000000);
+    const double bytes_per_second = static_cast<double>(saturated_output.size()) * 1e6 / static_cast<double>(now_us() - start_us);
+    const double line_bytes_per_second = static_cast<double>(sim_baud_rate) / static_cast<double>(sim_bits_per_byte);
+    printf("saturated tx: %.0f bytes/s (the line carries %.0f)\n", bytes_per_second, line_bytes_per_second);
+
+    check(bytes_per_second > (0.5 * line_bytes_per_second), "tx is saturated");
+    check(bytes_per_second < (1.05 * line_bytes_per_second), "tx is held to the baud rate");
+
+    sim_stop();
+    device_thread.join();
+    close(client_fd);
+    sim_pty_close();
+
+    return host_test_result("host pty");
+}
@@ -0,0 +1,172 @@
+/*
+ * test_host_regions.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// input regions, one tic at a time: entering, moving to another region, the min lengths, leaving, and clearing
+// each step checks the region messages, the event codes on the dsp pins, and the outputs
+
+#include "host_test.h"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+
+//db3: input 8 is the first analog input (channel 0), and the dsp code is 8 bits with a strobe
+//input 9 (channel 1) gets the same values, and its target (no min length) is met on the tic the values are first seen
+static const uint16_t analog_channel = 0;
+static const uint16_t reference_channel = 1;
+static const uint16_t dsp_strobe_gpio = 29;
+static const uint16_t dsp_bit_count = 8;
+static const uint16_t dsp_bit_gpio[dsp_bit_count] = {130, 10, 131, 9, 66, 8, 6, 7};
+
+//the io runs every timer tick, but the experiment clock (the min lengths, and the timestamps in ms) every 10
+static const uint32_t ticks_per_tic = 10;
+
+//what was sent while a value was held
+typedef struct held_output_t {
+    std::string serial;
+    std::vector<uint16_t> codes;
+} held_output_t;
+
+
+//the code is on the pins for as long as the strobe is
+static bool read_event_code(uint16_t &code) {
+    if (!sim_get_gpio(dsp_strobe_gpio)) {return false;}
+
+    code = 0;
+    for (uint16_t i=0; i<dsp_bit_count; i++) {
+        code |= static_cast<uint16_t>(sim_get_gpio(dsp_bit_gpio[i]) ? 1 : 0) << i;
+    }
+    return true;
+}
+
+//runs for whole tics, and collects what was sent (each code is strobed for one timer tick)
+static held_output_t run_tics(uint32_t tics) {
+    held_output_t output;
+    for (uint32_t tick=0; tick<(tics * ticks_per_tic); tick++) {
+        sim_run(1, 2);
+        output.serial += sim_serial_read();
+
+        uint16_t code;
+        if (read_event_code(code)) {
+            output.codes.push_back(code);
+        }
+    }
+    return output;
+}
+
+static held_output_t run_with_value(uint16_t value, uint32_t tics) {
+    sim_set_analog_in(analog_channel, value);
+    sim_set_analog_in(reference_channel, value);
+    return run_tics(tics);
+}
+
+//the tic of the first message with the text (0 if there isn't one)
+static uint64_t message_tic(const std::string &output, const std::string &text) {
+    const size_t text_start = output.find(text);
+    if (text_start == std::string::npos) {return 0;}
+
+    const size_t timestamp_start = output.rfind("\"timestamp\":", text_start);
+    if (timestamp_start == std::string::npos) {return 0;}
+    return static_cast<uint64_t>(llround(strtod(output.c_str() + timestamp_start + 12, NULL) * 1000.0));
+}
+
+static uint64_t region_tic(const std::string &output, const char *const region_name) {
+    return message_tic(output, std::string("\"region\":\"") + region_name + "\"");
+}
+
+static bool has_codes(const held_output_t &output, uint16_t first, uint16_t second = 0) {
+    if (second == 0) {
+        return (output.codes.size() == 1) && (output.codes[0] == first);
+    }
+    return (output.codes.size() == 2) && (output.codes[0] == first) && (output.codes[1] == second);
+}
+
+
+int main() {
+    sim_boot();
+    sim_serial_read();
+
+    //output 0 is continuous (on while in "low"), output 1 runs cycles (queued when entering "high")
+    const char *const settings[] = {
+        "{\"command\":\"set_output_settings\",\"output_number\":0,\"enabled\":false,\"is_continuous\":true,\"on_tics\":1000,\"off_tics\":1,"
+            "\"send_to_computer\":true,\"all_transitions\":true}",
+        "{\"command\":\"set_output_settings\",\"output_number\":1,\"enabled\":true,\"on_tics\":2,\"off_tics\":2,\"send_to_computer\":true,\"all_transitions\":true}",
+        "{\"command\":\"set_input_settings\",\"input_number\":8,\"actions_enabled\":true,\"send_to_computer\":true}",
+        "{\"command\":\"set_input_settings\",\"input_number\":9,\"target_type\":\"<\",\"target_value\":25000,\"actions_enabled\":true,\"send_to_computer\":true}",
+        "{\"command\":\"set_input_region\",\"input_number\":8,\"region_number\":0,\"region_name\":\"low\",\"region_type\":\"rectangular_distance\","
+            "\"region_values\":[20000],\"region_distances\":[5000],\"event_code_met\":200,\"event_code_left\":201,\"output_number\":0}",
+        "{\"command\":\"set_input_region\",\"input_number\":8,\"region_number\":1,\"region_name\":\"high\",\"region_type\":\"rectangular_distance\","
+            "\"region_values\":[50000],\"region_distances\":[5000],\"target_met_min_tics\":10,\"target_left_min_tics\":5,"
+            "\"event_code_met\":210,\"event_code_left\":211,\"output_number\":1,\"output_cycles\":2}"
+    };
+    sim_set_analog_in(analog_channel, 35000);
+    sim_set_analog_in(reference_channel, 35000);
+    for (size_t i=0; i<(sizeof(settings) / sizeof(settings[0])); i++) {
+        const std::string output = run_command(settings[i]);
+        if (contains(output, "\"error\"")) {
+            fprintf(stderr, "%s\n  %s\n", settings[i], output.c_str());
+        }
+        check(!contains(output, "\"error\""), "setting applied");
+    }
+
+    //outside of every region, nothing happens
+    held_output_t output = run_with_value(35000, 20);
+    check(!contains(output.serial, "\"region\""), "no region message outside of the regions");
+    check(output.codes.empty(), "no event code outside of the regions");
+
+    //enter "low" (no min length): its code, and its continuous output turns on
+    output = run_with_value(20000, 30);
+    const uint64_t low_tic = region_tic(output.serial, "low");
+    check(low_tic > 0, "entered low");
+    check(low_tic == message_tic(output.serial, "{\"input_09\""), "entered low on the tic the values were seen");
+    check(contains(output.serial, "\"region\":\"low\",\"region_number\":0,\"output_queued\":true"), "low message");
+    check(has_codes(output, 200), "low met code");
+    check(contains(output.serial, "{\"output_00\":{\"reason\":\"external_event\""), "continuous output on");
+    check(!contains(output.serial, "\"output_on\":false"), "continuous output stays on");
+
+    //move to "high": only once the values have been there for its met length, then low's left code and high's met code
+    output = run_with_value(50000, 30);
+    check(region_tic(output.serial, "high") == (low_tic + 30 + 10), "entered high after its met length");
+    check(contains(output.serial, "\"region\":\"high\",\"region_number\":1,\"output_queued\":true"), "high message");
+    check(!contains(output.serial, "\"region\":\"none\""), "moved without leaving for no region");
+    check(has_codes(output, 201, 210), "low left code, then high met code");
+    check(contains(output.serial, "{\"output_00\":{\"reason\":\"external_event\",\"timestamp\":") &&
+          contains(output.serial, "\"output_on\":false"), "continuous output off when low is left");
+    size_t cycle_count = 0;
+    for (size_t start = output.serial.find("\"output_01\""); start != std::string::npos; start = output.serial.find("\"output_01\"", start + 1)) {
+        cycle_count += (output.serial.compare(output.serial.find("\"output_on\":", start), 16, "\"output_on\":true") == 0) ? 1 : 0;
+    }
+    check(cycle_count == 2, "high's output cycles");
+
+    //out for less than high's left length, then back: nothing happens
+    output = run_with_value(35000, 3);
+    held_output_t back = run_with_value(50000, 20);
+    check(!contains(output.serial + back.serial, "\"region\""), "no region message for a short leave");
+    check(output.codes.empty() && back.codes.empty(), "no event code for a short leave");
+
+    //leave for no region: only once the values have been out for high's left length
+    output = run_with_value(35000, 20);
+    check(region_tic(output.serial, "none") == (low_tic + 30 + 30 + 3 + 20 + 5), "left after the left length");
+    check(contains(output.serial, "\"region\":\"none\",\"output_queued\":false"), "left message");
+    check(has_codes(output, 211), "high left code");
+
+    //clearing while in a region leaves it (its code, and its continuous output turns off), and goes back to the target
+    output = run_with_value(20000, 10);
+    check(has_codes(output, 200), "low met again");
+    sim_send_command("{\"command\":\"clear_input_regions\",\"input_number\":8}");
+    output = run_tics(30);
+    check(contains(output.serial, "{\"input_08\":{\"reason\":\"set\",\"region_count\":0}}"), "regions cleared");
+    check(has_codes(output, 201), "low left code when cleared");
+    check(contains(output.serial, "\"output_on\":false"), "continuous output off when cleared");
+
+    output = run_with_value(50000, 30);
+    check(!contains(output.serial, "\"region\""), "no region message once cleared");
+    check(output.codes.empty(), "no event code once cleared");
+
+    const std::string regions = run_command("{\"command\":\"get_input_regions\",\"input_number\":8}");
+    check(contains(regions, "\"region_count\":0,\"current_region\":\"none\""), "no regions once cleared");
+
+    return host_test_result("host regions");
+}
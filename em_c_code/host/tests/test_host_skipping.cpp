@@ -0,0 +1,188 @@
+/*
+ * test_host_skipping.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// skipping inputs that can't change: the same values, with and without skipping, must send the same messages on the same tics
+// the values bounce through the met and left min lengths and the timeouts, and the experiment clock is reset while deadlines are pending
+// after configuring, each way runs in a child process (from the same state), and passes back everything it sent
+
+#include "host_test.h"
+#include "io_controller.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+//db3: input 0 is digital, inputs 8 and 9 are the first analog inputs (channels 0 and 1)
+static const uint16_t digital_gpio = 63;
+static const uint16_t analog_channel = 0;
+static const uint16_t timeout_channel = 1;
+
+//the io runs every timer tick, but the experiment clock (the min lengths and timeouts) every 10
+static const uint32_t ticks_per_tic = 10;
+static const uint32_t run_tics = 1200;
+
+//reset the clock while input 0 is waiting out its met length (it goes high 2 tics before, and stays there)
+static const uint32_t reset_tics[] = {400, 900};
+static const uint16_t reset_count = sizeof(reset_tics) / sizeof(reset_tics[0]);
+
+
+//each value is held for 1 to 16 tics (a fixed sequence), so some are shorter than the min lengths, and some longer
+static uint32_t next_hold_tics(uint32_t &state) {
+    state = (state * 1103515245u) + 12345u;
+    return 1 + ((state >> 16) % 16);
+}
+
+static std::string run_values(bool is_skipping) {
+    enable_input_skipping(is_skipping);
+
+    uint32_t digital_state = 1;
+    uint32_t analog_state = 2;
+    uint32_t digital_change_tic = 0;
+    uint32_t analog_change_tic = 0;
+    bool digital_value = false;
+    bool analog_high = false;
+    uint16_t reset_i = 0;
+
+    std::string output;
+    for (uint32_t tic=0; tic<run_tics; tic++) {
+        if ((reset_i < reset_count) && ((tic + 2) >= reset_tics[reset_i]) && (tic <= reset_tics[reset_i])) {
+            digital_value = true;
+            digital_change_tic = reset_tics[reset_i] + 30;
+            if (tic == reset_tics[reset_i]) {
+                sim_send_command("{\"command\":\"reset_experiment_clock\"}");
+                reset_i++;
+            }
+        } else if (tic >= digital_change_tic) {
+            digital_value = !digital_value;
+            digital_change_tic = tic + next_hold_tics(digital_state);
+        }
+        if (tic >= analog_change_tic) {
+            analog_high = !analog_high;
+            analog_change_tic = tic + next_hold_tics(analog_state);
+        }
+
+        sim_set_gpio(digital_gpio, digital_value);
+        sim_set_analog_in(analog_channel, analog_high ? 50000 : 20000);
+        sim_set_analog_in(timeout_channel, analog_high ? 20000 : 50000);
+        for (uint32_t tick=0; tick<ticks_per_tic; tick++) {
+            sim_run(1, 2);
+            output += sim_serial_read();
+        }
+    }
+    return output;
+}
+
+//runs one way in a child, and passes back what it sent
+static std::string run_child(bool is_skipping) {
+    int output_pipe[2];
+    if (pipe(output_pipe) != 0) {return "";}
+
+    const pid_t child = fork();
+    if (child == 0) {
+        close(output_pipe[0]);
+        const std::string output = run_values(is_skipping);
+        if (write(output_pipe[1], output.c_str(), output.size()) < 0) {_exit(1);}
+        _exit(0);
+    }
+    close(output_pipe[1]);
+
+    std::string output;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = read(output_pipe[0], buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, static_cast<size_t>(length));
+    }
+    close(output_pipe[0]);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && (WEXITSTATUS(status) == 0), "child ran");
+    return output;
+}
+
+static size_t count_of(const std::string &output, const char *const text) {
+    size_t count = 0;
+    for (size_t start = output.find(text); start != std::string::npos; start = output.find(text, start + 1)) {
+        count++;
+    }
+    return count;
+}
+
+//the isr's over budget errors depend on how fast the host is, not on the inputs
+static std::string without_budget_errors(const std::string &output) {
+    std::string kept;
+    size_t line_start = 0;
+    while (line_start < output.size()) {
+        size_t line_end = output.find('\n', line_start);
+        line_end = (line_end == std::string::npos) ? output.size() : (line_end + 1);
+        const std::string line = output.substr(line_start, line_end - line_start);
+        if (!contains(line, "exceeded the timer period")) {
+            kept += line;
+        }
+        line_start = line_end;
+    }
+    return kept;
+}
+
+//the first line that differs (to see where they went apart)
+static void print_first_difference(const std::string &skipped, const std::string &every_tic) {
+    size_t line_start = 0;
+    while (true) {
+        const size_t skipped_end = skipped.find('\n', line_start);
+        const size_t every_tic_end = every_tic.find('\n', line_start);
+        const std::string skipped_line = skipped.substr(line_start, (skipped_end == std::string::npos) ? std::string::npos : (skipped_end - line_start));
+        const std::string every_tic_line = every_tic.substr(line_start, (every_tic_end == std::string::npos) ? std::string::npos : (every_tic_end - line_start));
+        if ((skipped_line != every_tic_line) || (skipped_end == std::string::npos)) {
+            fprintf(stderr, "skipping:   %s\nevery tic:  %s\n", skipped_line.c_str(), every_tic_line.c_str());
+            return;
+        }
+        line_start = skipped_end + 1;
+    }
+}
+
+
+int main() {
+    sim_boot();
+    sim_serial_read();
+
+    //input 0: met and left min lengths, and a timeout after it is met
+    //input 8: met and left min lengths, input 9: only a timeout
+    const char *const settings[] = {
+        "{\"command\":\"set_input_settings\",\"input_number\":0,\"target\":1,\"target_met_min_tics\":8,\"target_left_min_tics\":5,"
+            "\"timeout_tics\":12,\"actions_enabled\":true,\"all_transitions\":true,\"send_to_computer\":true}",
+        "{\"command\":\"set_input_settings\",\"input_number\":8,\"target_type\":\">\",\"target_value\":32768,\"target_met_min_tics\":6,"
+            "\"target_left_min_tics\":3,\"actions_enabled\":true,\"all_transitions\":true,\"send_to_computer\":true}",
+        "{\"command\":\"set_input_settings\",\"input_number\":9,\"target_type\":\"<\",\"target_value\":25000,\"timeout_tics\":7,"
+            "\"actions_enabled\":true,\"all_transitions\":true,\"send_to_computer\":true}"
+    };
+    sim_set_gpio(digital_gpio, false);
+    sim_set_analog_in(analog_channel, 20000);
+    sim_set_analog_in(timeout_channel, 50000);
+    for (size_t i=0; i<(sizeof(settings) / sizeof(settings[0])); i++) {
+        const std::string output = run_command(settings[i]);
+        if (contains(output, "\"error\"")) {
+            fprintf(stderr, "%s\n  %s\n", settings[i], output.c_str());
+        }
+        check(!contains(output, "\"error\""), "setting applied");
+    }
+
+    const std::string skipped = without_budget_errors(run_child(true));
+    const std::string every_tic = without_budget_errors(run_child(false));
+
+    //there was plenty to compare
+    check(count_of(skipped, "\"input_00\"") > 20, "input 0 messages");
+    check(count_of(skipped, "\"input_08\"") > 20, "input 8 messages");
+    check(count_of(skipped, "\"input_09\"") > 20, "input 9 messages");
+    check(count_of(skipped, "\"target_met\":false") > 20, "target left messages");
+    check(count_of(skipped, "experiment clock was reset") == reset_count, "the clock was reset");
+    check(!contains(skipped, "\"error\""), "no errors");
+
+    //and every message (and its timestamp) is the same
+    if (skipped != every_tic) {
+        print_first_difference(skipped, every_tic);
+    }
+    check(skipped == every_tic, "skipping sends the same messages on the same tics");
+
+    return host_test_result("host skipping");
+}
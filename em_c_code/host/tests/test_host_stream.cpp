@@ -0,0 +1,44 @@
+/*
+ * test_host_stream.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// input streaming: the limits on its settings, and chunks of whole frames while it runs
+
+#include "host_test.h"
+
+
+//a running stream never lets the line go idle, so only run long enough for the reply (and a few chunks)
+static std::string start_stream(const std::string &json_line) {
+    sim_send_command(json_line);
+    sim_run(200, 2);
+    return sim_serial_read();
+}
+
+
+int main() {
+    sim_boot();
+    sim_serial_read();
+
+    //too many inputs is an error, with the limit
+    std::string output = run_command("{\"command\":\"set_input_stream\",\"input_numbers\":[0,1,2,3,4,5,6,7,8]}");
+    check(contains(output, "\"error\""), "too many inputs is an error");
+    check(contains(output, "\"max_count\":8"), "error has the max count");
+
+    //the largest chunk is allowed (256 values), and anything larger is the largest
+    output = start_stream("{\"command\":\"set_input_stream\",\"input_numbers\":[8,9],\"chunk_frames\":128}");
+    check(contains(output, "\"chunk_frames\":128"), "largest chunk is allowed");
+    output = start_stream("{\"command\":\"set_input_stream\",\"input_numbers\":[8,9],\"chunk_frames\":129}");
+    check(contains(output, "\"chunk_frames\":128"), "larger chunk is the largest");
+
+    //small chunks, so a few are sent
+    output = start_stream("{\"command\":\"set_input_stream\",\"input_numbers\":[8,9],\"chunk_frames\":4}");
+    check(contains(output, "\"input_stream_started\""), "stream started");
+    check(contains(output, "{\"input_stream\":{\"sequence\":0,\"dropped\":0,\"input_count\":2"), "first chunk");
+    check(contains(output, "\"sequence\":1,"), "second chunk");
+
+    output = run_command("{\"command\":\"set_input_stream\",\"stop\":true}");
+    check(contains(output, "input stream stopped"), "stream stopped");
+
+    return host_test_result("host stream");
+}
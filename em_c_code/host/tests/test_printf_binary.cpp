@@ -0,0 +1,218 @@
+/*
+ * test_printf_binary.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// binary frames: every record decodes (COBS) to the bytes that were put, with a matching CRC16,
+// across the 254 byte block boundary, and switching modes sends what was queued in the mode it was queued in
+
+#include "host_test.h"
+#include "printf_binary.h"
+#include "printf_json_delayed.h"
+#include <string.h>
+#include <vector>
+
+static const uint16_t cobs_max_block_length = 254;
+static const uint64_t timestamp = 0x0102030405060708ULL;   //no zero bytes, so the record starts with 9 in one block
+static const uint16_t record_header_length = 9;
+
+
+//reference crc16-ccitt (bitwise, from the definition)
+static uint16_t reference_crc16(const std::vector<uint8_t> &bytes) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i=0; i<bytes.size(); i++) {
+        crc ^= static_cast<uint16_t>(bytes[i] << 8);
+        for (uint16_t bit_i=0; bit_i<8; bit_i++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+//decodes one frame (without its zero delimiter), false if it isn't valid COBS
+static bool cobs_decode(const std::string &frame, std::vector<uint8_t> &decoded) {
+    decoded.clear();
+    size_t frame_i = 0;
+    while (frame_i < frame.size()) {
+        const uint16_t code = static_cast<uint8_t>(frame[frame_i]);
+        if ((code == 0) || ((frame_i + code) > (frame.size() + ((code == 1) ? 0 : 0)))) {
+            return false;
+        }
+        frame_i++;
+
+        for (uint16_t i=1; i<code; i++) {
+            if ((frame_i >= frame.size()) || (frame[frame_i] == 0)) {return false;}
+            decoded.push_back(static_cast<uint8_t>(frame[frame_i]));
+            frame_i++;
+        }
+
+        //a short block is followed by a zero, unless it ends the frame
+        if ((code < 0xFF) && (frame_i < frame.size())) {
+            decoded.push_back(0);
+        }
+    }
+    return true;
+}
+
+//splits the output on the zero delimiters (the text before the first frame is returned separately)
+static std::vector<std::string> split_frames(const std::string &output, std::string &trailing) {
+    std::vector<std::string> frames;
+    size_t start = 0;
+    for (size_t end = output.find('\0'); end != std::string::npos; end = output.find('\0', start)) {
+        frames.push_back(output.substr(start, end - start));
+        start = end + 1;
+    }
+    trailing = output.substr(start);
+    return frames;
+}
+
+//checks a frame's crc, and returns the record bytes (without the crc)
+static bool decode_record(const std::string &frame, std::vector<uint8_t> &record) {
+    if (!cobs_decode(frame, record) || (record.size() < 2)) {return false;}
+
+    const uint16_t crc = static_cast<uint16_t>(record[record.size() - 2] | (record[record.size() - 1] << 8));
+    record.resize(record.size() - 2);
+    return (crc == reference_crc16(record));
+}
+
+//runs only the timer (so only what was already queued, or put, is sent)
+static std::string drain_line() {
+    std::string output;
+    for (uint16_t tick=0; tick<200; tick++) {
+        sim_run(1, 0);
+        output += sim_serial_read();
+    }
+    return output;
+}
+
+//the command arrives, then messages are queued before the main loop runs it (so they are still queued when it switches)
+//(a status keeps the pointer to its text until it is sent, so the texts are literals)
+static std::string switch_mode_with_queued(bool enable, const char *const first_text, const char *const second_text) {
+    sim_send_command(enable ? "{\"command\":\"set_binary_mode\",\"enable\":true}" : "{\"command\":\"set_binary_mode\",\"enable\":false}");
+    while (sim_serial_rx_pending() > 0) {
+        sim_run(1, 0);
+    }
+    sim_run(1, 0);
+
+    delay_printf_json_status(first_text);
+    delay_printf_json_status(second_text);
+
+    std::string output;
+    for (uint16_t tick=0; tick<200; tick++) {
+        sim_run(1, 2);
+        output += sim_serial_read();
+    }
+    return output;
+}
+
+
+//puts a record with the payload, and checks that it decodes to the same bytes
+static void check_round_trip(const std::vector<uint8_t> &payload, const char *const name) {
+    binary_frame_begin(binary_record_message, static_cast<int64_t>(timestamp));
+    for (size_t i=0; i<payload.size(); i++) {
+        binary_frame_put_byte(payload[i]);
+    }
+    binary_frame_end();
+
+    std::string trailing;
+    const std::vector<std::string> frames = split_frames(drain_line(), trailing);
+    std::vector<uint8_t> record;
+    const bool is_one_frame = (frames.size() == 1) && trailing.empty();
+    const bool is_decoded = is_one_frame && decode_record(frames[0], record);
+
+    std::vector<uint8_t> expected;
+    expected.push_back(binary_record_message);
+    for (uint16_t i=0; i<8; i++) {
+        expected.push_back(static_cast<uint8_t>(timestamp >> (8 * i)));
+    }
+    expected.insert(expected.end(), payload.begin(), payload.end());
+
+    if (!is_decoded || (record != expected)) {
+        fprintf(stderr, "%s (%u payload bytes): %u frames, %s\n", name, static_cast<unsigned int>(payload.size()),
+                static_cast<unsigned int>(frames.size()), is_decoded ? "decoded to other bytes" : "didn't decode");
+    }
+    check(is_one_frame, "one frame, ending with the delimiter");
+    check(is_decoded, "the frame decodes, and the crc matches");
+    check(record == expected, "the record is the bytes that were put");
+}
+
+
+int main() {
+    sim_boot();
+    sim_run(1000, 2);
+    sim_serial_read();
+
+    //the crc against the reference, for every byte from each of a few starting values
+    const uint16_t crc_starts[] = {0xFFFF, 0x0000, 0x1D0F, 0x8000};
+    for (uint16_t start_i=0; start_i<4; start_i++) {
+        for (uint16_t byte=0; byte<256; byte++) {
+            uint16_t reference = crc_starts[start_i] ^ static_cast<uint16_t>(byte << 8);
+            for (uint16_t bit_i=0; bit_i<8; bit_i++) {
+                reference = (reference & 0x8000) ? static_cast<uint16_t>((reference << 1) ^ 0x1021) : static_cast<uint16_t>(reference << 1);
+            }
+            check(crc16_update(crc_starts[start_i], byte) == reference, "crc16 matches the reference");
+        }
+    }
+    std::vector<uint8_t> check_string(reinterpret_cast<const uint8_t *>("123456789"), reinterpret_cast<const uint8_t *>("123456789") + 9);
+    check(reference_crc16(check_string) == 0x29B1, "reference crc16 of the check string");
+
+    //empty, zeros, every byte value
+    check_round_trip(std::vector<uint8_t>(), "empty");
+    check_round_trip(std::vector<uint8_t>(1, 0), "one zero");
+    check_round_trip(std::vector<uint8_t>(300, 0), "all zeros");
+    std::vector<uint8_t> every_byte;
+    for (uint16_t i=0; i<512; i++) {
+        every_byte.push_back(static_cast<uint8_t>(i));
+    }
+    check_round_trip(every_byte, "every byte value");
+
+    //runs of non-zero bytes on either side of a full 254 byte block (the record header is the start of the run)
+    for (uint16_t run_length=(cobs_max_block_length - 3); run_length<=(cobs_max_block_length + 3); run_length++) {
+        const uint16_t payload_length = run_length - record_header_length;
+        std::vector<uint8_t> payload(payload_length, 0x5A);
+        check_round_trip(payload, "one run");
+
+        //then a zero, right after the block
+        payload.push_back(0);
+        payload.push_back(0x33);
+        check_round_trip(payload, "a run, then a zero");
+    }
+
+    //a run of exactly two full blocks, then the crc
+    check_round_trip(std::vector<uint8_t>((2 * cobs_max_block_length) - record_header_length, 0xA5), "two full blocks");
+
+    //switching modes: what was queued before is sent as json, then only frames
+    std::string output = switch_mode_with_queued(true, "queued before binary 1", "queued before binary 2");
+
+    //(the text is in a frame too, since COBS only changes the zeros)
+    const size_t json_end = output.find("{\"status\":\"queued before binary 2\"}\r\n");
+    check((json_end != std::string::npos) && (output.find("{\"status\":\"queued before binary 1\"}\r\n") < json_end), "queued messages are sent as json");
+    const size_t first_frame = output.find('\n', json_end) + 1;
+    std::string trailing;
+    const std::vector<std::string> frames = split_frames(output.substr(first_frame), trailing);
+    check(!frames.empty() && trailing.empty(), "then only frames");
+
+    bool has_reply = false;
+    for (size_t i=0; i<frames.size(); i++) {
+        std::vector<uint8_t> record;
+        check(decode_record(frames[i], record), "every frame after the switch decodes");
+        const std::string record_text(record.begin(), record.end());
+        has_reply |= (record_text.find("enable binary mode") != std::string::npos);
+    }
+    check(has_reply, "the reply is a frame");
+
+    //and back: what was queued in binary is sent as frames, then json
+    output = switch_mode_with_queued(false, "queued before json 1", "queued before json 2");
+
+    const std::vector<std::string> disable_frames = split_frames(output, trailing);
+    std::string disable_records;
+    for (size_t i=0; i<disable_frames.size(); i++) {
+        std::vector<uint8_t> record;
+        check(decode_record(disable_frames[i], record), "every frame before the switch decodes");
+        disable_records += std::string(record.begin(), record.end());
+    }
+    check(contains(disable_records, "queued before json 1") && contains(disable_records, "queued before json 2"), "queued messages are sent as frames");
+    check(contains(trailing, "disable binary mode") && (trailing[trailing.size() - 1] == '\n'), "then json");
+
+    return host_test_result("printf binary");
+}
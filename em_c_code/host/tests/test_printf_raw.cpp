@@ -0,0 +1,336 @@
+/*
+ * test_printf_raw.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// printf_raw against the formatters it replaced (printf_raw_reference.h): the same characters for every value checked,
+// and the printed digits read back to the value (integers and timestamps exactly, floats within the last printed place)
+// the floats keep the old rounding: each digit comes from multiplying by 10 and rounding back to the float's precision
+//
+// usage: test_printf_raw [float32_stride]
+//  every 16bit value, every exponent, and the stride through all 2^32 float32 patterns (1 checks every float32)
+
+#include "host_test.h"
+#include "printf_raw_versions.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+
+static const uint32_t default_float32_stride = 16381;
+static const uint32_t random_count = 1000000;
+
+static uint32_t mismatch_reports = 0;
+
+
+//the same random values every run
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t random_uint64() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static bool same_output(const std::string &current_output, const std::string &expected, const char *const what, const char *const value) {
+    if (current_output == expected) {return true;}
+
+    if (mismatch_reports < 20) {
+        fprintf(stderr, "%s %s: printed %s, expected %s\n", what, value, current_output.c_str(), expected.c_str());
+        mismatch_reports++;
+    }
+    return false;
+}
+
+
+//integers
+static std::string current_int(int64_t value) {
+    capture_clear();
+    current::print_all_int_except_uint64_value(value);
+    return capture_text();
+}
+
+static std::string reference_int(int64_t value) {
+    capture_clear();
+    reference::print_all_int_except_uint64_value(value);
+    return capture_text();
+}
+
+static std::string current_uint64(uint64_t value) {
+    capture_clear();
+    current::print_uint64_value(value);
+    return capture_text();
+}
+
+static std::string reference_uint64(uint64_t value) {
+    capture_clear();
+    reference::print_uint64_value(value);
+    return capture_text();
+}
+
+static void check_int(int64_t value) {
+    char value_string[32];
+    snprintf(value_string, sizeof(value_string), "%lld", static_cast<long long>(value));
+
+    const std::string output = current_int(value);
+    check(same_output(output, reference_int(value), "int", value_string), "int matches the old output");
+    check(strtoll(output.c_str(), NULL, 10) == value, "int reads back");
+}
+
+static void check_uint64(uint64_t value) {
+    char value_string[32];
+    snprintf(value_string, sizeof(value_string), "%llu", static_cast<unsigned long long>(value));
+
+    const std::string output = current_uint64(value);
+    check(same_output(output, reference_uint64(value), "uint64", value_string), "uint64 matches the old output");
+    check(strtoull(output.c_str(), NULL, 10) == value, "uint64 reads back");
+}
+
+static void test_integers() {
+    //every 16bit value, signed and unsigned
+    for (int64_t value=-65536; value<=65536; value++) {
+        check_int(value);
+        if (value >= 0) {check_uint64(static_cast<uint64_t>(value));}
+    }
+
+    //around every power of 2 and 10 (where the digit count and the division width change)
+    for (uint16_t bit=16; bit<64; bit++) {
+        for (int64_t offset=-2; offset<=2; offset++) {
+            const uint64_t value = (static_cast<uint64_t>(1) << bit) + static_cast<uint64_t>(offset);
+            check_uint64(value);
+            check_int(static_cast<int64_t>(value));
+            check_int(static_cast<int64_t>(0 - value));
+        }
+    }
+    uint64_t power = 10;
+    for (uint16_t digits=2; digits<=19; digits++) {
+        power *= 10;
+        for (int64_t offset=-2; offset<=2; offset++) {
+            const uint64_t value = power / 10 + static_cast<uint64_t>(offset);
+            check_uint64(value);
+            check_int(static_cast<int64_t>(value));
+            check_int(static_cast<int64_t>(0 - value));
+        }
+    }
+    check_uint64(0xFFFFFFFFFFFFFFFFULL);
+    check_uint64(0xFFFFFFFFFFFFFFFEULL);
+    check_int(LLONG_MAX);
+    check_int(LLONG_MIN);
+    check_int(LLONG_MIN + 1);
+
+    //random 32 and 64bit values
+    for (uint32_t i=0; i<random_count; i++) {
+        const uint64_t value = random_uint64();
+        check_uint64(value);
+        check_uint64(value >> 32);
+        check_int(static_cast<int64_t>(value));
+        check_int(static_cast<int32_t>(value >> 32));
+    }
+}
+
+
+//timestamps
+static void check_timestamp(uint64_t timestamp, uint64_t ts_multiplier, uint16_t ts_shift) {
+    capture_clear();
+    current::print_uint64_timestamp(timestamp, ts_multiplier, ts_shift);
+    const std::string output = capture_text();
+
+    capture_clear();
+    reference::print_uint64_timestamp(timestamp, ts_multiplier, ts_shift);
+    const std::string expected = capture_text();
+
+    char value_string[64];
+    snprintf(value_string, sizeof(value_string), "%llu*%llu>>%u", static_cast<unsigned long long>(timestamp),
+             static_cast<unsigned long long>(ts_multiplier), ts_shift);
+    check(same_output(output, expected, "timestamp", value_string), "timestamp matches the old output");
+
+    //without the period, the digits are the scaled value
+    std::string digits = output;
+    digits.erase(std::remove(digits.begin(), digits.end(), '.'), digits.end());
+    check(strtoull(digits.c_str(), NULL, 10) == (timestamp * ts_multiplier), "timestamp reads back");
+    check(output.find('.') == (output.size() - ts_shift - 1), "timestamp has ts_shift decimal places");
+}
+
+static void test_timestamps() {
+    const uint64_t multipliers[] = {1, 5, 10, 25, 100, 1000, 3125};
+    for (uint16_t multiplier_i=0; multiplier_i<(sizeof(multipliers) / sizeof(multipliers[0])); multiplier_i++) {
+        for (uint16_t ts_shift=0; ts_shift<=20; ts_shift++) {
+            for (uint64_t timestamp=0; timestamp<=1000; timestamp++) {
+                check_timestamp(timestamp, multipliers[multiplier_i], ts_shift);
+            }
+
+            uint64_t power = 10;
+            for (uint16_t digits=1; digits<=15; digits++) {
+                check_timestamp(power - 1, multipliers[multiplier_i], ts_shift);
+                check_timestamp(power, multipliers[multiplier_i], ts_shift);
+                power *= 10;
+            }
+
+            for (uint32_t i=0; i<1000; i++) {
+                check_timestamp(random_uint64() >> 24, multipliers[multiplier_i], ts_shift);
+            }
+        }
+    }
+}
+
+
+//floats
+static const uint16_t float_precisions[] = {0, 1, 3, 4, 7, 10, 15, 16};
+static const uint16_t float_precision_count = sizeof(float_precisions) / sizeof(float_precisions[0]);
+static const double two_to_64 = 18446744073709551616.0;
+
+//the printed digits read back to within one unit of the last printed place,
+//plus the rounding of each multiply by 10 (at most half an ulp each, like the old float loop)
+static bool reads_back(const std::string &output, double magnitude, uint16_t mantissa_bits) {
+    const size_t period = output.find('.');
+    const size_t fraction_digits = (period == std::string::npos) ? 0 : (output.size() - period - 1);
+
+    const long double printed = fabsl(strtold(output.c_str(), NULL));
+    const long double unit = powl(10.0L, -static_cast<long double>(fraction_digits));
+    const long double rounding = static_cast<long double>(fraction_digits) * ldexpl(static_cast<long double>(magnitude), 1 - mantissa_bits);
+    return fabsl(printed - static_cast<long double>(magnitude)) <= (unit + rounding);
+}
+
+//2^64 is the one value the old version could not convert (the cast was undefined), so it is only checked for inf
+static void check_float_output(const std::string &output, const std::string &old_output, double value, uint16_t mantissa_bits,
+                               const char *const what, const char *const value_string) {
+    const double magnitude = fabs(value);
+
+    if (magnitude >= two_to_64) {
+        check(same_output(output, (value < 0.0) ? "-inf" : "inf", what, value_string), "too large prints inf");
+        if (magnitude == two_to_64) {return;}
+    }
+
+    check(same_output(output, old_output, what, value_string), "float matches the old output");
+    check((magnitude >= two_to_64) || reads_back(output, magnitude, mantissa_bits), "float reads back");
+}
+
+static void check_float32(uint32_t bits) {
+    float32 value;
+    memcpy(&value, &bits, sizeof(value));
+    if (isnan(value) || isinf(value)) {return;}
+
+    for (uint16_t i=0; i<float_precision_count; i++) {
+        capture_clear();
+        current::print_float32_value(value, float_precisions[i]);
+        const std::string output = capture_text();
+
+        capture_clear();
+        reference::print_float32_value(value, float_precisions[i]);
+
+        char value_string[64];
+        snprintf(value_string, sizeof(value_string), "0x%08X (%.9g) precision %u", bits, value, float_precisions[i]);
+        check_float_output(output, capture_text(), value, 24, "float32", value_string);
+    }
+}
+
+static void check_float64(uint64_t bits) {
+    float64 value;
+    memcpy(&value, &bits, sizeof(value));
+    if (isnan(value) || isinf(value)) {return;}
+
+    for (uint16_t i=0; i<float_precision_count; i++) {
+        capture_clear();
+        current::print_float64_value(value, float_precisions[i]);
+        const std::string output = capture_text();
+
+        capture_clear();
+        reference::print_float64_value(value, float_precisions[i]);
+
+        char value_string[64];
+        snprintf(value_string, sizeof(value_string), "0x%016llX (%.17g) precision %u", static_cast<unsigned long long>(bits), value, float_precisions[i]);
+        check_float_output(output, capture_text(), value, 53, "float64", value_string);
+    }
+}
+
+static void test_floats(uint32_t float32_stride) {
+    //every exponent (both signs), with the smallest, largest, and some random mantissas
+    for (uint32_t exponent=0; exponent<256; exponent++) {
+        for (uint32_t sign=0; sign<2; sign++) {
+            const uint32_t base = (sign << 31) | (exponent << 23);
+            for (uint32_t mantissa=0; mantissa<64; mantissa++) {
+                check_float32(base | mantissa);
+                check_float32(base | (0x007FFFFF - mantissa));
+                check_float32(base | (static_cast<uint32_t>(random_uint64()) & 0x007FFFFF));
+            }
+        }
+    }
+    for (uint64_t exponent=0; exponent<2048; exponent++) {
+        for (uint64_t sign=0; sign<2; sign++) {
+            const uint64_t base = (sign << 63) | (exponent << 52);
+            for (uint64_t mantissa=0; mantissa<16; mantissa++) {
+                check_float64(base | mantissa);
+                check_float64(base | (0x000FFFFFFFFFFFFFULL - mantissa));
+                check_float64(base | (random_uint64() & 0x000FFFFFFFFFFFFFULL));
+            }
+        }
+    }
+
+    //values that are exact in decimal, and their neighbors
+    for (int32_t hundredths=-100000; hundredths<=100000; hundredths++) {
+        const float32 value32 = static_cast<float32>(hundredths) / 100.0f;
+        uint32_t bits32;
+        memcpy(&bits32, &value32, sizeof(bits32));
+        check_float32(bits32);
+        check_float32(bits32 + 1);
+        check_float32(bits32 - 1);
+
+        const float64 value64 = static_cast<float64>(hundredths) / 100.0;
+        uint64_t bits64;
+        memcpy(&bits64, &value64, sizeof(bits64));
+        check_float64(bits64);
+    }
+
+    //the sweep through every float32
+    for (uint64_t bits=0; bits<=0xFFFFFFFFULL; bits+=float32_stride) {
+        check_float32(static_cast<uint32_t>(bits));
+    }
+
+    //zero, inf, and nan
+    const uint16_t zero_precisions[] = {0, 1, 4, 16};
+    for (uint16_t i=0; i<4; i++) {
+        capture_clear();
+        current::print_float32_value(0.0f, zero_precisions[i]);
+        const std::string output = capture_text();
+        capture_clear();
+        reference::print_float32_value(0.0f, zero_precisions[i]);
+        check(same_output(output, capture_text(), "float32", "0"), "zero matches the old output");
+
+        capture_clear();
+        current::print_float64_value(-0.0, zero_precisions[i]);
+        const std::string output64 = capture_text();
+        capture_clear();
+        reference::print_float64_value(-0.0, zero_precisions[i]);
+        check(same_output(output64, capture_text(), "float64", "-0"), "negative zero matches the old output");
+    }
+
+    const float64 specials[] = {INFINITY, -INFINITY, NAN, 1e30, -1e30};
+    const char *const special_outputs[] = {"inf", "-inf", "nan", "inf", "-inf"};
+    for (uint16_t i=0; i<5; i++) {
+        capture_clear();
+        current::print_float64_value(specials[i], 4);
+        check(capture_text() == special_outputs[i], "float64 special value");
+
+        capture_clear();
+        current::print_float32_value(static_cast<float32>(specials[i]), 4);
+        check(capture_text() == special_outputs[i], "float32 special value");
+    }
+}
+
+
+int main(int argc, char **argv) {
+    uint32_t float32_stride = default_float32_stride;
+    if (argc > 1) {
+        float32_stride = static_cast<uint32_t>(strtoul(argv[1], NULL, 10));
+        if (float32_stride == 0) {
+            fprintf(stderr, "float32_stride must be > 0\n");
+            return 1;
+        }
+    }
+
+    test_integers();
+    test_timestamps();
+    test_floats(float32_stride);
+
+    return host_test_result("printf_raw");
+}
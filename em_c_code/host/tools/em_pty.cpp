@@ -0,0 +1,93 @@
+/*
+ * em_pty.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+// runs the simulated device in realtime behind a pseudo-terminal, at 921600 baud (8N1)
+// any serial client can open the printed path (or the link) in place of the FTDI port
+//  matlab: test_possible_serial_connection with the path, since serial port lists skip ptys
+//
+// usage: em_pty [--link <path>] [--flash <path>] [--seconds <n>]
+//  --link      also make a symlink to the pty (removed on exit)
+//  --flash     keep the flash sector in this file (so a saved profile is loaded the next time)
+//  --seconds   stop after this long (otherwise, until ctrl-c)
+
+#include "host_sim.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+
+static void stop_device(int signal_number) {
+    (void)signal_number;
+    sim_stop();
+}
+
+
+int main(int argc, char **argv) {
+    std::string link_path;
+    std::string flash_path;
+    unsigned int seconds = 0;
+
+    for (int i=1; i<argc; i++) {
+        if ((strcmp(argv[i], "--link") == 0) && ((i + 1) < argc)) {
+            link_path = argv[++i];
+        } else if ((strcmp(argv[i], "--flash") == 0) && ((i + 1) < argc)) {
+            flash_path = argv[++i];
+        } else if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = static_cast<unsigned int>(strtoul(argv[++i], NULL, 10));
+        } else {
+            fprintf(stderr, "usage: em_pty [--link <path>] [--flash <path>] [--seconds <n>]\n");
+            return 1;
+        }
+    }
+
+    if (!sim_flash_set_file(flash_path)) {
+        fprintf(stderr, "could not read the flash file\n");
+        return 1;
+    }
+
+    std::string pty_path;
+    if (!sim_pty_open(pty_path)) {
+        perror("could not open a pty");
+        return 1;
+    }
+
+    if (!link_path.empty()) {
+        unlink(link_path.c_str());
+        if (symlink(pty_path.c_str(), link_path.c_str()) != 0) {
+            perror("could not link the pty");
+            sim_pty_close();
+            return 1;
+        }
+    }
+
+    printf("%s\n", link_path.empty() ? pty_path.c_str() : link_path.c_str());
+    fflush(stdout);
+
+    signal(SIGINT, stop_device);
+    signal(SIGTERM, stop_device);
+    if (seconds > 0) {
+        signal(SIGALRM, stop_device);
+        alarm(seconds);
+    }
+
+    //the boot messages go out on the pty too (a client clears them when it connects, like with the device)
+    sim_boot();
+    sim_run_realtime();
+
+    sim_pty_close();
+    if (!link_path.empty()) {
+        unlink(link_path.c_str());
+    }
+
+    const sim_pty_stats_t stats = sim_pty_stats();
+    fprintf(stderr, "rx %llu bytes, tx %llu bytes (%llu dropped)\n",
+            static_cast<unsigned long long>(stats.rx_bytes),
+            static_cast<unsigned long long>(stats.tx_bytes),
+            static_cast<unsigned long long>(stats.tx_dropped_bytes));
+    return 0;
+}
@@ -81,6 +81,10 @@ while obj.received_struct_buffer.used > 0
         %check if there is a history field, and convert it
         if isfield(received_struct.(first_field_name), 'history')
             received_struct.(first_field_name).history = extract_new32_array(received_struct.(first_field_name).history, true);
+            %analog histories are delta varint strings when requested with "delta_varint"
+            if ischar(received_struct.(first_field_name).history)
+                received_struct.(first_field_name).history = decode_delta_varint(received_struct.(first_field_name).history, true);
+            end
         end
 
         %copy the buffer to the receive ringbuffer
@@ -0,0 +1,68 @@
+function [number_array] = decode_delta_varint(char_array, suppress_error)
+%decodes a delta varint string (base64) into a double array (of 16-bit integers)
+%header is the format (8 bits, 0 for delta varint) and count (16 bits)
+%then the first value (16 bits), and every other value as a zig-zag varint of the delta
+%varints are 7 bits per byte (lowest first), with the high bit set when more bytes follow
+
+if nargin < 2
+    suppress_error = false;
+end
+
+%for failure, array is just the input
+number_array = char_array;
+
+if ~(isa(char_array, 'char') || isa(char_array, 'string'))
+    return;
+end
+
+bytes = double(matlab.net.base64decode(char(char_array)));
+
+%if it isn't a delta varint, exit
+if (length(bytes) < 5) || (bytes(1) ~= 0)
+    if ~suppress_error
+        fprintf('not a delta varint array\n');
+    end
+    return;
+end
+
+count = bytes(2)*256 + bytes(3);
+values = zeros(count, 1);
+values(1) = bytes(4)*256 + bytes(5);
+byte_i = 6;
+
+for i = 2:count
+    zigzag = 0;
+    shift = 1;
+
+    %read each byte of the varint
+    while true
+        if byte_i > length(bytes)
+            if ~suppress_error
+                fprintf('delta varint array is too short\n');
+            end
+            return;
+        end
+
+        byte = bytes(byte_i);
+        byte_i = byte_i + 1;
+        zigzag = zigzag + mod(byte, 128)*shift;
+        shift = shift*128;
+
+        if byte < 128
+            break;
+        end
+    end
+
+    %undo the zig-zag
+    if mod(zigzag, 2) == 0
+        delta = zigzag/2;
+    else
+        delta = -(zigzag + 1)/2;
+    end
+
+    values(i) = values(i-1) + delta;
+end
+
+number_array = values;
+
+end